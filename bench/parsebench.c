@@ -0,0 +1,127 @@
+/****************************************************/
+/* File: parsebench.c                               */
+/* Parse throughput of the bison parser (parser.c)  */
+/* against the recursive-descent one (rdparse.c)    */
+/****************************************************/
+
+/* usage: parsebench <file.cm> [repeats]
+ *
+ * Scans and parses the file repeats times with each
+ * parser, tracing off and the listing sent to
+ * /dev/null, and prints the best time of each.
+ */
+
+#include "globals.h"
+#include "parse.h"
+#include "rdparse.h"
+#include "scan.h"
+#include <time.h>
+
+/* globals normally allocated by main.c */
+_Thread_local int lineno = 0;
+FILE *source;
+FILE *listing;
+FILE *code;
+_Thread_local FILE *redundant_source;
+int EchoSource = FALSE;
+int TraceScan = FALSE;
+int TraceParse = FALSE;
+int TraceAnalyze = FALSE;
+int TraceCode = FALSE;
+int Error = FALSE;
+_Thread_local int FirstLine = TRUE;
+int KeepUnusedFunctions = FALSE;
+char *PeepholeRules = NULL;
+int DumpIr = FALSE;
+char *IrPasses = NULL;
+int UnrollFactor = 4;
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static long countNodes(TreeNode *t) {
+  long n = 0;
+  int i;
+  for (; t != NULL; t = t->sibling) {
+    n++;
+    for (i = 0; i < MAXCHILDREN; i++)
+      n += countNodes(t->child[i]);
+  }
+  return n;
+}
+
+/* timeParser returns the best of repeats runs */
+static double timeParser(const char *name, const char *text, int len,
+                         int repeats, int useRD) {
+  double best = 1e30, start, elapsed;
+  long nodes = 0;
+  int r, failed;
+  TreeNode *t;
+  for (r = 0; r < repeats; r++) {
+    arenaReset(&compileArena);
+    start = now();
+    if (useRD) {
+      scanText(text, len, 1, TRUE);
+      t = parseRD();
+      failed = Error;
+      scanTextDone();
+    } else
+      t = parseText(text, len, 1, TRUE, &failed);
+    elapsed = now() - start;
+    if (failed) {
+      fprintf(stderr, "%s: syntax error\n", name);
+      exit(1);
+    }
+    nodes = countNodes(t);
+    if (elapsed < best)
+      best = elapsed;
+  }
+  fprintf(stderr, "%-8s %9.2f ms %8.1f MB/s %10ld nodes\n", name, best * 1e3,
+          len / best / 1e6, nodes);
+  return best;
+}
+
+int main(int argc, char *argv[]) {
+  FILE *f;
+  char *text;
+  long len;
+  int repeats = argc > 2 ? atoi(argv[2]) : 5;
+  double bison, rd;
+
+  if (argc < 2 || repeats < 1) {
+    fprintf(stderr, "usage: %s <file.cm> [repeats]\n", argv[0]);
+    return 1;
+  }
+  f = fopen(argv[1], "rb");
+  if (f == NULL) {
+    fprintf(stderr, "File %s not found\n", argv[1]);
+    return 1;
+  }
+  fseek(f, 0, SEEK_END);
+  len = ftell(f);
+  rewind(f);
+  text = (char *)malloc(len + 1);
+  if (text == NULL || fread(text, 1, len, f) != (size_t)len) {
+    fprintf(stderr, "Unable to read %s\n", argv[1]);
+    return 1;
+  }
+  fclose(f);
+
+  /* the source echo still goes through pc(): drop it */
+  listing = freopen("/dev/null", "w", stdout);
+  arenaInit(&compileArena, ARENA_BLOCK_SIZE);
+  arenaInit(&scratchArena, ARENA_BLOCK_SIZE);
+
+  fprintf(stderr, "%s: %ld bytes, best of %d\n", argv[1], len, repeats);
+  bison = timeParser("bison", text, (int)len, repeats, FALSE);
+  rd = timeParser("rdparse", text, (int)len, repeats, TRUE);
+  fprintf(stderr, "rdparse/bison speedup: %.2fx\n", bison / rd);
+
+  arenaFree(&compileArena);
+  arenaFree(&scratchArena);
+  free(text);
+  return 0;
+}
@@ -0,0 +1,156 @@
+/****************************************************/
+/* File: symtabbench.c                              */
+/* Insert and lookup cost of the symbol table       */
+/* (symtab.c) against the fixed 211-bucket chained  */
+/* table it replaced                                */
+/****************************************************/
+
+/* usage: symtabbench [functions] [locals] [repeats]
+ *
+ * Declares locals variables in each of functions
+ * scopes (names are shared between scopes, as i, j
+ * and n are in real programs), looks every one of them
+ * up repeats times, and prints the time per operation
+ * of both tables and the probe-length histogram.
+ */
+
+#include "arena.h"
+#include "symtab.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* the chained table symtab.c used before, reduced
+ * to what is measured here
+ */
+#define SIZE 211
+#define SHIFT 4
+
+typedef struct ChainRec {
+  char *name;
+  char *scope;
+  int memloc;
+  struct ChainRec *next;
+} *Chain;
+
+static Chain chains[SIZE];
+
+static int chainHash(char *key) {
+  int temp = 0;
+  int i = 0;
+  while (key[i] != '\0') {
+    temp = ((temp << SHIFT) + key[i]) % SIZE;
+    ++i;
+  }
+  return temp;
+}
+
+static Chain chainFind(char *name, char *scope) {
+  Chain l = chains[chainHash(name)];
+  while ((l != NULL) &&
+         !((strcmp(name, l->name) == 0) && (strcmp(scope, l->scope) == 0)))
+    l = l->next;
+  return l;
+}
+
+static void chainInsert(char *name, char *scope, int memloc) {
+  int h = chainHash(name);
+  Chain l = chainFind(name, scope);
+  if (l == NULL) {
+    l = (Chain)arenaAlloc(&compileArena, sizeof(struct ChainRec));
+    l->name = name;
+    l->scope = arenaStrdup(&compileArena, scope);
+    l->memloc = memloc;
+    l->next = chains[h];
+    chains[h] = l;
+  }
+}
+
+static int chainLookup(char *name, char *scope) {
+  Chain l = chainFind(name, scope);
+  return l == NULL ? -1 : l->memloc;
+}
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int numFuns, numLocals, repeats;
+static char **funNames, **localNames;
+static ScopeId *funScopes;
+static volatile long sink;
+
+/* run performs the workload on one of the tables and
+ * prints the ns per insert and per lookup
+ */
+static void run(const char *label, int chained) {
+  double start, insertTime, lookupTime;
+  long hits = 0, ops = (long)numFuns * numLocals;
+  int f, v, r;
+
+  start = now();
+  for (f = 0; f < numFuns; f++) {
+    if (chained)
+      chainInsert(funNames[f], "", f);
+    else {
+      st_insert(funNames[f], 1, "fun", "int", GLOBAL_SCOPE, f);
+      funScopes[f] = st_scope(GLOBAL_SCOPE, funNames[f]);
+    }
+    for (v = 0; v < numLocals; v++) {
+      if (chained)
+        chainInsert(localNames[v], funNames[f], v);
+      else
+        st_insert(localNames[v], 1, "var", "int", funScopes[f], v);
+    }
+  }
+  insertTime = now() - start;
+
+  start = now();
+  for (r = 0; r < repeats; r++)
+    for (f = 0; f < numFuns; f++)
+      for (v = 0; v < numLocals; v++)
+        hits += (chained ? chainLookup(localNames[v], funNames[f])
+                         : st_lookup(localNames[v], funScopes[f])) != -1;
+  lookupTime = now() - start;
+  sink = hits;
+
+  printf("%-8s insert %8.1f ns   lookup %8.1f ns   (%ld records)\n", label,
+         insertTime * 1e9 / (ops + numFuns),
+         lookupTime * 1e9 / (ops * repeats), ops + numFuns);
+}
+
+int main(int argc, char *argv[]) {
+  char buf[32];
+  int i;
+  numFuns = argc > 1 ? atoi(argv[1]) : 2000;
+  numLocals = argc > 2 ? atoi(argv[2]) : 20;
+  repeats = argc > 3 ? atoi(argv[3]) : 5;
+  if (numFuns < 1 || numLocals < 1 || repeats < 1) {
+    fprintf(stderr, "usage: %s [functions] [locals] [repeats]\n", argv[0]);
+    return 1;
+  }
+
+  arenaInit(&compileArena, ARENA_BLOCK_SIZE);
+  arenaInit(&scratchArena, ARENA_BLOCK_SIZE);
+  funNames = (char **)arenaAlloc(&compileArena, numFuns * sizeof(char *));
+  localNames = (char **)arenaAlloc(&compileArena, numLocals * sizeof(char *));
+  funScopes = (ScopeId *)arenaAlloc(&compileArena, numFuns * sizeof(ScopeId));
+  for (i = 0; i < numFuns; i++) {
+    snprintf(buf, sizeof buf, "fun%d", i);
+    funNames[i] = arenaStrdup(&compileArena, buf);
+  }
+  for (i = 0; i < numLocals; i++) {
+    snprintf(buf, sizeof buf, "v%d", i);
+    localNames[i] = arenaStrdup(&compileArena, buf);
+  }
+
+  run("chained", 1);
+  run("open", 0);
+  st_dump_stats(stdout);
+
+  arenaFree(&scratchArena);
+  arenaFree(&compileArena);
+  return 0;
+}
@@ -0,0 +1,54 @@
+* TINY Compilation to TM Code
+* Standard prelude:
+  0:     LD  6,0(0) 	load maxaddress from location 0
+  1:     ST  0,0(0) 	clear location 0
+  2:    LDA  3,0(6) 	pointing sp to the top of the memory
+  3:    LDC  5,0(0) 	init GP to 0
+* End of standard prelude.
+* -> FunDeclK
+  4:    LDA  2,0(3) 	Prologue: FP pointing to current frame function
+  5:    LDA  3,-10(3) 	Prologue: Allocating memory for local variables
+  6:     IN  0,0,0 	input
+  7:     ST  0,-4(2) 	assign: store to array
+  8:    OUT  0,0,0 	output
+  9:     LD  1,-4(2) 	ac = mem[ac]
+ 10:    OUT  1,0,0 	output
+ 11:    LDA  0,3(0) 	op +
+ 12:     ST  0,1(5) 	assign: store to array
+ 13:    LDC  1,2(0) 	load const
+ 14:    MUL  0,0,1 	op *
+ 15:    OUT  0,0,0 	output
+ 16:     LD  0,1(5) 	ac = mem[ac]
+ 17:    OUT  0,0,0 	output
+ 18:    LDC  0,0(0) 	op *
+ 19:     ST  0,0(5) 	assign: store to array
+ 20:     ST  0,-2(2) 	assign: store to array
+ 21:    LDC  0,1(0) 	op *
+ 22:     ST  0,1(5) 	assign: store to array
+ 23:     ST  0,-3(2) 	assign: store to array
+ 24:    LDC  0,4(0) 	op *
+ 25:     ST  0,2(5) 	assign: store to array
+ 26:     ST  0,-4(2) 	assign: store to array
+ 27:    LDC  0,9(0) 	op *
+ 28:     ST  0,3(5) 	assign: store to array
+ 29:     ST  0,-5(2) 	assign: store to array
+ 30:    LDC  0,16(0) 	op *
+ 31:     ST  0,4(5) 	assign: store to array
+ 32:     ST  0,-6(2) 	assign: store to array
+ 33:    LDC  0,16(0) 	load local id value
+ 34:    OUT  0,0,0 	output
+ 35:     LD  0,-5(2) 	ac = mem[ac]
+ 36:     LD  1,4(5) 	ac = mem[ac]
+ 37:    ADD  0,0,1 	op +
+ 38:    OUT  0,0,0 	output
+ 39:    LDC  0,5(0) 	op -
+ 40:     ST  0,2(5) 	assign: store to array
+ 41:     ST  0,-2(2) 	assign: store to array
+ 42:    OUT  0,0,0 	output
+ 43:     LD  0,-2(2) 	ac = mem[ac]
+ 44:     LD  1,2(5) 	ac = mem[ac]
+ 45:    ADD  0,0,1 	op +
+ 46:    OUT  0,0,0 	output
+* <- FunDeclK
+* End of execution.
+ 47:   HALT  0,0,0 	
@@ -0,0 +1,214 @@
+* TINY Compilation to TM Code
+* Standard prelude:
+  0:     LD  6,0(0) 	load maxaddress from location 0
+  1:     ST  0,0(0) 	clear location 0
+  2:    LDA  3,0(6) 	pointing sp to the top of the memory
+  3:    LDC  5,0(0) 	init GP to 0
+* End of standard prelude.
+* -> FunDeclK
+  4:    LDA  7,18(7) 	Unconditional relative jmp to main
+  5:    LDA  3,-4(2) 	Prologue: Allocating memory for local variables
+  6:     LD  0,-2(2) 	ssa: value on entry
+  7:     LD  1,-3(2) 	ssa: value on entry
+  8:    LDC  4,10(0) 	load const
+  9:    MUL  0,0,4 	op *
+ 10:    ADD  0,0,1 	op +
+ 11:    LDA  3,0(2) 	Epilogue: sp back to the caller's
+ 12:     LD  1,-1(2) 	Epilogue: load return address
+ 13:     LD  2,0(2) 	Epilogue: restore fp
+ 14:    LDA  7,0(1) 	Epilogue: return
+* <- FunDeclK
+* -> FunDeclK
+ 15:    LDA  3,-4(2) 	Prologue: Allocating memory for local variables
+ 16:     LD  0,-2(2) 	ssa: value on entry
+ 17:    LDA  0,1(0) 	op +
+ 18:    MUL  0,0,0 	op *
+ 19:    LDA  3,0(2) 	Epilogue: sp back to the caller's
+ 20:     LD  1,-1(2) 	Epilogue: load return address
+ 21:     LD  2,0(2) 	Epilogue: restore fp
+ 22:    LDA  7,0(1) 	Epilogue: return
+* <- FunDeclK
+* -> FunDeclK
+ 23:    LDA  2,0(3) 	Prologue: FP pointing to current frame function
+ 24:    LDA  3,-22(3) 	Prologue: Allocating memory for local variables
+ 25:     IN  0,0,0 	input
+ 26:     ST  0,-7(2) 	spill: store
+ 27:     IN  0,0,0 	input
+ 28:     ST  0,-8(2) 	spill: store
+ 29:     IN  0,0,0 	input
+ 30:     ST  0,-9(2) 	spill: store
+ 31:     IN  0,0,0 	input
+ 32:     ST  0,-10(2) 	spill: store
+ 33:     LD  0,-8(2) 	spill: reload
+ 34:     LD  1,-9(2) 	spill: reload
+ 35:    MUL  0,0,1 	op *
+ 36:     LD  1,-7(2) 	spill: reload
+ 37:    ADD  0,1,0 	op +
+ 38:     ST  0,-11(2) 	spill: store
+ 39:     LD  0,-9(2) 	spill: reload
+ 40:     ST  0,-2(3) 	Storing current argument on stack
+ 41:     LD  0,-10(2) 	spill: reload
+ 42:     ST  0,-3(3) 	Storing current argument on stack
+ 43:     ST  2,0(3) 	call: store fp
+ 44:    LDA  2,0(3) 	call: fp points to the new frame
+ 45:    LDC  0,48(0) 	call: return address
+ 46:     ST  0,-1(2) 	call: store return address
+ 47:    LDA  7,-43(7) 	jump to function
+ 48:     LD  1,-11(2) 	spill: reload
+ 49:    ADD  0,1,0 	op +
+ 50:     ST  0,-12(2) 	spill: store
+ 51:     LD  0,-7(2) 	spill: reload
+ 52:     LD  1,-8(2) 	spill: reload
+ 53:    ADD  0,0,1 	op +
+ 54:     ST  0,-13(2) 	spill: store
+ 55:     ST  0,-2(3) 	Storing current argument on stack
+ 56:     ST  2,0(3) 	call: store fp
+ 57:    LDA  2,0(3) 	call: fp points to the new frame
+ 58:    LDC  0,61(0) 	call: return address
+ 59:     ST  0,-1(2) 	call: store return address
+ 60:    LDA  7,-46(7) 	jump to function
+ 61:     LD  1,-10(2) 	spill: reload
+ 62:    MUL  0,1,0 	op *
+ 63:     LD  1,-12(2) 	spill: reload
+ 64:    ADD  0,1,0 	op +
+ 65:     ST  0,-14(2) 	spill: store
+ 66:     LD  0,-8(2) 	spill: reload
+ 67:     ST  0,-2(3) 	Storing current argument on stack
+ 68:     ST  2,0(3) 	call: store fp
+ 69:    LDA  2,0(3) 	call: fp points to the new frame
+ 70:    LDC  0,73(0) 	call: return address
+ 71:     ST  0,-1(2) 	call: store return address
+ 72:    LDA  7,-58(7) 	jump to function
+ 73:     ST  0,-2(3) 	Storing current argument on stack
+ 74:     LD  0,-9(2) 	spill: reload
+ 75:     ST  0,-3(3) 	Storing current argument on stack
+ 76:     ST  2,0(3) 	call: store fp
+ 77:    LDA  2,0(3) 	call: fp points to the new frame
+ 78:    LDC  0,81(0) 	call: return address
+ 79:     ST  0,-1(2) 	call: store return address
+ 80:    LDA  7,-76(7) 	jump to function
+ 81:     LD  1,-14(2) 	spill: reload
+ 82:    SUB  0,1,0 	op -
+ 83:     LD  1,-7(2) 	spill: reload
+ 84:     LD  4,-8(2) 	spill: reload
+ 85:    MUL  1,1,4 	op *
+ 86:     LD  4,-9(2) 	spill: reload
+ 87:    MUL  1,1,4 	op *
+ 88:     LD  4,-10(2) 	spill: reload
+ 89:    MUL  1,1,4 	op *
+ 90:    ADD  0,0,1 	op +
+ 91:     ST  0,-15(2) 	spill: store
+ 92:    OUT  0,0,0 	output
+ 93:     LD  0,-7(2) 	spill: reload
+ 94:    OUT  0,0,0 	output
+ 95:     LD  0,-8(2) 	spill: reload
+ 96:    OUT  0,0,0 	output
+ 97:     LD  0,-9(2) 	spill: reload
+ 98:    OUT  0,0,0 	output
+ 99:     LD  0,-10(2) 	spill: reload
+100:    OUT  0,0,0 	output
+101:     LD  0,-7(2) 	spill: reload
+102:     ST  0,-2(3) 	Storing current argument on stack
+103:     LD  0,-8(2) 	spill: reload
+104:     ST  0,-3(3) 	Storing current argument on stack
+105:     ST  2,0(3) 	call: store fp
+106:    LDA  2,0(3) 	call: fp points to the new frame
+107:    LDC  0,110(0) 	call: return address
+108:     ST  0,-1(2) 	call: store return address
+109:    LDA  7,-105(7) 	jump to function
+110:     ST  0,-16(2) 	spill: store
+111:     LD  0,-7(2) 	spill: reload
+112:     ST  0,-2(3) 	Storing current argument on stack
+113:     LD  0,-8(2) 	spill: reload
+114:     ST  0,-3(3) 	Storing current argument on stack
+115:     ST  2,0(3) 	call: store fp
+116:    LDA  2,0(3) 	call: fp points to the new frame
+117:    LDC  0,120(0) 	call: return address
+118:     ST  0,-1(2) 	call: store return address
+119:    LDA  7,-115(7) 	jump to function
+120:     ST  0,-17(2) 	spill: store
+121:     LD  0,-9(2) 	spill: reload
+122:     ST  0,-2(3) 	Storing current argument on stack
+123:     ST  2,0(3) 	call: store fp
+124:    LDA  2,0(3) 	call: fp points to the new frame
+125:    LDC  0,128(0) 	call: return address
+126:     ST  0,-1(2) 	call: store return address
+127:    LDA  7,-113(7) 	jump to function
+128:     LD  1,-17(2) 	spill: reload
+129:     ST  1,-2(3) 	Storing current argument on stack
+130:     ST  0,-3(3) 	Storing current argument on stack
+131:     ST  2,0(3) 	call: store fp
+132:    LDA  2,0(3) 	call: fp points to the new frame
+133:    LDC  0,136(0) 	call: return address
+134:     ST  0,-1(2) 	call: store return address
+135:    LDA  7,-131(7) 	jump to function
+136:     LD  1,-16(2) 	spill: reload
+137:    ADD  0,1,0 	op +
+138:     ST  0,-18(2) 	spill: store
+139:     LD  0,-10(2) 	spill: reload
+140:     ST  0,-2(3) 	Storing current argument on stack
+141:     ST  2,0(3) 	call: store fp
+142:    LDA  2,0(3) 	call: fp points to the new frame
+143:    LDC  0,146(0) 	call: return address
+144:     ST  0,-1(2) 	call: store return address
+145:    LDA  7,-131(7) 	jump to function
+146:     ST  0,-19(2) 	spill: store
+147:     LD  0,-10(2) 	spill: reload
+148:     ST  0,-2(3) 	Storing current argument on stack
+149:     LD  0,-7(2) 	spill: reload
+150:     ST  0,-3(3) 	Storing current argument on stack
+151:     ST  2,0(3) 	call: store fp
+152:    LDA  2,0(3) 	call: fp points to the new frame
+153:    LDC  0,156(0) 	call: return address
+154:     ST  0,-1(2) 	call: store return address
+155:    LDA  7,-151(7) 	jump to function
+156:     LD  1,-19(2) 	spill: reload
+157:    MUL  0,1,0 	op *
+158:     LD  1,-18(2) 	spill: reload
+159:    SUB  0,1,0 	op -
+160:    OUT  0,0,0 	output
+161:     LD  0,-9(2) 	spill: reload
+162:     LD  1,-10(2) 	spill: reload
+163:    ADD  0,0,1 	op +
+164:     LD  1,-13(2) 	spill: reload
+165:    MUL  0,1,0 	op *
+166:     ST  0,-20(2) 	spill: store
+167:     LD  0,-8(2) 	spill: reload
+168:     ST  0,-2(3) 	Storing current argument on stack
+169:     LD  0,-9(2) 	spill: reload
+170:     ST  0,-3(3) 	Storing current argument on stack
+171:     ST  2,0(3) 	call: store fp
+172:    LDA  2,0(3) 	call: fp points to the new frame
+173:    LDC  0,176(0) 	call: return address
+174:     ST  0,-1(2) 	call: store return address
+175:    LDA  7,-171(7) 	jump to function
+176:     LD  1,-7(2) 	spill: reload
+177:    ADD  0,1,0 	op +
+178:     ST  0,-21(2) 	spill: store
+179:     LD  0,-7(2) 	spill: reload
+180:     ST  0,-2(3) 	Storing current argument on stack
+181:     ST  2,0(3) 	call: store fp
+182:    LDA  2,0(3) 	call: fp points to the new frame
+183:    LDC  0,186(0) 	call: return address
+184:     ST  0,-1(2) 	call: store return address
+185:    LDA  7,-171(7) 	jump to function
+186:     LD  1,-10(2) 	spill: reload
+187:    ADD  0,1,0 	op +
+188:     LD  1,-21(2) 	spill: reload
+189:    MUL  0,1,0 	op *
+190:     LD  1,-20(2) 	spill: reload
+191:    SUB  0,1,0 	op -
+192:    OUT  0,0,0 	output
+193:     LD  0,-15(2) 	spill: reload
+194:     LD  1,-7(2) 	spill: reload
+195:    ADD  0,0,1 	op +
+196:     LD  1,-8(2) 	spill: reload
+197:    ADD  0,0,1 	op +
+198:     LD  1,-9(2) 	spill: reload
+199:    ADD  0,0,1 	op +
+200:     LD  1,-10(2) 	spill: reload
+201:    ADD  0,0,1 	op +
+202:    OUT  0,0,0 	output
+* <- FunDeclK
+* End of execution.
+203:   HALT  0,0,0 	
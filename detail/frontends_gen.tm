@@ -0,0 +1,338 @@
+* TINY Compilation to TM Code
+* Standard prelude:
+  0:     LD  6,0(0) 	load maxaddress from location 0
+  1:     ST  0,0(0) 	clear location 0
+  2:    LDA  3,0(6) 	pointing sp to the top of the memory
+  3:    LDC  5,0(0) 	init GP to 0
+* End of standard prelude.
+* -> FunDeclK
+  4:    LDA  7,236(7) 	Unconditional relative jmp to main
+  5:    LDA  3,-3(2) 	Prologue: Allocating memory for local variables
+  6:     LD  0,-2(2) 	ssa: value on entry
+  7:    LDC  1,2(0) 	load const
+  8:    MUL  0,0,1 	op *
+  9:    LDA  3,0(2) 	Epilogue: sp back to the caller's
+ 10:     LD  1,-1(2) 	Epilogue: load return address
+ 11:     LD  2,0(2) 	Epilogue: restore fp
+ 12:    LDA  7,0(1) 	Epilogue: return
+* <- FunDeclK
+* -> FunDeclK
+ 13:    LDA  3,-9(2) 	Prologue: Allocating memory for local variables
+ 14:    LDC  0,0(0) 	load const
+ 15:     ST  0,-8(2) 	spill: store
+ 16:     LD  0,-3(2) 	ssa: value on entry
+ 17:    LDA  0,-3(0) 	unroll: room for the copies
+ 18:    JLE  0,58(7) 	while: exit
+* while: body
+ 19:     LD  0,-8(2) 	spill: reload
+ 20:     ST  0,-2(3) 	Storing current argument on stack
+ 21:     ST  2,0(3) 	call: store fp
+ 22:    LDA  2,0(3) 	call: fp points to the new frame
+ 23:    LDC  0,26(0) 	call: return address
+ 24:     ST  0,-1(2) 	call: store return address
+ 25:    LDA  7,-21(7) 	jump to function
+ 26:     LD  1,-2(2) 	ssa: value on entry
+ 27:     LD  4,-8(2) 	spill: reload
+ 28:    ADD  1,1,4 	ac = (base_addr + index)
+ 29:     ST  0,0(1) 	assign: store to array
+ 30:     LD  0,-8(2) 	spill: reload
+ 31:    LDA  0,1(0) 	op +
+ 32:     ST  0,-5(2) 	spill: store
+ 33:     ST  0,-2(3) 	Storing current argument on stack
+ 34:     ST  2,0(3) 	call: store fp
+ 35:    LDA  2,0(3) 	call: fp points to the new frame
+ 36:    LDC  0,39(0) 	call: return address
+ 37:     ST  0,-1(2) 	call: store return address
+ 38:    LDA  7,-34(7) 	jump to function
+ 39:     LD  1,-2(2) 	ssa: value on entry
+ 40:     LD  4,-5(2) 	spill: reload
+ 41:    ADD  1,1,4 	ac = (base_addr + index)
+ 42:     ST  0,0(1) 	assign: store to array
+ 43:     LD  0,-8(2) 	spill: reload
+ 44:    LDA  0,2(0) 	op +
+ 45:     ST  0,-6(2) 	spill: store
+ 46:     ST  0,-2(3) 	Storing current argument on stack
+ 47:     ST  2,0(3) 	call: store fp
+ 48:    LDA  2,0(3) 	call: fp points to the new frame
+ 49:    LDC  0,52(0) 	call: return address
+ 50:     ST  0,-1(2) 	call: store return address
+ 51:    LDA  7,-47(7) 	jump to function
+ 52:     LD  1,-2(2) 	ssa: value on entry
+ 53:     LD  4,-6(2) 	spill: reload
+ 54:    ADD  1,1,4 	ac = (base_addr + index)
+ 55:     ST  0,0(1) 	assign: store to array
+ 56:     LD  0,-8(2) 	spill: reload
+ 57:    LDA  0,3(0) 	op +
+ 58:     ST  0,-7(2) 	spill: store
+ 59:     ST  0,-2(3) 	Storing current argument on stack
+ 60:     ST  2,0(3) 	call: store fp
+ 61:    LDA  2,0(3) 	call: fp points to the new frame
+ 62:    LDC  0,65(0) 	call: return address
+ 63:     ST  0,-1(2) 	call: store return address
+ 64:    LDA  7,-60(7) 	jump to function
+ 65:     LD  1,-2(2) 	ssa: value on entry
+ 66:     LD  4,-7(2) 	spill: reload
+ 67:    ADD  1,1,4 	ac = (base_addr + index)
+ 68:     ST  0,0(1) 	assign: store to array
+ 69:     LD  0,-8(2) 	spill: reload
+ 70:    LDA  0,4(0) 	op +
+ 71:     ST  0,-8(2) 	spill: store
+ 72:     LD  0,-3(2) 	ssa: value on entry
+ 73:     LD  1,-8(2) 	spill: reload
+ 74:    SUB  0,0,1 	compare: right - left
+ 75:    LDA  0,-3(0) 	unroll: room for the copies
+ 76:    JGT  0,-58(7) 	while: jump begin
+* while: rest
+ 77:     LD  0,-3(2) 	ssa: value on entry
+ 78:     LD  1,-8(2) 	spill: reload
+ 79:    SUB  0,0,1 	compare: right - left
+ 80:    JLE  0,18(7) 	while: exit
+* while: body
+ 81:     LD  0,-8(2) 	spill: reload
+ 82:     ST  0,-2(3) 	Storing current argument on stack
+ 83:     ST  2,0(3) 	call: store fp
+ 84:    LDA  2,0(3) 	call: fp points to the new frame
+ 85:    LDC  0,88(0) 	call: return address
+ 86:     ST  0,-1(2) 	call: store return address
+ 87:    LDA  7,-83(7) 	jump to function
+ 88:     LD  1,-2(2) 	ssa: value on entry
+ 89:     LD  4,-8(2) 	spill: reload
+ 90:    ADD  1,1,4 	ac = (base_addr + index)
+ 91:     ST  0,0(1) 	assign: store to array
+ 92:     LD  0,-8(2) 	spill: reload
+ 93:    LDA  0,1(0) 	op +
+ 94:     ST  0,-8(2) 	spill: store
+ 95:     LD  0,-3(2) 	ssa: value on entry
+ 96:     LD  1,-8(2) 	spill: reload
+ 97:    SUB  0,0,1 	compare: right - left
+ 98:    JGT  0,-18(7) 	while: jump begin
+* while: end
+ 99:    LDA  3,0(2) 	Epilogue: sp back to the caller's
+100:     LD  1,-1(2) 	Epilogue: load return address
+101:     LD  2,0(2) 	Epilogue: restore fp
+102:    LDA  7,0(1) 	Epilogue: return
+* <- FunDeclK
+* -> FunDeclK
+103:    LDA  3,-9(2) 	Prologue: Allocating memory for local variables
+104:     LD  0,-2(2) 	ssa: value on entry
+105:    LDC  1,0(0) 	load const
+106:     ST  1,-7(2) 	spill: store
+107:    LDC  1,0(0) 	load const
+108:     ST  1,-6(2) 	spill: store
+109:     LD  1,-3(2) 	ssa: value on entry
+110:    LDA  1,-3(1) 	unroll: room for the copies
+111:    JLE  1,21(7) 	while: exit
+* loop: preheader
+112:     LD  1,-3(2) 	ssa: value on entry
+113:    ADD  1,1,0 	loop: strength reduction
+114:     ST  1,-8(2) 	spill: store
+115:    LDA  1,0(0) 	ssa: copy
+* while: body
+116:     LD  4,0(1) 	ac = mem[ac]
+117:     LD  6,-7(2) 	spill: reload
+118:    ADD  4,6,4 	op +
+119:     LD  6,1(1) 	ac = mem[ac]
+120:    ADD  4,4,6 	op +
+121:     LD  6,2(1) 	ac = mem[ac]
+122:    ADD  4,4,6 	op +
+123:     LD  6,3(1) 	ac = mem[ac]
+124:    ADD  4,4,6 	op +
+125:     ST  4,-7(2) 	spill: store
+126:    LDA  1,4(1) 	loop: pointer step
+127:     LD  4,-8(2) 	spill: reload
+128:    SUB  4,4,1 	compare: right - left
+129:    LDA  4,-3(4) 	unroll: room for the copies
+130:    SUB  6,1,0 	loop: induction variable
+131:     ST  6,-6(2) 	spill: store
+132:    JGT  4,-17(7) 	while: jump begin
+* while: rest
+133:     LD  1,-3(2) 	ssa: value on entry
+134:     LD  4,-6(2) 	spill: reload
+135:    SUB  1,1,4 	compare: right - left
+136:    JLE  1,11(7) 	while: exit
+* loop: preheader
+137:     LD  1,-6(2) 	spill: reload
+138:    ADD  1,1,0 	loop: strength reduction
+139:     LD  4,-3(2) 	ssa: value on entry
+140:    ADD  0,4,0 	loop: strength reduction
+* while: body
+141:     LD  4,0(1) 	ac = mem[ac]
+142:     LD  6,-7(2) 	spill: reload
+143:    ADD  4,6,4 	op +
+144:     ST  4,-7(2) 	spill: store
+145:    LDA  1,1(1) 	loop: pointer step
+146:    SUB  4,0,1 	compare: right - left
+147:    JGT  4,-7(7) 	while: jump begin
+* while: end
+148:     LD  0,-7(2) 	spill: reload
+149:    LDA  3,0(2) 	Epilogue: sp back to the caller's
+150:     LD  1,-1(2) 	Epilogue: load return address
+151:     LD  2,0(2) 	Epilogue: restore fp
+152:    LDA  7,0(1) 	Epilogue: return
+* <- FunDeclK
+* -> FunDeclK
+153:    LDA  3,-4(2) 	Prologue: Allocating memory for local variables
+154:     LD  0,-2(2) 	ssa: value on entry
+155:     LD  1,-3(2) 	ssa: value on entry
+156:    SUB  4,1,0 	compare: right - left
+157:    JGE  4,4(7) 	if: jmp else
+* if: then
+158:    LDA  3,0(2) 	Epilogue: sp back to the caller's
+159:     LD  1,-1(2) 	Epilogue: load return address
+160:     LD  2,0(2) 	Epilogue: restore fp
+161:    LDA  7,0(1) 	Epilogue: return
+* if: end
+162:    LDA  0,0(1) 	returning
+163:    LDA  3,0(2) 	Epilogue: sp back to the caller's
+164:     LD  1,-1(2) 	Epilogue: load return address
+165:     LD  2,0(2) 	Epilogue: restore fp
+166:    LDA  7,0(1) 	Epilogue: return
+* <- FunDeclK
+* -> FunDeclK
+167:    LDA  3,-4(2) 	Prologue: Allocating memory for local variables
+168:     LD  0,-2(2) 	ssa: value on entry
+169:     LD  1,-3(2) 	ssa: value on entry
+170:    SUB  4,1,0 	compare: right - left
+171:    JLE  4,4(7) 	if: jmp else
+* if: then
+172:    LDA  3,0(2) 	Epilogue: sp back to the caller's
+173:     LD  1,-1(2) 	Epilogue: load return address
+174:     LD  2,0(2) 	Epilogue: restore fp
+175:    LDA  7,0(1) 	Epilogue: return
+* if: end
+176:    LDA  0,0(1) 	returning
+177:    LDA  3,0(2) 	Epilogue: sp back to the caller's
+178:     LD  1,-1(2) 	Epilogue: load return address
+179:     LD  2,0(2) 	Epilogue: restore fp
+180:    LDA  7,0(1) 	Epilogue: return
+* <- FunDeclK
+* -> FunDeclK
+181:    LDA  3,-2(2) 	Prologue: Allocating memory for local variables
+182:     LD  0,0(5) 	load id value
+183:    LDA  0,1(0) 	op +
+184:     ST  0,0(5) 	assign: store to global variable
+185:    LDA  3,0(2) 	Epilogue: sp back to the caller's
+186:     LD  1,-1(2) 	Epilogue: load return address
+187:     LD  2,0(2) 	Epilogue: restore fp
+188:    LDA  7,0(1) 	Epilogue: return
+* <- FunDeclK
+* -> FunDeclK
+189:    LDA  3,-3(2) 	Prologue: Allocating memory for local variables
+190:     ST  2,0(3) 	call: store fp
+191:    LDA  2,0(3) 	call: fp points to the new frame
+192:    LDC  0,195(0) 	call: return address
+193:     ST  0,-1(2) 	call: store return address
+194:    LDA  7,-14(7) 	jump to function
+195:     LD  0,-2(2) 	ssa: value on entry
+196:    MUL  0,0,0 	op *
+197:    LDA  3,0(2) 	Epilogue: sp back to the caller's
+198:     LD  1,-1(2) 	Epilogue: load return address
+199:     LD  2,0(2) 	Epilogue: restore fp
+200:    LDA  7,0(1) 	Epilogue: return
+* <- FunDeclK
+* -> FunDeclK
+201:    LDA  3,-6(2) 	Prologue: Allocating memory for local variables
+202:     LD  0,-2(2) 	ssa: value on entry
+203:     ST  0,-2(3) 	Storing current argument on stack
+204:     LD  0,-3(2) 	ssa: value on entry
+205:     ST  0,-3(3) 	Storing current argument on stack
+206:     ST  2,0(3) 	call: store fp
+207:    LDA  2,0(3) 	call: fp points to the new frame
+208:    LDC  0,211(0) 	call: return address
+209:     ST  0,-1(2) 	call: store return address
+210:    LDA  7,-44(7) 	jump to function
+211:     ST  0,-5(2) 	spill: store
+212:     LD  0,-2(2) 	ssa: value on entry
+213:     ST  0,-2(3) 	Storing current argument on stack
+214:     LD  0,-3(2) 	ssa: value on entry
+215:     ST  0,-3(3) 	Storing current argument on stack
+216:     ST  2,0(3) 	call: store fp
+217:    LDA  2,0(3) 	call: fp points to the new frame
+218:    LDC  0,221(0) 	call: return address
+219:     ST  0,-1(2) 	call: store return address
+220:    LDA  7,-68(7) 	jump to function
+221:     ST  0,-2(3) 	Storing current argument on stack
+222:     LD  0,-4(2) 	ssa: value on entry
+223:     ST  0,-3(3) 	Storing current argument on stack
+224:     ST  2,0(3) 	call: store fp
+225:    LDA  2,0(3) 	call: fp points to the new frame
+226:    LDC  0,229(0) 	call: return address
+227:     ST  0,-1(2) 	call: store return address
+228:    LDA  7,-62(7) 	jump to function
+229:     LD  1,-5(2) 	spill: reload
+230:     ST  1,-2(3) 	Storing current argument on stack
+231:     ST  0,-3(3) 	Storing current argument on stack
+232:     ST  2,0(3) 	call: store fp
+233:    LDA  2,0(3) 	call: fp points to the new frame
+234:    LDC  0,237(0) 	call: return address
+235:     ST  0,-1(2) 	call: store return address
+236:    LDA  7,-84(7) 	jump to function
+237:    LDA  3,0(2) 	Epilogue: sp back to the caller's
+238:     LD  1,-1(2) 	Epilogue: load return address
+239:     LD  2,0(2) 	Epilogue: restore fp
+240:    LDA  7,0(1) 	Epilogue: return
+* <- FunDeclK
+* -> FunDeclK
+241:    LDA  2,0(3) 	Prologue: FP pointing to current frame function
+242:    LDA  3,-6(3) 	Prologue: Allocating memory for local variables
+243:    LDC  0,0(0) 	load const
+244:     ST  0,0(5) 	assign: store to global variable
+245:    LDA  0,1(5) 	load global id address
+246:     ST  0,-3(2) 	spill: store
+247:    LDC  0,8(0) 	load const
+248:     LD  1,-3(2) 	spill: reload
+249:     ST  1,-2(3) 	Storing current argument on stack
+250:     ST  0,-3(3) 	Storing current argument on stack
+251:     ST  2,0(3) 	call: store fp
+252:    LDA  2,0(3) 	call: fp points to the new frame
+253:    LDC  0,256(0) 	call: return address
+254:     ST  0,-1(2) 	call: store return address
+255:    LDA  7,-243(7) 	jump to function
+256:    LDC  0,8(0) 	load const
+257:     LD  1,-3(2) 	spill: reload
+258:     ST  1,-2(3) 	Storing current argument on stack
+259:     ST  0,-3(3) 	Storing current argument on stack
+260:     ST  2,0(3) 	call: store fp
+261:    LDA  2,0(3) 	call: fp points to the new frame
+262:    LDC  0,265(0) 	call: return address
+263:     ST  0,-1(2) 	call: store return address
+264:    LDA  7,-162(7) 	jump to function
+265:    OUT  0,0,0 	output
+266:     IN  0,0,0 	input
+267:     ST  0,-4(2) 	spill: store
+268:    LDC  0,4(0) 	load const
+269:    LDC  1,9(0) 	load const
+270:     LD  4,-4(2) 	spill: reload
+271:     ST  4,-2(3) 	Storing current argument on stack
+272:     ST  0,-3(3) 	Storing current argument on stack
+273:     ST  1,-4(3) 	Storing current argument on stack
+274:     ST  2,0(3) 	call: store fp
+275:    LDA  2,0(3) 	call: fp points to the new frame
+276:    LDC  0,279(0) 	call: return address
+277:     ST  0,-1(2) 	call: store return address
+278:    LDA  7,-78(7) 	jump to function
+279:    OUT  0,0,0 	output
+280:     LD  0,-4(2) 	spill: reload
+281:     ST  0,-2(3) 	Storing current argument on stack
+282:     ST  2,0(3) 	call: store fp
+283:    LDA  2,0(3) 	call: fp points to the new frame
+284:    LDC  0,287(0) 	call: return address
+285:     ST  0,-1(2) 	call: store return address
+286:    LDA  7,-98(7) 	jump to function
+287:     ST  0,-5(2) 	spill: store
+288:    LDC  0,3(0) 	load const
+289:     ST  0,-2(3) 	Storing current argument on stack
+290:     ST  2,0(3) 	call: store fp
+291:    LDA  2,0(3) 	call: fp points to the new frame
+292:    LDC  0,295(0) 	call: return address
+293:     ST  0,-1(2) 	call: store return address
+294:    LDA  7,-106(7) 	jump to function
+295:     LD  1,-5(2) 	spill: reload
+296:    ADD  0,1,0 	op +
+297:    OUT  0,0,0 	output
+298:     LD  0,0(5) 	load id value
+299:     ST  0,4(5) 	assign: store to global variable
+300:    OUT  0,0,0 	output
+* <- FunDeclK
+* End of execution.
+301:   HALT  0,0,0 	
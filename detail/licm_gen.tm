@@ -0,0 +1,345 @@
+* TINY Compilation to TM Code
+* Standard prelude:
+  0:     LD  6,0(0) 	load maxaddress from location 0
+  1:     ST  0,0(0) 	clear location 0
+  2:    LDA  3,0(6) 	pointing sp to the top of the memory
+  3:    LDC  5,0(0) 	init GP to 0
+* End of standard prelude.
+* -> FunDeclK
+  4:    LDA  7,11(7) 	Unconditional relative jmp to main
+  5:    LDA  3,-2(2) 	Prologue: Allocating memory for local variables
+  6:     LD  0,0(5) 	load id value
+  7:    LDA  0,1(0) 	op +
+  8:     ST  0,0(5) 	assign: store to global variable
+  9:     LD  0,1(5) 	load id value
+ 10:    LDA  0,1(0) 	op +
+ 11:     ST  0,1(5) 	assign: store to global variable
+ 12:    LDA  3,0(2) 	Epilogue: sp back to the caller's
+ 13:     LD  1,-1(2) 	Epilogue: load return address
+ 14:     LD  2,0(2) 	Epilogue: restore fp
+ 15:    LDA  7,0(1) 	Epilogue: return
+* <- FunDeclK
+* -> FunDeclK
+ 16:    LDA  2,0(3) 	Prologue: FP pointing to current frame function
+ 17:    LDA  3,-36(3) 	Prologue: Allocating memory for local variables
+ 18:     IN  0,0,0 	input
+ 19:     ST  0,-16(2) 	spill: store
+ 20:     IN  0,0,0 	input
+ 21:    LDC  1,0(0) 	load const
+ 22:    LDC  4,0(0) 	load const
+ 23:     LD  6,-16(2) 	spill: reload
+ 24:    JLE  6,9(7) 	while: exit
+* loop: preheader
+* while: body
+ 25:    JEQ  0,3(7) 	if: jmp else
+* if: then
+ 26:    LDC  6,100(0) 	load const
+ 27:    DIV  6,6,0 	op /
+ 28:    ADD  1,1,6 	op +
+* if: end
+ 29:    ADD  1,1,4 	op +
+ 30:    LDA  4,1(4) 	op +
+ 31:     LD  6,-16(2) 	spill: reload
+ 32:    SUB  6,6,4 	compare: right - left
+ 33:    JGT  6,-9(7) 	while: jump begin
+* while: end
+ 34:    OUT  1,0,0 	output
+ 35:    LDC  0,1(0) 	load const
+ 36:     ST  0,0(5) 	assign: store to global variable
+ 37:    LDC  0,0(0) 	load const
+ 38:     ST  0,-22(2) 	spill: store
+ 39:    LDC  0,0(0) 	load const
+ 40:     ST  0,-21(2) 	spill: store
+ 41:     LD  0,-16(2) 	spill: reload
+ 42:    LDA  0,-3(0) 	unroll: room for the copies
+ 43:     ST  0,-17(2) 	spill: store
+ 44:    JLE  0,52(7) 	while: exit
+* loop: preheader
+* while: body
+ 45:     LD  0,0(5) 	load id value
+ 46:    LDC  1,2(0) 	load const
+ 47:    MUL  0,0,1 	op *
+ 48:     LD  1,-22(2) 	spill: reload
+ 49:    ADD  0,1,0 	op +
+ 50:     ST  0,-18(2) 	spill: store
+ 51:     ST  2,0(3) 	call: store fp
+ 52:    LDA  2,0(3) 	call: fp points to the new frame
+ 53:    LDC  0,56(0) 	call: return address
+ 54:     ST  0,-1(2) 	call: store return address
+ 55:    LDA  7,-51(7) 	jump to function
+ 56:     LD  0,0(5) 	load id value
+ 57:    LDC  1,2(0) 	load const
+ 58:    MUL  0,0,1 	op *
+ 59:     LD  1,-18(2) 	spill: reload
+ 60:    ADD  0,1,0 	op +
+ 61:     ST  0,-19(2) 	spill: store
+ 62:     ST  2,0(3) 	call: store fp
+ 63:    LDA  2,0(3) 	call: fp points to the new frame
+ 64:    LDC  0,67(0) 	call: return address
+ 65:     ST  0,-1(2) 	call: store return address
+ 66:    LDA  7,-62(7) 	jump to function
+ 67:     LD  0,0(5) 	load id value
+ 68:    LDC  1,2(0) 	load const
+ 69:    MUL  0,0,1 	op *
+ 70:     LD  1,-19(2) 	spill: reload
+ 71:    ADD  0,1,0 	op +
+ 72:     ST  0,-20(2) 	spill: store
+ 73:     ST  2,0(3) 	call: store fp
+ 74:    LDA  2,0(3) 	call: fp points to the new frame
+ 75:    LDC  0,78(0) 	call: return address
+ 76:     ST  0,-1(2) 	call: store return address
+ 77:    LDA  7,-73(7) 	jump to function
+ 78:     LD  0,0(5) 	load id value
+ 79:    LDC  1,2(0) 	load const
+ 80:    MUL  0,0,1 	op *
+ 81:     LD  1,-20(2) 	spill: reload
+ 82:    ADD  0,1,0 	op +
+ 83:     ST  0,-22(2) 	spill: store
+ 84:     ST  2,0(3) 	call: store fp
+ 85:    LDA  2,0(3) 	call: fp points to the new frame
+ 86:    LDC  0,89(0) 	call: return address
+ 87:     ST  0,-1(2) 	call: store return address
+ 88:    LDA  7,-84(7) 	jump to function
+ 89:     LD  0,-21(2) 	spill: reload
+ 90:    LDA  0,4(0) 	op +
+ 91:     ST  0,-21(2) 	spill: store
+ 92:     LD  0,-16(2) 	spill: reload
+ 93:     LD  1,-21(2) 	spill: reload
+ 94:    SUB  0,0,1 	compare: right - left
+ 95:    LDA  0,-3(0) 	unroll: room for the copies
+ 96:    JGT  0,-52(7) 	while: jump begin
+* while: rest
+ 97:     LD  0,-16(2) 	spill: reload
+ 98:     LD  1,-21(2) 	spill: reload
+ 99:    SUB  0,0,1 	compare: right - left
+100:    JLE  0,18(7) 	while: exit
+* loop: preheader
+* while: body
+101:     LD  0,0(5) 	load id value
+102:    LDC  1,2(0) 	load const
+103:    MUL  0,0,1 	op *
+104:     LD  1,-22(2) 	spill: reload
+105:    ADD  0,1,0 	op +
+106:     ST  0,-22(2) 	spill: store
+107:     ST  2,0(3) 	call: store fp
+108:    LDA  2,0(3) 	call: fp points to the new frame
+109:    LDC  0,112(0) 	call: return address
+110:     ST  0,-1(2) 	call: store return address
+111:    LDA  7,-107(7) 	jump to function
+112:     LD  0,-21(2) 	spill: reload
+113:    LDA  0,1(0) 	op +
+114:     ST  0,-21(2) 	spill: store
+115:     LD  0,-16(2) 	spill: reload
+116:     LD  1,-21(2) 	spill: reload
+117:    SUB  0,0,1 	compare: right - left
+118:    JGT  0,-18(7) 	while: jump begin
+* while: end
+119:     LD  0,-22(2) 	spill: reload
+120:    OUT  0,0,0 	output
+121:     LD  0,0(5) 	load id value
+122:    OUT  0,0,0 	output
+123:     LD  0,1(5) 	load id value
+124:    OUT  0,0,0 	output
+125:    LDC  0,0(0) 	load const
+126:     LD  1,-17(2) 	spill: reload
+127:    JLE  1,24(7) 	while: exit
+* loop: preheader
+128:    LDC  1,3(0) 	load const
+* while: body
+129:    LDC  4,3(0) 	load const
+130:    MUL  4,0,4 	op *
+131:    SUB  6,2,0 	ac = fp - index
+132:     ST  4,-2(6) 	assign: store to array
+133:    LDA  4,1(0) 	op +
+134:    LDC  6,3(0) 	load const
+135:    MUL  6,4,6 	op *
+136:    SUB  4,2,4 	ac = fp - index
+137:     ST  6,-2(4) 	assign: store to array
+138:    LDA  4,2(0) 	op +
+139:    LDC  6,3(0) 	load const
+140:    MUL  6,4,6 	op *
+141:    SUB  4,2,4 	ac = fp - index
+142:     ST  6,-2(4) 	assign: store to array
+143:    LDA  4,3(0) 	op +
+144:    MUL  6,4,1 	op *
+145:    SUB  4,2,4 	ac = fp - index
+146:     ST  6,-2(4) 	assign: store to array
+147:    LDA  0,4(0) 	op +
+148:     LD  4,-16(2) 	spill: reload
+149:    SUB  4,4,0 	compare: right - left
+150:    LDA  4,-3(4) 	unroll: room for the copies
+151:    JGT  4,-23(7) 	while: jump begin
+* while: rest
+152:     LD  1,-16(2) 	spill: reload
+153:    SUB  1,1,0 	compare: right - left
+154:    JLE  1,8(7) 	while: exit
+* loop: preheader
+155:    LDC  1,3(0) 	load const
+* while: body
+156:    MUL  4,0,1 	op *
+157:    SUB  6,2,0 	ac = fp - index
+158:     ST  4,-2(6) 	assign: store to array
+159:    LDA  0,1(0) 	op +
+160:     LD  4,-16(2) 	spill: reload
+161:    SUB  4,4,0 	compare: right - left
+162:    JGT  4,-7(7) 	while: jump begin
+* while: end
+163:    LDC  0,0(0) 	load const
+164:     LD  1,-17(2) 	spill: reload
+165:    JLE  1,43(7) 	while: exit
+* loop: preheader
+166:     LD  1,-16(2) 	spill: reload
+167:    LDA  1,-1(1) 	op -
+168:    LDA  4,0(5) 	loop: strength reduction
+169:    ADD  6,1,5 	loop: strength reduction
+170:     ST  6,-25(2) 	spill: store
+171:    ADD  6,1,5 	loop: strength reduction
+172:     ST  6,-26(2) 	spill: store
+173:    ADD  6,1,5 	loop: strength reduction
+174:     ST  6,-27(2) 	spill: store
+175:    ADD  1,1,5 	loop: strength reduction
+176:     ST  1,-28(2) 	spill: store
+177:     LD  1,-16(2) 	spill: reload
+178:    ADD  1,1,5 	loop: strength reduction
+179:     ST  1,-35(2) 	spill: store
+* while: body
+180:     LD  1,-25(2) 	spill: reload
+181:    SUB  1,1,4 	op -
+182:    SUB  1,2,1 	ac = fp - index
+183:     LD  1,-2(1) 	ac = mem[ac]
+184:     ST  1,2(4) 	assign: store to array
+185:    LDA  1,1(4) 	op +
+186:     LD  6,-26(2) 	spill: reload
+187:    SUB  1,6,1 	op -
+188:    SUB  1,2,1 	ac = fp - index
+189:     LD  1,-2(1) 	ac = mem[ac]
+190:     ST  1,3(4) 	assign: store to array
+191:    LDA  1,2(4) 	op +
+192:     LD  6,-27(2) 	spill: reload
+193:    SUB  1,6,1 	op -
+194:    SUB  1,2,1 	ac = fp - index
+195:     LD  1,-2(1) 	ac = mem[ac]
+196:     ST  1,4(4) 	assign: store to array
+197:    LDA  1,3(4) 	op +
+198:     LD  6,-28(2) 	spill: reload
+199:    SUB  1,6,1 	op -
+200:    SUB  1,2,1 	ac = fp - index
+201:     LD  1,-2(1) 	ac = mem[ac]
+202:     ST  1,5(4) 	assign: store to array
+203:    LDA  4,4(4) 	loop: pointer step
+204:     LD  1,-35(2) 	spill: reload
+205:    SUB  1,1,4 	compare: right - left
+206:    LDA  1,-3(1) 	unroll: room for the copies
+207:    SUB  0,4,5 	loop: induction variable
+208:    JGT  1,-29(7) 	while: jump begin
+* while: rest
+209:     LD  1,-16(2) 	spill: reload
+210:    SUB  1,1,0 	compare: right - left
+211:    JLE  1,13(7) 	while: exit
+* loop: preheader
+212:     LD  1,-16(2) 	spill: reload
+213:    LDA  1,-1(1) 	op -
+214:    ADD  0,0,5 	loop: strength reduction
+215:    ADD  1,1,5 	loop: strength reduction
+216:     LD  4,-16(2) 	spill: reload
+217:    ADD  4,4,5 	loop: strength reduction
+* while: body
+218:    SUB  6,1,0 	op -
+219:    SUB  6,2,6 	ac = fp - index
+220:     LD  6,-2(6) 	ac = mem[ac]
+221:     ST  6,2(0) 	assign: store to array
+222:    LDA  0,1(0) 	loop: pointer step
+223:    SUB  6,4,0 	compare: right - left
+224:    JGT  6,-7(7) 	while: jump begin
+* while: end
+225:     LD  0,2(5) 	ac = mem[ac]
+226:    OUT  0,0,0 	output
+227:     LD  0,11(5) 	ac = mem[ac]
+228:    OUT  0,0,0 	output
+229:    LDC  0,0(0) 	load const
+230:     ST  0,-24(2) 	spill: store
+231:    LDC  0,2(0) 	load const
+232:     ST  0,-23(2) 	spill: store
+233:     LD  0,-16(2) 	spill: reload
+234:    LDA  0,-5(0) 	unroll: room for the copies
+235:    JLE  0,48(7) 	while: exit
+* loop: preheader
+236:    LDA  0,-2(2) 	loop: strength reduction
+237:    ADD  1,2,5 	loop: strength reduction
+238:     ST  1,-29(2) 	spill: store
+239:    ADD  1,2,5 	loop: strength reduction
+240:     ST  1,-30(2) 	spill: store
+241:    ADD  1,2,5 	loop: strength reduction
+242:     ST  1,-31(2) 	spill: store
+243:    ADD  1,2,5 	loop: strength reduction
+244:     ST  1,-32(2) 	spill: store
+245:     LD  1,-16(2) 	spill: reload
+246:    SUB  1,2,1 	loop: strength reduction
+247:     ST  1,-33(2) 	spill: store
+* while: body
+248:     LD  1,-2(0) 	ac = mem[ac]
+249:     LD  4,-24(2) 	spill: reload
+250:    ADD  1,4,1 	op +
+251:     LD  4,-29(2) 	spill: reload
+252:    SUB  4,4,0 	ac = index + gp
+253:     LD  4,2(4) 	ac = mem[ac]
+254:    SUB  1,1,4 	op -
+255:    LDA  4,-1(0) 	op +
+256:     LD  6,-3(0) 	ac = mem[ac]
+257:    ADD  1,1,6 	op +
+258:     LD  6,-30(2) 	spill: reload
+259:    SUB  4,6,4 	ac = index + gp
+260:     LD  4,2(4) 	ac = mem[ac]
+261:    SUB  1,1,4 	op -
+262:    LDA  4,-2(0) 	op +
+263:     LD  6,-4(0) 	ac = mem[ac]
+264:    ADD  1,1,6 	op +
+265:     LD  6,-31(2) 	spill: reload
+266:    SUB  4,6,4 	ac = index + gp
+267:     LD  4,2(4) 	ac = mem[ac]
+268:    SUB  1,1,4 	op -
+269:    LDA  4,-3(0) 	op +
+270:     LD  6,-5(0) 	ac = mem[ac]
+271:    ADD  1,1,6 	op +
+272:     LD  6,-32(2) 	spill: reload
+273:    SUB  4,6,4 	ac = index + gp
+274:     LD  4,2(4) 	ac = mem[ac]
+275:    SUB  1,1,4 	op -
+276:     ST  1,-24(2) 	spill: store
+277:    LDA  0,-4(0) 	loop: pointer step
+278:     LD  1,-33(2) 	spill: reload
+279:    SUB  1,0,1 	compare: right - left
+280:    LDA  1,-3(1) 	unroll: room for the copies
+281:    SUB  4,2,0 	loop: induction variable
+282:     ST  4,-23(2) 	spill: store
+283:    JGT  1,-36(7) 	while: jump begin
+* while: rest
+284:     LD  0,-16(2) 	spill: reload
+285:     LD  1,-23(2) 	spill: reload
+286:    SUB  0,0,1 	compare: right - left
+287:    JLE  0,17(7) 	while: exit
+* loop: preheader
+288:     LD  0,-23(2) 	spill: reload
+289:    SUB  0,2,0 	loop: strength reduction
+290:    ADD  1,2,5 	loop: strength reduction
+291:     ST  1,-34(2) 	spill: store
+292:     LD  1,-16(2) 	spill: reload
+293:    SUB  1,2,1 	loop: strength reduction
+* while: body
+294:     LD  4,-2(0) 	ac = mem[ac]
+295:     LD  6,-24(2) 	spill: reload
+296:    ADD  4,6,4 	op +
+297:     LD  6,-34(2) 	spill: reload
+298:    SUB  6,6,0 	ac = index + gp
+299:     LD  6,2(6) 	ac = mem[ac]
+300:    SUB  4,4,6 	op -
+301:     ST  4,-24(2) 	spill: store
+302:    LDA  0,-1(0) 	loop: pointer step
+303:    SUB  4,0,1 	compare: right - left
+304:    JGT  4,-11(7) 	while: jump begin
+* while: end
+305:     LD  0,-24(2) 	spill: reload
+306:    OUT  0,0,0 	output
+* <- FunDeclK
+* End of execution.
+307:   HALT  0,0,0 	
@@ -0,0 +1,287 @@
+* TINY Compilation to TM Code
+* Standard prelude:
+  0:     LD  6,0(0) 	load maxaddress from location 0
+  1:     ST  0,0(0) 	clear location 0
+  2:    LDA  3,0(6) 	pointing sp to the top of the memory
+  3:    LDC  5,0(0) 	init GP to 0
+* End of standard prelude.
+* -> FunDeclK
+  4:    LDA  7,134(7) 	Unconditional relative jmp to main
+  5:    LDA  3,-3(2) 	Prologue: Allocating memory for local variables
+  6:    LDC  0,1(0) 	load const
+  7:     LD  1,-2(2) 	ssa: value on entry
+  8:    SUB  0,0,1 	compare: right - left
+  9:    JLT  0,5(7) 	if: jmp else
+* if: then
+ 10:    LDC  0,1(0) 	load const
+ 11:    LDA  3,0(2) 	Epilogue: sp back to the caller's
+ 12:     LD  1,-1(2) 	Epilogue: load return address
+ 13:     LD  2,0(2) 	Epilogue: restore fp
+ 14:    LDA  7,0(1) 	Epilogue: return
+* if: end
+ 15:     LD  0,-2(2) 	ssa: value on entry
+ 16:    LDA  0,-1(0) 	op -
+ 17:     ST  0,-2(3) 	Storing current argument on stack
+ 18:     ST  2,0(3) 	call: store fp
+ 19:    LDA  2,0(3) 	call: fp points to the new frame
+ 20:    LDC  0,23(0) 	call: return address
+ 21:     ST  0,-1(2) 	call: store return address
+ 22:    LDA  7,-18(7) 	jump to function
+ 23:     LD  1,-2(2) 	ssa: value on entry
+ 24:    MUL  0,1,0 	op *
+ 25:    LDA  3,0(2) 	Epilogue: sp back to the caller's
+ 26:     LD  1,-1(2) 	Epilogue: load return address
+ 27:     LD  2,0(2) 	Epilogue: restore fp
+ 28:    LDA  7,0(1) 	Epilogue: return
+* <- FunDeclK
+* -> FunDeclK
+ 29:    LDA  3,-4(2) 	Prologue: Allocating memory for local variables
+ 30:    LDC  0,2(0) 	load const
+ 31:     LD  1,-2(2) 	ssa: value on entry
+ 32:    SUB  0,0,1 	compare: right - left
+ 33:    JLE  0,5(7) 	if: jmp else
+* if: then
+ 34:     LD  0,-2(2) 	ssa: value on entry
+ 35:    LDA  3,0(2) 	Epilogue: sp back to the caller's
+ 36:     LD  1,-1(2) 	Epilogue: load return address
+ 37:     LD  2,0(2) 	Epilogue: restore fp
+ 38:    LDA  7,0(1) 	Epilogue: return
+* if: end
+ 39:     LD  0,-2(2) 	ssa: value on entry
+ 40:    LDA  0,-1(0) 	op -
+ 41:     ST  0,-2(3) 	Storing current argument on stack
+ 42:     ST  2,0(3) 	call: store fp
+ 43:    LDA  2,0(3) 	call: fp points to the new frame
+ 44:    LDC  0,47(0) 	call: return address
+ 45:     ST  0,-1(2) 	call: store return address
+ 46:    LDA  7,-18(7) 	jump to function
+ 47:     ST  0,-3(2) 	spill: store
+ 48:     LD  0,-2(2) 	ssa: value on entry
+ 49:    LDA  0,-2(0) 	op -
+ 50:     ST  0,-2(3) 	Storing current argument on stack
+ 51:     ST  2,0(3) 	call: store fp
+ 52:    LDA  2,0(3) 	call: fp points to the new frame
+ 53:    LDC  0,56(0) 	call: return address
+ 54:     ST  0,-1(2) 	call: store return address
+ 55:    LDA  7,-27(7) 	jump to function
+ 56:     LD  1,-3(2) 	spill: reload
+ 57:    ADD  0,1,0 	op +
+ 58:    LDA  3,0(2) 	Epilogue: sp back to the caller's
+ 59:     LD  1,-1(2) 	Epilogue: load return address
+ 60:     LD  2,0(2) 	Epilogue: restore fp
+ 61:    LDA  7,0(1) 	Epilogue: return
+* <- FunDeclK
+* -> FunDeclK
+ 62:    LDA  3,-5(2) 	Prologue: Allocating memory for local variables
+ 63:     LD  0,-2(2) 	ssa: value on entry
+ 64:     LD  1,-3(2) 	ssa: value on entry
+ 65:    JNE  1,6(7) 	if: jmp else
+* if: then
+ 66:    LDC  4,0(0) 	load const
+ 67:    LDA  0,0(4) 	returning
+ 68:    LDA  3,0(2) 	Epilogue: sp back to the caller's
+ 69:     LD  1,-1(2) 	Epilogue: load return address
+ 70:     LD  2,0(2) 	Epilogue: restore fp
+ 71:    LDA  7,0(1) 	Epilogue: return
+* if: end
+ 72:    LDA  1,-1(1) 	op -
+ 73:    ADD  4,0,1 	ac = (base_addr + index)
+ 74:     LD  4,0(4) 	ac = mem[ac]
+ 75:     ST  4,-4(2) 	spill: store
+ 76:     ST  0,-2(3) 	Storing current argument on stack
+ 77:     ST  1,-3(3) 	Storing current argument on stack
+ 78:     ST  2,0(3) 	call: store fp
+ 79:    LDA  2,0(3) 	call: fp points to the new frame
+ 80:    LDC  0,83(0) 	call: return address
+ 81:     ST  0,-1(2) 	call: store return address
+ 82:    LDA  7,-21(7) 	jump to function
+ 83:     LD  1,-4(2) 	spill: reload
+ 84:    ADD  0,1,0 	op +
+ 85:    LDA  3,0(2) 	Epilogue: sp back to the caller's
+ 86:     LD  1,-1(2) 	Epilogue: load return address
+ 87:     LD  2,0(2) 	Epilogue: restore fp
+ 88:    LDA  7,0(1) 	Epilogue: return
+* <- FunDeclK
+* -> FunDeclK
+ 89:    LDA  3,-5(2) 	Prologue: Allocating memory for local variables
+ 90:     LD  0,-2(2) 	ssa: value on entry
+ 91:    JNE  0,6(7) 	if: jmp else
+* if: then
+ 92:     LD  0,-3(2) 	ssa: value on entry
+ 93:    LDA  0,1(0) 	op +
+ 94:    LDA  3,0(2) 	Epilogue: sp back to the caller's
+ 95:     LD  1,-1(2) 	Epilogue: load return address
+ 96:     LD  2,0(2) 	Epilogue: restore fp
+ 97:    LDA  7,0(1) 	Epilogue: return
+* if: end
+ 98:     LD  0,-3(2) 	ssa: value on entry
+ 99:    JNE  0,14(7) 	if: jmp else
+* if: then
+100:     LD  0,-2(2) 	ssa: value on entry
+101:    LDA  0,-1(0) 	op -
+102:    LDC  1,1(0) 	load const
+103:     ST  0,-2(3) 	Storing current argument on stack
+104:     ST  1,-3(3) 	Storing current argument on stack
+105:     ST  2,0(3) 	call: store fp
+106:    LDA  2,0(3) 	call: fp points to the new frame
+107:    LDC  0,110(0) 	call: return address
+108:     ST  0,-1(2) 	call: store return address
+109:    LDA  7,-21(7) 	jump to function
+110:    LDA  3,0(2) 	Epilogue: sp back to the caller's
+111:     LD  1,-1(2) 	Epilogue: load return address
+112:     LD  2,0(2) 	Epilogue: restore fp
+113:    LDA  7,0(1) 	Epilogue: return
+* if: end
+114:     LD  0,-2(2) 	ssa: value on entry
+115:    LDA  0,-1(0) 	op -
+116:     ST  0,-4(2) 	spill: store
+117:     LD  0,-3(2) 	ssa: value on entry
+118:    LDA  0,-1(0) 	op -
+119:     LD  1,-2(2) 	ssa: value on entry
+120:     ST  1,-2(3) 	Storing current argument on stack
+121:     ST  0,-3(3) 	Storing current argument on stack
+122:     ST  2,0(3) 	call: store fp
+123:    LDA  2,0(3) 	call: fp points to the new frame
+124:    LDC  0,127(0) 	call: return address
+125:     ST  0,-1(2) 	call: store return address
+126:    LDA  7,-38(7) 	jump to function
+127:     LD  1,-4(2) 	spill: reload
+128:     ST  1,-2(3) 	Storing current argument on stack
+129:     ST  0,-3(3) 	Storing current argument on stack
+130:     ST  2,0(3) 	call: store fp
+131:    LDA  2,0(3) 	call: fp points to the new frame
+132:    LDC  0,135(0) 	call: return address
+133:     ST  0,-1(2) 	call: store return address
+134:    LDA  7,-46(7) 	jump to function
+135:    LDA  3,0(2) 	Epilogue: sp back to the caller's
+136:     LD  1,-1(2) 	Epilogue: load return address
+137:     LD  2,0(2) 	Epilogue: restore fp
+138:    LDA  7,0(1) 	Epilogue: return
+* <- FunDeclK
+* -> FunDeclK
+139:    LDA  2,0(3) 	Prologue: FP pointing to current frame function
+140:    LDA  3,-9(3) 	Prologue: Allocating memory for local variables
+141:     IN  0,0,0 	input
+142:     ST  0,-4(2) 	spill: store
+143:     ST  0,-2(3) 	Storing current argument on stack
+144:     ST  2,0(3) 	call: store fp
+145:    LDA  2,0(3) 	call: fp points to the new frame
+146:    LDC  0,149(0) 	call: return address
+147:     ST  0,-1(2) 	call: store return address
+148:    LDA  7,-144(7) 	jump to function
+149:    OUT  0,0,0 	output
+150:     LD  0,-4(2) 	spill: reload
+151:    LDA  0,4(0) 	op +
+152:     ST  0,-2(3) 	Storing current argument on stack
+153:     ST  2,0(3) 	call: store fp
+154:    LDA  2,0(3) 	call: fp points to the new frame
+155:    LDC  0,158(0) 	call: return address
+156:     ST  0,-1(2) 	call: store return address
+157:    LDA  7,-129(7) 	jump to function
+158:    OUT  0,0,0 	output
+159:    LDC  0,0(0) 	load const
+160:     ST  0,-8(2) 	spill: store
+161:     LD  0,-4(2) 	spill: reload
+162:    LDA  0,-3(0) 	unroll: room for the copies
+163:    JLE  0,54(7) 	while: exit
+* while: body
+164:     LD  0,-8(2) 	spill: reload
+165:     ST  0,-2(3) 	Storing current argument on stack
+166:     ST  2,0(3) 	call: store fp
+167:    LDA  2,0(3) 	call: fp points to the new frame
+168:    LDC  0,171(0) 	call: return address
+169:     ST  0,-1(2) 	call: store return address
+170:    LDA  7,-166(7) 	jump to function
+171:     LD  1,-8(2) 	spill: reload
+172:    ADD  1,1,5 	ac = index + gp
+173:     ST  0,0(1) 	assign: store to array
+174:     LD  0,-8(2) 	spill: reload
+175:    LDA  0,1(0) 	op +
+176:     ST  0,-5(2) 	spill: store
+177:     ST  0,-2(3) 	Storing current argument on stack
+178:     ST  2,0(3) 	call: store fp
+179:    LDA  2,0(3) 	call: fp points to the new frame
+180:    LDC  0,183(0) 	call: return address
+181:     ST  0,-1(2) 	call: store return address
+182:    LDA  7,-178(7) 	jump to function
+183:     LD  1,-5(2) 	spill: reload
+184:    ADD  1,1,5 	ac = index + gp
+185:     ST  0,0(1) 	assign: store to array
+186:     LD  0,-8(2) 	spill: reload
+187:    LDA  0,2(0) 	op +
+188:     ST  0,-6(2) 	spill: store
+189:     ST  0,-2(3) 	Storing current argument on stack
+190:     ST  2,0(3) 	call: store fp
+191:    LDA  2,0(3) 	call: fp points to the new frame
+192:    LDC  0,195(0) 	call: return address
+193:     ST  0,-1(2) 	call: store return address
+194:    LDA  7,-190(7) 	jump to function
+195:     LD  1,-6(2) 	spill: reload
+196:    ADD  1,1,5 	ac = index + gp
+197:     ST  0,0(1) 	assign: store to array
+198:     LD  0,-8(2) 	spill: reload
+199:    LDA  0,3(0) 	op +
+200:     ST  0,-7(2) 	spill: store
+201:     ST  0,-2(3) 	Storing current argument on stack
+202:     ST  2,0(3) 	call: store fp
+203:    LDA  2,0(3) 	call: fp points to the new frame
+204:    LDC  0,207(0) 	call: return address
+205:     ST  0,-1(2) 	call: store return address
+206:    LDA  7,-202(7) 	jump to function
+207:     LD  1,-7(2) 	spill: reload
+208:    ADD  1,1,5 	ac = index + gp
+209:     ST  0,0(1) 	assign: store to array
+210:     LD  0,-8(2) 	spill: reload
+211:    LDA  0,4(0) 	op +
+212:     ST  0,-8(2) 	spill: store
+213:     LD  0,-4(2) 	spill: reload
+214:     LD  1,-8(2) 	spill: reload
+215:    SUB  0,0,1 	compare: right - left
+216:    LDA  0,-3(0) 	unroll: room for the copies
+217:    JGT  0,-54(7) 	while: jump begin
+* while: rest
+218:     LD  0,-4(2) 	spill: reload
+219:     LD  1,-8(2) 	spill: reload
+220:    SUB  0,0,1 	compare: right - left
+221:    JLE  0,17(7) 	while: exit
+* while: body
+222:     LD  0,-8(2) 	spill: reload
+223:     ST  0,-2(3) 	Storing current argument on stack
+224:     ST  2,0(3) 	call: store fp
+225:    LDA  2,0(3) 	call: fp points to the new frame
+226:    LDC  0,229(0) 	call: return address
+227:     ST  0,-1(2) 	call: store return address
+228:    LDA  7,-224(7) 	jump to function
+229:     LD  1,-8(2) 	spill: reload
+230:    ADD  1,1,5 	ac = index + gp
+231:     ST  0,0(1) 	assign: store to array
+232:     LD  0,-8(2) 	spill: reload
+233:    LDA  0,1(0) 	op +
+234:     ST  0,-8(2) 	spill: store
+235:     LD  0,-4(2) 	spill: reload
+236:     LD  1,-8(2) 	spill: reload
+237:    SUB  0,0,1 	compare: right - left
+238:    JGT  0,-17(7) 	while: jump begin
+* while: end
+239:     ST  5,-2(3) 	Storing current argument on stack
+240:     LD  0,-4(2) 	spill: reload
+241:     ST  0,-3(3) 	Storing current argument on stack
+242:     ST  2,0(3) 	call: store fp
+243:    LDA  2,0(3) 	call: fp points to the new frame
+244:    LDC  0,247(0) 	call: return address
+245:     ST  0,-1(2) 	call: store return address
+246:    LDA  7,-185(7) 	jump to function
+247:    OUT  0,0,0 	output
+248:    LDC  0,2(0) 	load const
+249:    LDC  1,3(0) 	load const
+250:     ST  0,-2(3) 	Storing current argument on stack
+251:     ST  1,-3(3) 	Storing current argument on stack
+252:     ST  2,0(3) 	call: store fp
+253:    LDA  2,0(3) 	call: fp points to the new frame
+254:    LDC  0,257(0) 	call: return address
+255:     ST  0,-1(2) 	call: store return address
+256:    LDA  7,-168(7) 	jump to function
+257:    OUT  0,0,0 	output
+* <- FunDeclK
+* End of execution.
+258:   HALT  0,0,0 	
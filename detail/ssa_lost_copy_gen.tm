@@ -0,0 +1,85 @@
+* TINY Compilation to TM Code
+* Standard prelude:
+  0:     LD  6,0(0) 	load maxaddress from location 0
+  1:     ST  0,0(0) 	clear location 0
+  2:    LDA  3,0(6) 	pointing sp to the top of the memory
+  3:    LDC  5,0(0) 	init GP to 0
+* End of standard prelude.
+* -> FunDeclK
+  4:    LDA  2,0(3) 	Prologue: FP pointing to current frame function
+  5:    LDA  3,-10(3) 	Prologue: Allocating memory for local variables
+  6:     IN  0,0,0 	input
+  7:     ST  0,-6(2) 	spill: store
+  8:    LDC  0,0(0) 	load const
+  9:    LDC  1,0(0) 	load const
+ 10:     ST  1,-9(2) 	spill: store
+ 11:    LDC  1,0(0) 	load const
+ 12:     LD  4,-6(2) 	spill: reload
+ 13:    LDA  4,-3(4) 	unroll: room for the copies
+ 14:    JLE  4,14(7) 	while: exit
+* while: body
+ 15:    ADD  4,0,1 	op +
+ 16:    LDA  6,1(1) 	op +
+ 17:    ADD  4,4,6 	op +
+ 18:    LDA  6,2(1) 	op +
+ 19:    ADD  4,4,6 	op +
+ 20:     ST  4,-9(2) 	spill: store
+ 21:    LDA  4,3(1) 	op +
+ 22:     LD  6,-9(2) 	spill: reload
+ 23:    ADD  0,6,4 	op +
+ 24:    LDA  1,4(1) 	op +
+ 25:     LD  4,-6(2) 	spill: reload
+ 26:    SUB  4,4,1 	compare: right - left
+ 27:    LDA  4,-3(4) 	unroll: room for the copies
+ 28:    JGT  4,-14(7) 	while: jump begin
+* while: rest
+ 29:     LD  4,-6(2) 	spill: reload
+ 30:    SUB  4,4,1 	compare: right - left
+ 31:    JLE  4,11(7) 	while: exit
+* while: body
+ 32:    ADD  4,0,1 	op +
+ 33:    LDA  1,1(1) 	op +
+ 34:     LD  6,-6(2) 	spill: reload
+ 35:    SUB  6,6,1 	compare: right - left
+ 36:    JGT  6,4(7) 	while: jump begin
+ 37:    LDA  6,0(0) 	ssa: copy
+ 38:     ST  6,-9(2) 	spill: store
+ 39:    LDA  0,0(4) 	ssa: copy
+ 40:    LDA  7,2(7) 
+ 41:    LDA  0,0(4) 	ssa: copy
+ 42:    LDA  7,-11(7) 
+* while: end
+ 43:     LD  1,-9(2) 	spill: reload
+ 44:    OUT  1,0,0 	output
+ 45:    OUT  0,0,0 	output
+ 46:    LDC  0,32(0) 	load local id value
+ 47:    OUT  0,0,0 	output
+ 48:    LDC  0,64(0) 	load local id value
+ 49:    OUT  0,0,0 	output
+ 50:    LDC  0,7(0) 	load const
+ 51:    LDC  1,3(0) 	load const
+ 52:     ST  1,-8(2) 	spill: store
+ 53:    LDC  1,0(0) 	load const
+ 54:     LD  4,-6(2) 	spill: reload
+ 55:    LDA  4,-5(4) 	op -
+ 56:     ST  4,-7(2) 	spill: store
+ 57:    JLE  4,11(7) 	while: exit
+* while: body
+ 58:    LDA  4,1(0) 	op +
+ 59:    LDA  1,1(1) 	op +
+ 60:     LD  6,-7(2) 	spill: reload
+ 61:    SUB  6,6,1 	compare: right - left
+ 62:    JGT  6,4(7) 	while: jump begin
+ 63:    LDA  6,0(0) 	ssa: copy
+ 64:     ST  6,-8(2) 	spill: store
+ 65:    LDA  0,0(4) 	ssa: copy
+ 66:    LDA  7,2(7) 
+ 67:    LDA  0,0(4) 	ssa: copy
+ 68:    LDA  7,-11(7) 
+* while: end
+ 69:     LD  1,-8(2) 	spill: reload
+ 70:    OUT  1,0,0 	output
+ 71:    OUT  0,0,0 	output
+* <- FunDeclK
+* End of execution.
+ 72:   HALT  0,0,0 	
@@ -0,0 +1,195 @@
+* TINY Compilation to TM Code
+* Standard prelude:
+  0:     LD  6,0(0) 	load maxaddress from location 0
+  1:     ST  0,0(0) 	clear location 0
+  2:    LDA  3,0(6) 	pointing sp to the top of the memory
+  3:    LDC  5,0(0) 	init GP to 0
+* End of standard prelude.
+* -> FunDeclK
+  4:    LDA  2,0(3) 	Prologue: FP pointing to current frame function
+  5:    LDA  3,-15(3) 	Prologue: Allocating memory for local variables
+  6:     IN  0,0,0 	input
+  7:     IN  1,0,0 	input
+  8:     ST  1,-11(2) 	spill: store
+  9:     IN  1,0,0 	input
+ 10:     ST  1,-12(2) 	spill: store
+ 11:     IN  1,0,0 	input
+ 12:     ST  1,-8(2) 	spill: store
+ 13:    LDC  1,0(0) 	load const
+ 14:     ST  1,-13(2) 	spill: store
+ 15:     LD  1,-8(2) 	spill: reload
+ 16:    LDA  1,-3(1) 	unroll: room for the copies
+ 17:     ST  1,-9(2) 	spill: store
+ 18:    JLE  1,56(7) 	while: exit
+* loop: preheader
+* while: body
+ 19:     LD  1,-11(2) 	spill: reload
+ 20:    LDC  4,100(0) 	load const
+ 21:    MUL  1,1,4 	op *
+ 22:     ST  1,-10(2) 	spill: store
+ 23:     LD  1,-12(2) 	spill: reload
+ 24:    LDC  4,10(0) 	load const
+ 25:    MUL  1,1,4 	op *
+ 26:     ST  1,-14(2) 	spill: store
+ 27:     LD  1,-10(2) 	spill: reload
+ 28:     LD  4,-14(2) 	spill: reload
+ 29:    ADD  1,1,4 	op +
+ 30:    ADD  1,1,0 	op +
+ 31:    OUT  1,0,0 	output
+ 32:     LD  1,-12(2) 	spill: reload
+ 33:    LDC  4,100(0) 	load const
+ 34:    MUL  1,1,4 	op *
+ 35:    LDC  4,10(0) 	load const
+ 36:    MUL  4,0,4 	op *
+ 37:    ADD  1,1,4 	op +
+ 38:     LD  4,-11(2) 	spill: reload
+ 39:    ADD  1,1,4 	op +
+ 40:    OUT  1,0,0 	output
+ 41:    LDC  1,100(0) 	load const
+ 42:    MUL  1,0,1 	op *
+ 43:     LD  4,-11(2) 	spill: reload
+ 44:    LDC  6,10(0) 	load const
+ 45:    MUL  4,4,6 	op *
+ 46:    ADD  1,1,4 	op +
+ 47:     LD  4,-12(2) 	spill: reload
+ 48:    ADD  1,1,4 	op +
+ 49:    OUT  1,0,0 	output
+ 50:     LD  1,-10(2) 	spill: reload
+ 51:     LD  4,-14(2) 	spill: reload
+ 52:    ADD  1,1,4 	op +
+ 53:    ADD  1,1,0 	op +
+ 54:    OUT  1,0,0 	output
+ 55:     LD  1,-13(2) 	spill: reload
+ 56:    LDA  1,4(1) 	op +
+ 57:     ST  1,-13(2) 	spill: store
+ 58:     LD  1,-8(2) 	spill: reload
+ 59:     LD  4,-13(2) 	spill: reload
+ 60:    SUB  1,1,4 	compare: right - left
+ 61:    LDA  1,-3(1) 	unroll: room for the copies
+ 62:    JGT  1,6(7) 	while: jump begin
+ 63:    LDA  1,0(0) 	ssa: copy
+ 64:     LD  0,-11(2) 	spill: reload
+ 65:     LD  4,-12(2) 	spill: reload
+ 66:     ST  4,-11(2) 	spill: store
+ 67:     ST  1,-12(2) 	spill: store
+ 68:    LDA  7,6(7) 
+ 69:    LDA  1,0(0) 	ssa: copy
+ 70:     LD  0,-11(2) 	spill: reload
+ 71:     LD  4,-12(2) 	spill: reload
+ 72:     ST  4,-11(2) 	spill: store
+ 73:     ST  1,-12(2) 	spill: store
+ 74:    LDA  7,-56(7) 
+* while: rest
+ 75:     LD  1,-8(2) 	spill: reload
+ 76:     LD  4,-13(2) 	spill: reload
+ 77:    SUB  1,1,4 	compare: right - left
+ 78:    JLE  1,29(7) 	while: exit
+* loop: preheader
+ 79:    LDC  1,10(0) 	load const
+* while: body
+ 80:     LD  4,-11(2) 	spill: reload
+ 81:    LDC  6,100(0) 	load const
+ 82:    MUL  4,4,6 	op *
+ 83:     LD  6,-12(2) 	spill: reload
+ 84:    MUL  6,6,1 	op *
+ 85:    ADD  4,4,6 	op +
+ 86:    ADD  4,4,0 	op +
+ 87:    OUT  4,0,0 	output
+ 88:     LD  4,-13(2) 	spill: reload
+ 89:    LDA  4,1(4) 	op +
+ 90:     ST  4,-13(2) 	spill: store
+ 91:     LD  4,-8(2) 	spill: reload
+ 92:     LD  6,-13(2) 	spill: reload
+ 93:    SUB  4,4,6 	compare: right - left
+ 94:    JGT  4,7(7) 	while: jump begin
+ 95:     LD  4,-12(2) 	spill: reload
+ 96:    LDA  6,0(0) 	ssa: copy
+ 97:     ST  6,-12(2) 	spill: store
+ 98:     LD  6,-11(2) 	spill: reload
+ 99:    LDA  0,0(6) 	ssa: copy
+100:     ST  4,-11(2) 	spill: store
+101:    LDA  7,6(7) 
+102:    LDA  4,0(0) 	ssa: copy
+103:     LD  0,-11(2) 	spill: reload
+104:     LD  6,-12(2) 	spill: reload
+105:     ST  6,-11(2) 	spill: store
+106:     ST  4,-12(2) 	spill: store
+107:    LDA  7,-28(7) 
+* while: end
+108:    OUT  0,0,0 	output
+109:     LD  1,-11(2) 	spill: reload
+110:    OUT  1,0,0 	output
+111:     LD  1,-12(2) 	spill: reload
+112:    OUT  1,0,0 	output
+113:    LDC  1,0(0) 	load const
+114:     LD  4,-9(2) 	spill: reload
+115:    JLE  4,5(7) 	while: exit
+* while: body
+116:    LDA  1,4(1) 	op +
+117:     LD  4,-8(2) 	spill: reload
+118:    SUB  4,4,1 	compare: right - left
+119:    LDA  4,-3(4) 	unroll: room for the copies
+120:    JGT  4,-5(7) 	while: jump begin
+* while: rest
+121:     LD  4,-8(2) 	spill: reload
+122:    SUB  4,4,1 	compare: right - left
+123:    JLE  4,14(7) 	while: exit
+* while: body
+124:    LDA  1,1(1) 	op +
+125:     LD  4,-8(2) 	spill: reload
+126:    SUB  4,4,1 	compare: right - left
+127:    JGT  4,5(7) 	while: jump begin
+128:     LD  4,-11(2) 	spill: reload
+129:    LDA  6,0(0) 	ssa: copy
+130:     ST  6,-11(2) 	spill: store
+131:    LDA  0,0(4) 	ssa: copy
+132:    LDA  7,5(7) 
+133:    LDA  4,0(0) 	ssa: copy
+134:     LD  6,-11(2) 	spill: reload
+135:    LDA  0,0(6) 	ssa: copy
+136:     ST  4,-11(2) 	spill: store
+137:    LDA  7,-14(7) 
+* while: end
+138:    LDC  1,10(0) 	load const
+139:    MUL  1,0,1 	op *
+140:     LD  4,-11(2) 	spill: reload
+141:    ADD  1,1,4 	op +
+142:    OUT  1,0,0 	output
+143:    LDC  1,1(0) 	load const
+144:     LD  4,-8(2) 	spill: reload
+145:    LDA  4,-4(4) 	unroll: room for the copies
+146:    JLE  4,5(7) 	while: exit
+* while: body
+147:    LDA  1,4(1) 	op +
+148:     LD  4,-8(2) 	spill: reload
+149:    SUB  4,4,1 	compare: right - left
+150:    LDA  4,-3(4) 	unroll: room for the copies
+151:    JGT  4,-5(7) 	while: jump begin
+* while: rest
+152:     LD  4,-8(2) 	spill: reload
+153:    SUB  4,4,1 	compare: right - left
+154:    JLE  4,14(7) 	while: exit
+* while: body
+155:    LDA  1,1(1) 	op +
+156:     LD  4,-8(2) 	spill: reload
+157:    SUB  4,4,1 	compare: right - left
+158:    JGT  4,5(7) 	while: jump begin
+159:     LD  4,-11(2) 	spill: reload
+160:    LDA  6,0(0) 	ssa: copy
+161:     ST  6,-11(2) 	spill: store
+162:    LDA  0,0(4) 	ssa: copy
+163:    LDA  7,5(7) 
+164:    LDA  4,0(0) 	ssa: copy
+165:     LD  6,-11(2) 	spill: reload
+166:    LDA  0,0(6) 	ssa: copy
+167:     ST  4,-11(2) 	spill: store
+168:    LDA  7,-14(7) 
+* while: end
+169:    LDC  1,10(0) 	load const
+170:    MUL  0,0,1 	op *
+171:     LD  1,-11(2) 	spill: reload
+172:    ADD  0,0,1 	op +
+173:    OUT  0,0,0 	output
+* <- FunDeclK
+* End of execution.
+174:   HALT  0,0,0 	
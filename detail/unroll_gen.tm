@@ -0,0 +1,183 @@
+* TINY Compilation to TM Code
+* Standard prelude:
+  0:     LD  6,0(0) 	load maxaddress from location 0
+  1:     ST  0,0(0) 	clear location 0
+  2:    LDA  3,0(6) 	pointing sp to the top of the memory
+  3:    LDC  5,0(0) 	init GP to 0
+* End of standard prelude.
+* -> FunDeclK
+  4:    LDA  7,8(7) 	Unconditional relative jmp to main
+  5:    LDA  3,-2(2) 	Prologue: Allocating memory for local variables
+  6:     LD  0,0(5) 	load id value
+  7:    LDA  0,1(0) 	op +
+  8:     ST  0,0(5) 	assign: store to global variable
+  9:    LDA  3,0(2) 	Epilogue: sp back to the caller's
+ 10:     LD  1,-1(2) 	Epilogue: load return address
+ 11:     LD  2,0(2) 	Epilogue: restore fp
+ 12:    LDA  7,0(1) 	Epilogue: return
+* <- FunDeclK
+* -> FunDeclK
+ 13:    LDA  2,0(3) 	Prologue: FP pointing to current frame function
+ 14:    LDA  3,-8(3) 	Prologue: Allocating memory for local variables
+ 15:     IN  0,0,0 	input
+ 16:     ST  0,-5(2) 	spill: store
+ 17:    LDC  0,0(0) 	load local id value
+ 18:    OUT  0,0,0 	output
+ 19:    LDC  0,9(0) 	load local id value
+ 20:    OUT  0,0,0 	output
+ 21:    LDC  0,57(0) 	load local id value
+ 22:    OUT  0,0,0 	output
+ 23:    LDC  0,6(0) 	load local id value
+ 24:    OUT  0,0,0 	output
+ 25:    LDC  0,0(0) 	load const
+* while: body
+ 26:    MUL  1,0,0 	op *
+ 27:    ADD  4,0,5 	ac = index + gp
+ 28:     ST  1,2(4) 	assign: store to array
+ 29:    LDA  1,1(0) 	op +
+ 30:    MUL  4,1,1 	op *
+ 31:    ADD  1,1,5 	ac = index + gp
+ 32:     ST  4,2(1) 	assign: store to array
+ 33:    LDA  1,2(0) 	op +
+ 34:    MUL  4,1,1 	op *
+ 35:    ADD  1,1,5 	ac = index + gp
+ 36:     ST  4,2(1) 	assign: store to array
+ 37:    LDA  1,3(0) 	op +
+ 38:    MUL  4,1,1 	op *
+ 39:    ADD  1,1,5 	ac = index + gp
+ 40:     ST  4,2(1) 	assign: store to array
+ 41:    LDA  0,4(0) 	op +
+ 42:    LDA  1,-9(0) 	unroll: room for the copies
+ 43:    JLT  1,-18(7) 	while: jump begin
+* while: end
+ 44:     LD  1,13(5) 	ac = mem[ac]
+ 45:    OUT  1,0,0 	output
+ 46:    OUT  0,0,0 	output
+ 47:    LDC  0,0(0) 	load const
+ 48:    LDC  1,2(0) 	load const
+* while: body
+ 49:    ADD  4,0,1 	op +
+ 50:    LDA  6,1(1) 	op +
+ 51:    ADD  4,4,6 	op +
+ 52:    LDA  6,2(1) 	op +
+ 53:    ADD  4,4,6 	op +
+ 54:    LDA  6,3(1) 	op +
+ 55:    ADD  0,4,6 	op +
+ 56:    LDA  1,4(1) 	op +
+ 57:    LDA  4,-37(1) 	unroll: room for the copies
+ 58:    JLE  4,-10(7) 	while: jump begin
+* while: rest
+ 59:    ADD  0,0,1 	op +
+ 60:    LDA  4,1(1) 	op +
+ 61:    ADD  0,0,4 	op +
+ 62:    LDA  4,2(1) 	op +
+ 63:    ADD  0,0,4 	op +
+ 64:    LDA  1,3(1) 	op +
+ 65:    OUT  0,0,0 	output
+ 66:    OUT  1,0,0 	output
+ 67:    LDC  0,0(0) 	load const
+ 68:    LDC  1,0(0) 	load const
+ 69:     ST  1,-6(2) 	spill: store
+ 70:     LD  1,-5(2) 	spill: reload
+ 71:    LDA  1,-3(1) 	unroll: room for the copies
+ 72:    JLE  1,19(7) 	while: exit
+* loop: preheader
+ 73:    LDA  1,0(5) 	loop: strength reduction
+ 74:     LD  4,-5(2) 	spill: reload
+ 75:    ADD  4,4,5 	loop: strength reduction
+ 76:     ST  4,-7(2) 	spill: store
+* while: body
+ 77:     LD  4,2(1) 	ac = mem[ac]
+ 78:    ADD  4,0,4 	op +
+ 79:     LD  6,3(1) 	ac = mem[ac]
+ 80:    ADD  4,4,6 	op +
+ 81:     LD  6,4(1) 	ac = mem[ac]
+ 82:    ADD  4,4,6 	op +
+ 83:     LD  6,5(1) 	ac = mem[ac]
+ 84:    ADD  0,4,6 	op +
+ 85:    LDA  1,4(1) 	loop: pointer step
+ 86:     LD  4,-7(2) 	spill: reload
+ 87:    SUB  4,4,1 	compare: right - left
+ 88:    LDA  4,-3(4) 	unroll: room for the copies
+ 89:    SUB  6,1,5 	loop: induction variable
+ 90:     ST  6,-6(2) 	spill: store
+ 91:    JGT  4,-15(7) 	while: jump begin
+* while: rest
+ 92:     LD  1,-5(2) 	spill: reload
+ 93:     LD  4,-6(2) 	spill: reload
+ 94:    SUB  1,1,4 	compare: right - left
+ 95:    JLE  1,9(7) 	while: exit
+* loop: preheader
+ 96:     LD  1,-6(2) 	spill: reload
+ 97:    ADD  1,1,5 	loop: strength reduction
+ 98:     LD  4,-5(2) 	spill: reload
+ 99:    ADD  4,4,5 	loop: strength reduction
+* while: body
+100:     LD  6,2(1) 	ac = mem[ac]
+101:    ADD  0,0,6 	op +
+102:    LDA  1,1(1) 	loop: pointer step
+103:    SUB  6,4,1 	compare: right - left
+104:    JGT  6,-5(7) 	while: jump begin
+* while: end
+105:    OUT  0,0,0 	output
+106:    LDC  0,0(0) 	load const
+107:    LDC  1,3(0) 	load const
+108:    LDC  4,3(0) 	load local id value
+109:     LD  6,-5(2) 	spill: reload
+110:    SUB  4,4,6 	compare: right - left
+111:    LDA  4,3(4) 	unroll: room for the copies
+112:    JGT  4,12(7) 	while: exit
+* while: body
+113:    ADD  4,0,1 	op +
+114:    LDA  6,1(1) 	op +
+115:    ADD  4,4,6 	op +
+116:    LDA  6,2(1) 	op +
+117:    ADD  4,4,6 	op +
+118:    LDA  6,3(1) 	op +
+119:    ADD  0,4,6 	op +
+120:    LDA  1,4(1) 	op +
+121:     LD  4,-5(2) 	spill: reload
+122:    SUB  4,1,4 	compare: right - left
+123:    LDA  4,3(4) 	unroll: room for the copies
+124:    JLE  4,-12(7) 	while: jump begin
+* while: rest
+125:     LD  4,-5(2) 	spill: reload
+126:    SUB  4,1,4 	compare: right - left
+127:    JGT  4,5(7) 	while: exit
+* while: body
+128:    ADD  0,0,1 	op +
+129:    LDA  1,1(1) 	op +
+130:     LD  4,-5(2) 	spill: reload
+131:    SUB  4,1,4 	compare: right - left
+132:    JLE  4,-5(7) 	while: jump begin
+* while: end
+133:    OUT  0,0,0 	output
+134:    OUT  1,0,0 	output
+135:    LDC  0,0(0) 	load const
+136:     ST  0,1(5) 	assign: store to global variable
+137:    LDC  0,0(0) 	load const
+138:     ST  0,0(5) 	assign: store to global variable
+* while: body
+139:     LD  0,1(5) 	load id value
+140:     LD  1,0(5) 	load id value
+141:    ADD  0,0,1 	op +
+142:     ST  0,1(5) 	assign: store to global variable
+143:     ST  2,0(3) 	call: store fp
+144:    LDA  2,0(3) 	call: fp points to the new frame
+145:    LDC  0,148(0) 	call: return address
+146:     ST  0,-1(2) 	call: store return address
+147:    LDA  7,-143(7) 	jump to function
+148:     LD  0,0(5) 	load id value
+149:    LDA  0,1(0) 	op +
+150:     ST  0,0(5) 	assign: store to global variable
+151:    LDC  1,10(0) 	load const
+152:    SUB  0,1,0 	compare: right - left
+153:    JGT  0,-15(7) 	while: jump begin
+* while: end
+154:     LD  0,1(5) 	load id value
+155:    OUT  0,0,0 	output
+156:     LD  0,0(5) 	load id value
+157:    OUT  0,0,0 	output
+* <- FunDeclK
+* End of execution.
+158:   HALT  0,0,0 	
@@ -0,0 +1,313 @@
+"""Differential test of the code generator.
+
+Generates random terminating C- programs, compiles each with two compilers
+and runs both codes on tm; what OUT prints and how tm stops must agree.
+
+  python3 fuzz_compare.py REF NEW [-seed S] [-n N] [-tm TM] [-- NEW options]
+
+REF and NEW are mycmcomp binaries (e.g. one built from the commit before a
+change); options after -- are given to NEW only, e.g. -- -passes none.
+A program whose runs differ is kept as fuzz_<seed>.cm; one whose NEW code
+does not fit in the instruction memory of tm is counted apart. python3
+fuzz_compare.py -print S writes the program of seed S to stdout.
+"""
+import os
+import random
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+LETTERS = 'abcdefghijklmnopqrstuvwxyz'
+RELOPS = ['<', '<=', '>', '>=', '==', '!=']
+
+
+def name_of(k):
+    s = ''
+    k += 1
+    while k:
+        k -= 1
+        s += LETTERS[k % 26]
+        k //= 26
+    return s
+
+
+def literal(v):
+    return str(v) if v >= 0 else '(0 - %d)' % -v
+
+
+class Fun:
+    pass
+
+
+class Gen:
+    """Programs use no input; loops count a variable up to a constant and
+    functions only call the ones declared before them, so they stop. Every
+    array has 10 elements and every index lies in 0..9."""
+
+    def __init__(self, seed):
+        self.r = random.Random(seed)
+        self.uniq = 0
+        self.nesting = 0  # calls in the arguments of calls
+
+    def program(self):
+        r = self.r
+        out = []
+        gvars = ['g' + name_of(i) for i in range(r.randint(1, 4))]
+        garrs = ['ga' + name_of(i) for i in range(r.randint(0, 2))]
+        self.globals = set(gvars)  # counters a call may change
+        out += ['int %s;' % v for v in gvars]
+        out += ['int %s[10];' % a for a in garrs]
+        funs = []
+        for fi in range(r.randint(0, 4)):
+            f = Fun()
+            f.name = 'f' + name_of(fi)
+            f.ret = r.choice(['int', 'int', 'void'])
+            f.params = [('p' + name_of(pi), r.random() < 0.3)
+                        for pi in range(r.randint(0, 3))]
+            out.append(self.function(f, funs, gvars, garrs))
+            funs.append(f)
+        m = Fun()
+        m.name, m.ret, m.params = 'main', 'void', []
+        out.append(self.function(m, funs, gvars, garrs))
+        return '\n'.join(out) + '\n'
+
+    def function(self, f, funs, gvars, garrs):
+        self.funs, self.f, self.depth = funs, f, 0
+        self.vars = list(gvars) + [p for p, a in f.params if not a]
+        self.arrs = list(garrs) + [p for p, a in f.params if a]
+        self.counters = []
+        params = ', '.join(('int %s[]' if a else 'int %s') % p
+                           for p, a in f.params) or 'void'
+        body = self.compound(True)
+        if f.ret == 'int':
+            body = body[:-2] + '  return %s;\n}' % self.exp(2)
+        return '%s %s(%s)\n%s\n' % (f.ret, f.name, params, body)
+
+    def compound(self, top=False):
+        r = self.r
+        ind = '  ' * (self.depth + 1)
+        lines, locs, larrs = [], [], []
+        for i in range(r.randint(0, 3)):
+            n = 'l' + name_of(self.uniq)
+            self.uniq += 1
+            if r.random() < 0.25:
+                larrs.append(n)
+                lines.append(ind + 'int %s[10];' % n)
+            else:
+                locs.append(n)
+                lines.append(ind + 'int %s;' % n)
+        saved = (self.vars, self.arrs)
+        self.vars, self.arrs = self.vars + locs, self.arrs + larrs
+        for n in locs:
+            lines.append(ind + '%s = %s;' % (n, literal(r.randint(-5, 20))))
+        for a in larrs:
+            for k in range(10):
+                lines.append(ind + '%s[%d] = %s;' %
+                             (a, k, literal(r.randint(-9, 9))))
+        self.depth += 1
+        for i in range(r.randint(1, 5 if self.depth < 3 else 2)):
+            lines.append(self.stmt())
+        self.depth -= 1
+        if top:
+            lines += [ind + 'output(%s);' % v for v in self.vars[:3]]
+        self.vars, self.arrs = saved
+        return ('  ' * self.depth + '{\n' + '\n'.join(lines) + '\n' +
+                '  ' * self.depth + '}')
+
+    def stmt(self):
+        r = self.r
+        ind = '  ' * self.depth
+        x = r.random()
+        if self.depth < 4 and x < 0.2:
+            s = ind + 'if (%s)\n' % self.cond() + self.sub()
+            if r.random() < 0.5:
+                s += '\n' + ind + 'else\n' + self.sub()
+            return s
+        if self.depth < 4 and x < 0.32 and len(self.counters) < 3:
+            return self.loop()
+        if x < 0.45:
+            return ind + 'output(%s);' % self.exp(3)
+        if x < 0.55 and self.arrs:
+            return ind + '%s[%s] = %s;' % (r.choice(self.arrs), self.index(),
+                                           self.exp(3))
+        if x < 0.62:
+            call = self.call(True)
+            if call:
+                return ind + call + ';'
+        free = [v for v in self.vars if v not in self.counters]
+        if free:
+            return ind + '%s = %s;' % (r.choice(free), self.exp(3))
+        return ind + 'output(%s);' % self.exp(3)
+
+    def loop(self):
+        ind = '  ' * self.depth
+        c = self.r.choice([v for v in self.vars if v not in self.counters]
+                          or [None])
+        if c is None:
+            return ind + 'output(1);'
+        self.counters.append(c)
+        s = ind + '{\n' + ind + '%s = 0;\n' % c
+        s += ind + 'while (%s < %d)\n' % (c, self.r.randint(0, 6))
+        self.depth += 1
+        body = [self.stmt() for i in range(self.r.randint(1, 3))]
+        self.depth -= 1
+        body.append('  ' * (self.depth + 1) + '%s = %s + 1;' % (c, c))
+        s += ind + '{\n' + '\n'.join(body) + '\n' + ind + '}\n' + ind + '}'
+        self.counters.pop()
+        return s
+
+    def sub(self):
+        self.depth += 1
+        s = self.compound() if self.r.random() < 0.4 else self.stmt()
+        self.depth -= 1
+        return s
+
+    def cond(self):
+        if self.r.random() < 0.6:
+            return '%s %s %s' % (self.exp(2, True), self.r.choice(RELOPS),
+                                 self.exp(2, True))
+        return self.exp(2)
+
+    def index(self):
+        # a call in the loop may change a global counter, so only a local
+        # one is known to lie in 0..9
+        local = [c for c in self.counters if c not in self.globals]
+        x = self.r.random()
+        if x >= 0.5 and x < 0.8 and local:
+            return self.r.choice(local)
+        return str(self.r.randint(0, 9))
+
+    def call(self, stmt=False):
+        fs = [f for f in self.funs if stmt or f.ret == 'int']
+        if not fs or self.nesting > 3:
+            return None
+        f = self.r.choice(fs)
+        args = []
+        self.nesting += 1
+        # a local array is passed in the wrong order (indexed downward from
+        # fp, but upward through the parameter), so only pass the others
+        arrs = [a for a in self.arrs if not a.startswith('l')]
+        for p, a in f.params:
+            if a:
+                if not arrs:
+                    args = None
+                    break
+                args.append(self.r.choice(arrs))
+            else:
+                args.append(self.exp(1))
+        self.nesting -= 1
+        return '%s(%s)' % (f.name, ', '.join(args)) if args is not None else None
+
+    def exp(self, d, norel=False):
+        r = self.r
+        x = r.random()
+        if d <= 0 or x < 0.3:
+            y = r.random()
+            if y < 0.4 or not self.vars:
+                return str(r.randint(0, 30))
+            if y < 0.7:
+                return r.choice(self.vars)
+            if y < 0.85 and self.arrs:
+                return '%s[%s]' % (r.choice(self.arrs), self.index())
+            c = self.call() if self.depth < 6 else None
+            return c or r.choice(self.vars)
+        if x < 0.45 and not norel:
+            return '(%s %s %s)' % (self.exp(d - 1, True), r.choice(RELOPS),
+                                   self.exp(d - 1, True))
+        if x < 0.55:
+            return '%s / %s' % (self.term(d - 1),
+                                r.choice(['1', '2', '3', '(0 - 4)', '7']))
+        op = r.choice(['+', '-', '*', '+', '-'])
+        return '%s %s %s' % (self.exp(d - 1, True), op, self.term(d - 1))
+
+    def term(self, d):
+        e = self.exp(d, True)
+        return e if e.replace('-', '').isalnum() else '(%s)' % e
+
+
+STOPS = re.compile(r'^(Halted|Instruction Memory Fault|Data Memory Fault|'
+                   r'Division by 0)|(Location too large)', re.M)
+
+
+def run(comp, opts, src, work, tm):
+    """compiles src in work and runs it: (outputs, stop, executed, size)"""
+    os.makedirs(work, exist_ok=True)
+    with open(os.path.join(work, 'p.cm'), 'w') as f:
+        f.write(src)
+    code = os.path.join(work, 'p_gen.tm')
+    if os.path.exists(code):
+        os.remove(code)
+    try:
+        subprocess.run([comp, 'p.cm', './'] + opts, cwd=work, timeout=20,
+                       stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+        text = open(code).read() if os.path.exists(code) else ''
+        res = subprocess.run([tm, code], input='p\ng\nq\n', timeout=20,
+                             capture_output=True, text=True,
+                             errors='replace').stdout
+    except subprocess.TimeoutExpired:
+        return None
+    size = len(re.findall(r'^ *\d+:', text, re.M))
+    outs = re.findall(r'OUT instruction prints: (-?\d+)', res)
+    stop = STOPS.search(res)
+    executed = re.search(r'instructions executed = (\d+)', res)
+    return (outs, stop.group(stop.lastindex) if stop else None,
+            int(executed.group(1)) if executed else 0, size)
+
+
+def main(argv):
+    if len(argv) == 2 and argv[0] == '-print':
+        sys.stdout.write(Gen(int(argv[1])).program())
+        return 0
+    opts = []
+    if '--' in argv:
+        opts = argv[argv.index('--') + 1:]
+        argv = argv[:argv.index('--')]
+    if len(argv) < 2:
+        sys.stderr.write(__doc__)
+        return 2
+    ref, new = os.path.abspath(argv[0]), os.path.abspath(argv[1])
+    seed, count = 1, 150
+    tm = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'tm')
+    for i in range(2, len(argv) - 1, 2):
+        if argv[i] == '-seed':
+            seed = int(argv[i + 1])
+        elif argv[i] == '-n':
+            count = int(argv[i + 1])
+        elif argv[i] == '-tm':
+            tm = os.path.abspath(argv[i + 1])
+    work = tempfile.mkdtemp(prefix='fuzz')
+    bad = skipped = large = 0
+    totals = [0, 0, 0, 0]
+    try:
+        for s in range(seed, seed + count):
+            src = Gen(s).program()
+            a = run(ref, [], src, os.path.join(work, 'a'), tm)
+            b = run(new, opts, src, os.path.join(work, 'b'), tm)
+            if a is None or a[1] in (None, 'Location too large'):
+                # the reference loops or does not fit in tm
+                skipped += 1
+                continue
+            if b is not None and b[1] == 'Location too large':
+                large += 1
+                print('seed %d: the code of NEW does not fit in tm' % s)
+                continue
+            if b is None or a[:2] != b[:2]:
+                bad += 1
+                with open('fuzz_%d.cm' % s, 'w') as f:
+                    f.write(src)
+                print('seed %d: runs differ, kept as fuzz_%d.cm' % (s, s))
+                continue
+            totals = [totals[0] + a[2], totals[1] + b[2],
+                      totals[2] + a[3], totals[3] + b[3]]
+    finally:
+        shutil.rmtree(work)
+    print('programs %d differing %d skipped %d too large %d' %
+          (count, bad, skipped, large))
+    print('executed: ref %d new %d   code: ref %d new %d' % tuple(totals))
+    return 1 if bad else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
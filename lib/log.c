@@ -26,6 +26,19 @@ FileDestination currentState;
 void splitFileName(const char *fullFileName, char *path, char *fileName,
                    char *extension);
 
+/// when set, pc/pce/pp of the calling thread append to it instead of printing
+static _Thread_local LogCapture *capture;
+
+/// kind of a captured record: pc, pce, or the destination given to pp
+#define LOG_PC (-1)
+#define LOG_PCE (-2)
+typedef struct {
+  int kind;
+  size_t len;
+} LogRecordHead;
+
+static void record(int kind, const char *buffer, size_t n);
+
 /**
  * \brief open the files specified by files2open in the directory specified by
  * path, with the basename specified
@@ -119,6 +132,13 @@ void doneLEXstartSYN() { currentState = SYN; }
 void doneSYNstartTAB() { currentState = TAB; }
 /// sets the curent compilation stage to GEN (code generation)
 void doneTABstartGEN() { currentState = GEN; }
+/// sets the current compilation stage and returns the one it replaces, for a
+/// compiler that takes each declaration through all the stages in turn
+FileDestination logStage(FileDestination stage) {
+  FileDestination previous = currentState;
+  currentState = stage;
+  return previous;
+}
 
 /// flushes all opened files.
 void fflushc() {
@@ -162,6 +182,11 @@ void pc(const char *format, ...) {
   va_list args;
   va_start(args, format);
   vsprintf(buffer, format, args);
+  va_end(args);
+  if (capture != NULL) {
+    record(LOG_PC, buffer, strlen(buffer));
+    return;
+  }
 
   if (currentState & ER_ & filesOpened)
     fprintf(fileER_, "%s", buffer);
@@ -175,13 +200,45 @@ void pc(const char *format, ...) {
     fprintf(fileGEN, "%s", buffer);
 
   fprintf(stdout, "%s", buffer);
-  va_end(args);
 
   if (DEBUG_LOG_ALWAYS_FLUSH)
     fflushc(); /// flushes all output files. INNEFICIENT, ONLY FOR DEBUG!
 
 } // pc
 
+/**
+ * \brief prints text as is in CURRENT output file AND stdout, like pc
+ *
+ * * unlike pc, text is not a format and may be of any length; use it to
+ * write output already formatted into a buffer in one call.
+ *
+ * \param text NUL-terminated text to print
+ *
+ * \par flushes if DEBUG_LOG_ALWAYS_FLUSH is set
+ */
+void pcs(const char *text) {
+  if (capture != NULL) {
+    record(LOG_PC, text, strlen(text));
+    return;
+  }
+
+  if (currentState & ER_ & filesOpened)
+    fputs(text, fileER_);
+  if (currentState & LEX & filesOpened)
+    fputs(text, fileLEX);
+  if (currentState & SYN & filesOpened)
+    fputs(text, fileSYN);
+  if (currentState & TAB & filesOpened)
+    fputs(text, fileTAB);
+  if (currentState & GEN & filesOpened)
+    fputs(text, fileGEN);
+
+  fputs(text, stdout);
+
+  if (DEBUG_LOG_ALWAYS_FLUSH)
+    fflushc(); /// flushes all output files. INNEFICIENT, ONLY FOR DEBUG!
+} // pcs
+
 /**
  * \brief prints in CURRENT output file AND stdout AND error file (3-way)
  *
@@ -209,6 +266,11 @@ void pce(const char *format, ...) {
   va_list args;
   va_start(args, format);
   vsprintf(buffer, format, args);
+  va_end(args);
+  if (capture != NULL) {
+    record(LOG_PCE, buffer, strlen(buffer));
+    return;
+  }
 
   if (currentState & LEX & filesOpened)
     fprintf(fileLEX, "%s", buffer);
@@ -223,7 +285,6 @@ void pce(const char *format, ...) {
     fprintf(fileER_, "%s", buffer);
 
   fprintf(stdout, "%s", buffer);
-  va_end(args);
 
   if (DEBUG_LOG_ALWAYS_FLUSH)
     fflushc(); /// flushes all output files. INNEFICIENT, ONLY FOR DEBUG!
@@ -265,6 +326,11 @@ void pp(FileDestination destination, const char *format, ...) {
   va_list args;
   va_start(args, format);
   vsprintf(buffer, format, args);
+  va_end(args);
+  if (capture != NULL) {
+    record(destination, buffer, strlen(buffer));
+    return;
+  }
 
   if (destination & ER_ & filesOpened)
     fprintf(fileER_, "%s", buffer);
@@ -278,12 +344,115 @@ void pp(FileDestination destination, const char *format, ...) {
     fprintf(fileGEN, "%s", buffer);
 
   fprintf(stdout, "%s", buffer);
-  va_end(args);
 
   if (DEBUG_LOG_ALWAYS_FLUSH)
     fflushc(); /// flushes all output files. INNEFICIENT, ONLY FOR DEBUG!
 } // pp
 
+/// makes room for n more bytes at the end of the capture
+static void reserve(size_t n) {
+  if (capture->len + n > capture->cap) {
+    size_t cap = capture->cap ? capture->cap : 4096;
+    while (capture->len + n > cap)
+      cap *= 2;
+    capture->text = (char *)realloc(capture->text, cap);
+    if (capture->text == NULL) {
+      fprintf(stderr, "out of memory capturing output");
+      abort();
+    }
+    capture->cap = cap;
+  }
+}
+
+/// appends the n bytes of buffer to the capture; text of the same kind as the
+/// last record joins that record, so a replay writes it in one go
+static void record(int kind, const char *buffer, size_t n) {
+  LogRecordHead *head;
+  if (capture->len == 0 ||
+      ((LogRecordHead *)(capture->text + capture->last))->kind != kind) {
+    size_t at = (capture->len + sizeof(LogRecordHead) - 1) /
+                sizeof(LogRecordHead) * sizeof(LogRecordHead);
+    reserve(at - capture->len + sizeof(LogRecordHead) + n);
+    head = (LogRecordHead *)(capture->text + at);
+    head->kind = kind;
+    head->len = 0;
+    capture->last = at;
+    capture->len = at + sizeof(LogRecordHead);
+  } else
+    reserve(n);
+  memcpy(capture->text + capture->len, buffer, n);
+  capture->len += n;
+  ((LogRecordHead *)(capture->text + capture->last))->len += n;
+}
+
+/**
+ * \brief makes pc, pce and pp called by this thread record their output into
+ * capture instead of printing it
+ *
+ * * lets a worker thread produce output that the main thread prints later, in
+ * the order of the source, with logReplay
+ */
+void logCaptureBegin(LogCapture *c) {
+  c->text = NULL;
+  c->len = c->cap = c->last = 0;
+  capture = c;
+}
+
+/// back to printing directly
+void logCaptureEnd() { capture = NULL; }
+
+/// records into a capture begun earlier again, after the text it holds (NULL
+/// prints directly); returns the capture that was in use
+LogCapture *logCaptureResume(LogCapture *c) {
+  LogCapture *previous = capture;
+  capture = c;
+  return previous;
+}
+
+/// writes captured output as if pc/pce/pp were being called now, so a thread
+/// that is capturing itself records it in turn
+void logReplay(const LogCapture *c) {
+  size_t at = 0;
+  while (at < c->len) {
+    const LogRecordHead *head = (const LogRecordHead *)(c->text + at);
+    const char *text = c->text + at + sizeof(LogRecordHead);
+    FileDestination dest;
+    if (head->kind == LOG_PC)
+      dest = currentState;
+    else if (head->kind == LOG_PCE)
+      dest = currentState | ER_;
+    else
+      dest = (FileDestination)head->kind;
+    if (capture != NULL)
+      record(head->kind, text, head->len);
+    else {
+      if (dest & ER_ & filesOpened)
+        fwrite(text, 1, head->len, fileER_);
+      if (dest & LEX & filesOpened)
+        fwrite(text, 1, head->len, fileLEX);
+      if (dest & SYN & filesOpened)
+        fwrite(text, 1, head->len, fileSYN);
+      if (dest & TAB & filesOpened)
+        fwrite(text, 1, head->len, fileTAB);
+      if (dest & GEN & filesOpened)
+        fwrite(text, 1, head->len, fileGEN);
+      fwrite(text, 1, head->len, stdout);
+    }
+    at += sizeof(LogRecordHead) + head->len;
+    at = (at + sizeof(LogRecordHead) - 1) / sizeof(LogRecordHead) *
+         sizeof(LogRecordHead);
+  }
+  if (capture == NULL)
+    fflushc();
+}
+
+/// frees the memory held by a capture
+void logCaptureFree(LogCapture *c) {
+  free(c->text);
+  c->text = NULL;
+  c->len = c->cap = c->last = 0;
+}
+
 /**
  * \brief aux func: split fullFileName (with full path) into
  * path/fileName/extension
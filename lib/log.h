@@ -1,6 +1,8 @@
 #ifndef VARIABLEPRINTER_H
 #define VARIABLEPRINTER_H
 
+#include <stddef.h>
+
 
 /// bitmask to select output files
 typedef enum fileDestination {
@@ -35,10 +37,26 @@ void pp(FileDestination destination, const char* format, ...);
 void doneLEXstartSYN() ;
 void doneSYNstartTAB() ;
 void doneTABstartGEN() ;
+FileDestination logStage(FileDestination stage);
 void pc(const char* format, ...) ;
 void pce(const char* format, ...) ;
+void pcs(const char* text) ;
 void fflushc();
 
+/// output of pc/pce/pp recorded by a thread instead of printed
+typedef struct logCapture {
+    char *text;  ///< records, each a header followed by its bytes
+    size_t len;
+    size_t cap;
+    size_t last; ///< offset of the last record's header, if len > 0
+} LogCapture;
+
+void logCaptureBegin(LogCapture *capture);
+void logCaptureEnd();
+LogCapture *logCaptureResume(LogCapture *capture);
+void logReplay(const LogCapture *capture);
+void logCaptureFree(LogCapture *capture);
+
 void closePrinter();
 
 #endif  // VARIABLEPRINTER_H
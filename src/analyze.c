@@ -7,242 +7,154 @@
 /****************************************************/
 
 #include "analyze.h"
+#include "../build/parser.h"
+#include "ast.h"
 #include "globals.h"
 #include "symtab.h"
+#include "util.h"
 
-static int memloc = 0;
-static int sizeOfVars = 0;
-
-
- char **getScopePrefixes(const char *scopeName, int *count) {
-  // Split input like "A-B-C" into ["", "A", "A-B", "A-B-C"]
-  // Always start result with "" (the global scope)
-  // *count will be set to the result array length
-
-  if (!scopeName || !count)
-    return NULL;
-
-  // Upper bound: at most strlen(scopeName)+2 items ("" plus each '-' piece)
-  int len = strlen(scopeName);
-  int maxParts = len + 2;
-  char **result = (char **)malloc(maxParts * sizeof(char *));
-  int n = 0;
-
-  // Always add the global scope
-  result[n++] = strdup("");
-
-  if (len == 0) {
-    *count = n;
-    return result;
-  }
-
-  // Work through scopeName and add each prefix
-  char *buf = (char *)malloc(len + 1);
-  int buflen = 0;
-  for (int i = 0; i < len; ++i) {
-    buf[buflen++] = scopeName[i];
-    buf[buflen] = '\0';
-    if (scopeName[i] == '-') {
-      // Add up to, but not including this '-'
-      if (buflen > 1) {
-        char tmp = buf[buflen - 1];
-        buf[buflen - 1] = '\0';
-        result[n++] = strdup(buf);
-        buf[buflen - 1] = tmp;
-      }
-    }
-  }
-  // Add the full scopeName last
-  result[n++] = strdup(scopeName);
-
-  free(buf);
-  *count = n;
-  return result;
-}
-
- void freeScopeList(scopeList scope) {
-  if (scope == NULL) {
-    return;
-  }
-
-  // Free the next nodes first (recursive)
-  if (scope->next != NULL) {
-    freeScopeList(scope->next);
-  }
-
-  // Free dynamically allocated strings (only if they were strdup'd)
-  if (scope->name != NULL && strcmp(scope->name, "") != 0) {
-    free(scope->name);
-  }
-  if (scope->type != NULL && strcmp(scope->type, "") != 0) {
-    free(scope->type);
-  }
-
-  // Free the node itself
-  free(scope);
-}
+/* the state below belongs to the declaration being
+ * visited, so that panalyze.c can visit functions on
+ * several threads at once
+ */
+static _Thread_local int memloc = 0;
+static _Thread_local int sizeOfVars = 0;
 
- scopeList deepCopyScopeList(scopeList source) {
-  if (source == NULL) {
-    return NULL;
-  }
+/* record of the function whose body is being visited */
+static _Thread_local BucketList currentFunction = NULL;
 
-  // Allocate new scope node
-  scopeList copy = (scopeList)malloc(sizeof(struct scopeListRec));
-
-  // Deep copy strings (avoid sharing pointers)
-  copy->name = (source->name != NULL) ? strdup(source->name) : NULL;
-  copy->type = (source->type != NULL) ? strdup(source->type) : NULL;
-
-  // Copy scalar value
-  copy->depth = source->depth;
-
-  // Recursively deep copy the linked list
-  copy->next = deepCopyScopeList(source->next);
-
-  // Handle 'end' pointer - need to find the equivalent node in the new list
-  if (source->end == NULL) {
-    copy->end = NULL;
-  } else if (source->end == source) {
-    // If end points to itself
-    copy->end = copy;
-  } else {
-    // Find which node 'end' points to and set copy->end to the equivalent
-    // For simplicity, traverse to find the same depth/name
-    scopeList temp = copy;
-    scopeList sourceTemp = source;
-    while (sourceTemp != NULL && sourceTemp != source->end) {
-      sourceTemp = sourceTemp->next;
-      if (temp != NULL)
-        temp = temp->next;
-    }
-    copy->end = temp;
-  }
+/* where the frames of scope lists are allocated */
+static _Thread_local Arena *frameArena = &scratchArena;
 
-  return copy;
-}
 
  scopeList getInitialScopeList() {
-  scopeList initialScope = (scopeList)malloc(sizeof(struct scopeListRec));
-  initialScope->type = "global";
-  initialScope->depth = 0;
-  initialScope->name = "";
-  initialScope->next = NULL;
-  initialScope->end = initialScope;
-  return initialScope;
+  return pushScope(NULL, "", GlobalScope, 0, GLOBAL_SCOPE);
 }
 
- scopeList buildScopeList(char *name, char *type, int depth) {
-  scopeList newScope = (scopeList)malloc(sizeof(struct scopeListRec));
+/* Function pushScope returns the chain outer with one
+ * more frame; outer itself is left as it was
+ */
+ scopeList pushScope(scopeList outer, char *name, ScopeKind kind, int depth,
+                     ScopeId scope) {
+  scopeList newScope =
+      (scopeList)arenaAlloc(frameArena, sizeof(struct scopeListRec));
   newScope->name = (name != NULL) ? name : "";
-  newScope->type = (type != NULL) ? type : "";
+  newScope->kind = kind;
+  newScope->scope = scope;
   newScope->depth = depth;
-  newScope->next = NULL;
-  newScope->end = NULL;
+  newScope->outer = outer;
   return newScope;
 }
 
- char *constructScopeName(scopeList currentScopeList) {
-  char *scopeName = (char *)malloc(256 * sizeof(char));
-  scopeName[0] = '\0';
-  int currentDepth = 0;
-  scopeList temp = currentScopeList;
-  while (temp != NULL) {
-    if (temp->depth == currentDepth) {
-      if (currentDepth >= 2) {
-        strcat(scopeName, "-");
-      }
-      strcat(scopeName, temp->name);
-      currentDepth += 1;
+/* scopeKindOf gives the kind of scope a node opens */
+static ScopeKind scopeKindOf(TreeNode *t) {
+  if (t->nodekind == StmtK) {
+    switch (t->kind.stmt) {
+    case IfK:
+      return IfScope;
+    case WhileK:
+      return WhileScope;
+    case CompoundK:
+      return BlockScope;
+    default:
+      break;
     }
-    temp = temp->next;
+  } else if (t->nodekind == DeclK && t->kind.decl == FunDeclK)
+    return FunScope;
+  return GlobalScope;
+}
+
+/* scopeKindName is the name a nested block takes
+ * after the construct that encloses it
+ */
+static char *scopeKindName(ScopeKind kind) {
+  switch (kind) {
+  case IfScope:
+    return "if";
+  case WhileScope:
+    return "while";
+  case BlockScope:
+    return "block";
+  default:
+    return "";
   }
-  return scopeName;
 }
 
  scopeList getCurrentScopeList(scopeList initialScopeList, TreeNode *t) {
   if (initialScopeList == NULL || t == NULL) {
     return NULL;
   }
-  int initialDepth = initialScopeList->end->depth;
-  char *initialName = initialScopeList->end->name;
-  // char *initialName = constructScopeName(initialScopeList);
-  scopeList currentScope = buildScopeList(t->attr.name, t->type, initialDepth);
-
-  scopeList copyOfInitialScopeList = deepCopyScopeList(initialScopeList);
-  switch (t->nodekind) {
-  case StmtK:
-    switch (t->kind.stmt) {
-    case IfK:
-      copyOfInitialScopeList->end = currentScope;
-      scopeList temp = copyOfInitialScopeList;
-      while (temp->next != NULL) {
-        temp = temp->next;
-      }
-      temp->next = currentScope;
-      currentScope->name = initialName;
-      // currentScope->depth = initialDepth + 1;
-      return copyOfInitialScopeList;
-    case WhileK:
-      copyOfInitialScopeList->end = currentScope;
-      scopeList tempWhile = copyOfInitialScopeList;
-      while (tempWhile->next != NULL) {
-        tempWhile = tempWhile->next;
-      }
-      tempWhile->next = currentScope;
-      currentScope->name = initialName;
-      // currentScope->depth = initialDepth + 1;
-      return copyOfInitialScopeList;
-    case CompoundK: {
-      char *initialScopeType = initialScopeList->end->type;
-      if (initialScopeList->end->type != NULL &&
-          (strcmp(initialScopeType, "block") == 0) || (strcmp(initialScopeType, "while") == 0) || (strcmp(initialScopeType, "if") == 0)) {
-        scopeList temp = copyOfInitialScopeList;
-        while (temp->next != NULL) {
-          temp = temp->next;
-        }
-        temp->next = currentScope;
-        copyOfInitialScopeList->end = currentScope;
-        copyOfInitialScopeList->end->name = initialScopeType;
-        currentScope->depth = initialDepth + 1;
-        return copyOfInitialScopeList;
-      } else {
-        copyOfInitialScopeList->end = currentScope;
-        scopeList temp = copyOfInitialScopeList;
-        while (temp->next != NULL) {
-          temp = temp->next;
-        }
-        temp->next = currentScope;
-        currentScope->name = initialName;
-        currentScope->depth = initialDepth;
-        return copyOfInitialScopeList;
-      }
+  scopeList outer = initialScopeList;
+  ScopeKind kind = scopeKindOf(t);
+  switch (kind) {
+  case IfScope:
+  case WhileScope:
+    return pushScope(outer, outer->name, kind, outer->depth, outer->scope);
+  case BlockScope:
+    /* a function body stays in the function's scope; a block
+     * nested in another statement opens a scope named after it
+     */
+    if (outer->kind == BlockScope || outer->kind == WhileScope ||
+        outer->kind == IfScope) {
+      char *name = scopeKindName(outer->kind);
+      return pushScope(outer, name, kind, outer->depth + 1,
+                       st_scope(outer->scope, name));
     }
-    default:
+    return pushScope(outer, outer->name, kind, outer->depth, outer->scope);
+  case FunScope:
+    return pushScope(outer, t->attr.name, kind, outer->depth + 1,
+                     st_scope(outer->scope, t->attr.name));
+  default:
+    return initialScopeList;
+  }
+}
+
+/* Function symbolType returns the type of the value
+ * of the symbol l; Integer for an unbound use, whose
+ * error has been reported when it was bound
+ */
+static ExpType symbolType(BucketList l) {
+  if (l != NULL && l->expType == Void)
+    return Void;
+  return Integer;
+}
+
+/* Procedure inferType sets the type of the expression
+ * t from its operator, or from the symbol it is bound
+ * to; relational operators give Boolean. Run in
+ * postorder, so the operands are typed already.
+ */
+static void inferType(TreeNode *t) {
+  if (t->nodekind != ExpK)
+    return;
+  switch (t->kind.exp) {
+  case ConstK:
+    t->type = Integer;
+    break;
+  case OpK:
+    switch (t->attr.op) {
+    case LT:
+    case LTE:
+    case GT:
+    case GTE:
+    case EQQ:
+    case NEQ:
+      t->type = Boolean;
       break;
-    }
-  case DeclK:
-    switch (t->kind.decl) {
-    case FunDeclK:
-      copyOfInitialScopeList->end = currentScope;
-      scopeList temp = copyOfInitialScopeList;
-      while (temp->next != NULL) {
-        temp = temp->next;
-      }
-      temp->next = currentScope;
-      currentScope->depth = initialDepth + 1;
-      return copyOfInitialScopeList;
     default:
+      t->type = Integer;
       break;
     }
     break;
+  case IdK:
+  case VarK:
+  case AssignK:
+  case CallK:
+    t->type = symbolType(t->symbol);
+    break;
   default:
-    free(currentScope);
-    return initialScopeList;
     break;
-}
-free(currentScope);
-return initialScopeList;
+  }
 }
 
 static void postAddSizeofVars(TreeNode *t, scopeList currentScopeList) {
@@ -250,7 +162,7 @@ static void postAddSizeofVars(TreeNode *t, scopeList currentScopeList) {
     case DeclK:
     switch (t->kind.decl) {
     case FunDeclK: {
-      addSizeOfVars(t->attr.name, sizeOfVars);
+      t->symbol->sizeOfVars += sizeOfVars;
       break;
     }
     default:
@@ -260,30 +172,53 @@ static void postAddSizeofVars(TreeNode *t, scopeList currentScopeList) {
   }
 }
 
+/* Procedure postInsertNode is the postorder half of
+ * buildSymtab: it types the expression t and closes
+ * the frame of a function
+ */
+static void postInsertNode(TreeNode *t, scopeList currentScopeList) {
+  inferType(t);
+  postAddSizeofVars(t, currentScopeList);
+}
+
+static void traverse(uint32_t i, void (*preProc)(TreeNode *, scopeList),
+                     void (*postProc)(TreeNode *, scopeList),
+                     scopeList initialScopeList);
+
+/* Procedure visit applies preProc and postProc to
+ * the node i of compactAst and its subtrees, but not
+ * to its siblings
+ */
+static void visit(uint32_t i, void (*preProc)(TreeNode *, scopeList),
+                  void (*postProc)(TreeNode *, scopeList),
+                  scopeList initialScopeList) {
+  TreeNode *t = compactAst.tree[i];
+  /* everything the visit puts in frameArena dies with it */
+  ArenaMark mark = arenaMark(frameArena);
+  preProc(t, initialScopeList);
+  scopeList currentScopeList = getCurrentScopeList(initialScopeList, t);
+  if (currentScopeList == NULL) {
+    currentScopeList = initialScopeList;
+  }
+  traverse(compactAst.nodes[i].firstChild, preProc, postProc,
+           currentScopeList);
+  postProc(t, currentScopeList);
+  arenaRelease(frameArena, mark);
+}
+
 /* Procedure traverse is a generic recursive
  * syntax tree traversal routine:
  * it applies preProc in preorder and postProc
- * in postorder to tree pointed to by t
+ * in postorder to the tree whose first node is
+ * i in compactAst. Siblings are followed in a loop
+ * and the children of every slot form one chain,
+ * so the walk reads compactAst.nodes front to back.
  */
-static void traverse(TreeNode *t, void (*preProc)(TreeNode *, scopeList),
+static void traverse(uint32_t i, void (*preProc)(TreeNode *, scopeList),
                      void (*postProc)(TreeNode *, scopeList),
                      scopeList initialScopeList) {
-  if (t != NULL) {
-
-    preProc(t, initialScopeList);
-    scopeList currentScopeList = getCurrentScopeList(initialScopeList, t);
-    if (currentScopeList == NULL) {
-      currentScopeList = initialScopeList;
-    }
-    {
-      int i;
-      for (i = 0; i < MAXCHILDREN; i++) {
-        traverse(t->child[i], preProc, postProc, currentScopeList);
-      }
-    }
-    postProc(t, currentScopeList);
-    traverse(t->sibling, preProc, postProc, initialScopeList);
-  }
+  for (; i != AST_NIL; i = compactAst.nodes[i].nextSibling)
+    visit(i, preProc, postProc, initialScopeList);
 }
 
 /* nullProc is a do-nothing procedure to
@@ -297,61 +232,14 @@ static void nullProc(TreeNode *t, scopeList currentScopeList) {
     return;
 }
 
-static char *checkAllPossibleScopes(TreeNode *t, scopeList currentScopeList) {
-  int count;
-  char **scopePrefixes =
-      getScopePrefixes(constructScopeName(currentScopeList), &count);
-  char *possibleScope = NULL;
-  for (int i = 0; i < count; i++) {
-    if (st_lookup(t->attr.name, scopePrefixes[i]) != -1) {
-      possibleScope = scopePrefixes[i];
-    }
-  }
-  // copy possibleScope to a new string
-  if (possibleScope == NULL) {
-    return NULL;
-  }
-  char *possibleScopeCopy = (char *)malloc(strlen(possibleScope) + 1);
-  strcpy(possibleScopeCopy, possibleScope);
-  for (int i = 0; i < count; i++) {
-    free(scopePrefixes[i]);
-  }
-  free(scopePrefixes);
-  return possibleScopeCopy;
-}
-
-char *returnMostSpecificScopeName(scopeList currentScopeList,
-                                         TreeNode *t) {
-  int count;
-  char **scopePrefixes =
-      getScopePrefixes(constructScopeName(currentScopeList), &count);
-  char *mostSpecificScopeName = NULL;
-  for (int i = 0; i < count; i++) {
-    if (st_lookup(t->attr.name, scopePrefixes[i]) != -1) {
-      mostSpecificScopeName = scopePrefixes[i];
-    }
-  }
-  if (mostSpecificScopeName == NULL) {
-    return NULL;
-  }
-  // copy mostSpecificScopeName to a new string
-  char *mostSpecificScopeNameCopy =
-      (char *)malloc(strlen(mostSpecificScopeName) + 1);
-  strcpy(mostSpecificScopeNameCopy, mostSpecificScopeName);
-
-  for (int i = 0; i < count; i++) {
-    free(scopePrefixes[i]);
-  }
-  free(scopePrefixes);
-  return mostSpecificScopeNameCopy;
-}
-
 /* Procedure insertNode inserts
  * identifiers stored in t into
- * the symbol table
+ * the symbol table, and binds each
+ * use of an identifier (t->symbol) to
+ * the declaration it refers to here
  */
 static void insertNode(TreeNode *t, scopeList currentScopeList) {
-  char *scopeName = constructScopeName(currentScopeList);
+  ScopeId scope = currentScopeList->scope;
   switch (t->nodekind) {
   case StmtK:
     switch (t->kind.stmt) {
@@ -362,6 +250,7 @@ static void insertNode(TreeNode *t, scopeList currentScopeList) {
     case CompoundK:
       break;
     case ReturnK:
+      t->symbol = currentFunction;
       break;
     default:
       break;
@@ -373,48 +262,32 @@ static void insertNode(TreeNode *t, scopeList currentScopeList) {
       break;
     case ConstK:
       break;
-    case IdK:
-      break;
-    case AssignK: {
-      char *possibleScopeName = checkAllPossibleScopes(t, currentScopeList);
-      char *mostSpecificScopeName =
-          returnMostSpecificScopeName(currentScopeList, t);
-
-      if (possibleScopeName == NULL) {
-        char *message = (char *)malloc(256 * sizeof(char));
-        sprintf(message, "'%s' was not declared in this scope", t->attr.name);
-        semanticError(t, message);
-        free(message);
-      } else {
-        st_insert(t->attr.name, t->lineno, t->isArray ? "array" : "var",
-                  t->type, mostSpecificScopeName, currentScopeList->end->depth, 0);
-      }
-      break;
-    }
+    case AssignK:
     case CallK: {
-      char *possibleScopeName = checkAllPossibleScopes(t, currentScopeList);
-      char *mostSpecificScopeName =
-          returnMostSpecificScopeName(currentScopeList, t);
+      BucketList l = st_resolve(t->attr.name, scope);
 
-      if (possibleScopeName == NULL) {
+      if (l == NULL) {
         char *message = (char *)malloc(256 * sizeof(char));
         sprintf(message, "'%s' was not declared in this scope", t->attr.name);
         semanticError(t, message);
         free(message);
       } else {
-        st_just_add_lines(t->attr.name, t->lineno, mostSpecificScopeName);
+        st_add_line(l, t->lineno);
       }
+      t->symbol = l;
       break;
     }
+    case IdK:
     case VarK: {
-      char *mostSpecificScopeName =
-          returnMostSpecificScopeName(currentScopeList, t);
-      if (isThereVariableAtSameLine(t->attr.name, t->lineno,
-                                    mostSpecificScopeName)) {
-      } else {
-        st_insert(t->attr.name, t->lineno, t->isArray ? "array" : "var",
-                  t->type, mostSpecificScopeName, currentScopeList->end->depth, 0);
-      }
+      BucketList l = st_resolve(t->attr.name, scope);
+      if (l == NULL) /* undeclared: listed once, with no scope */
+        l = st_lookup_bucket(t->attr.name, NO_SCOPE);
+      if (l == NULL) /* with no memory location, as st_lookup gives */
+        l = st_insert(t->attr.name, t->lineno, t->isArray ? "array" : "var",
+                      typeName(t->type), NO_SCOPE, -1);
+      else
+        st_add_line_once(l, t->lineno);
+      t->symbol = l;
       break;
     }
     case TypeSpecK:
@@ -426,7 +299,7 @@ static void insertNode(TreeNode *t, scopeList currentScopeList) {
   case DeclK:
     switch (t->kind.decl) {
     case VarDeclK: {
-      if (strcmp(t->type, "void") == 0) {
+      if (t->type == Void) {
         semanticError(t, "variable declared void");
 
       } else if (isThereFunction(t->attr.name)) {
@@ -437,9 +310,9 @@ static void insertNode(TreeNode *t, scopeList currentScopeList) {
         free(message);
       } else {
         if (t->isArray) {
-          if (st_lookup(t->attr.name, scopeName) == -1) {
-            st_insert(t->attr.name, t->lineno, "array", t->type, scopeName,
-                      currentScopeList->end->depth,memloc);
+          if (st_lookup(t->attr.name, scope) == -1) {
+            t->symbol = st_insert(t->attr.name, t->lineno, "array",
+                                  typeName(t->type), scope, memloc);
           memloc+= t->child[0]->attr.val;
           sizeOfVars+= t->child[0]->attr.val;
             }
@@ -451,9 +324,9 @@ static void insertNode(TreeNode *t, scopeList currentScopeList) {
             free(message);
           }
         } else {
-          if (st_lookup(t->attr.name, scopeName) == -1) {
-            st_insert(t->attr.name, t->lineno, "var", t->type, scopeName,
-                      currentScopeList->end->depth,memloc);
+          if (st_lookup(t->attr.name, scope) == -1) {
+            t->symbol = st_insert(t->attr.name, t->lineno, "var",
+                                  typeName(t->type), scope, memloc);
             memloc++;
             sizeOfVars++;
             }
@@ -469,19 +342,21 @@ static void insertNode(TreeNode *t, scopeList currentScopeList) {
       break;
     }
     case FunDeclK: {
-      if (st_lookup(t->attr.name, scopeName) == -1) {
-        st_insert(t->attr.name, t->lineno, "fun", t->typeReturn, scopeName,
-                  currentScopeList->end->depth,0);
+      BucketList l = st_lookup_bucket(t->attr.name, scope);
+      if (l == NULL) {
+        l = st_insert(t->attr.name, t->lineno, "fun", typeName(t->typeReturn),
+                      scope, 0);
                   memloc = 0;
                   sizeOfVars = 0;
         }
+      t->symbol = currentFunction = l;
       break;
     }
     case ParamK: {
-      if (st_lookup(t->attr.name, scopeName) == -1) {
-        st_insert(t->attr.name, t->lineno,
-                  t->isArray ? "param-array" : "param-var", t->type, scopeName,
-                  currentScopeList->end->depth,memloc);
+      if (st_lookup(t->attr.name, scope) == -1) {
+        t->symbol = st_insert(t->attr.name, t->lineno,
+                              t->isArray ? "param-array" : "param-var",
+                              typeName(t->type), scope, memloc);
           memloc++;
           sizeOfVars++;
         }
@@ -497,18 +372,19 @@ static void insertNode(TreeNode *t, scopeList currentScopeList) {
 }
 
 /* Function buildSymtab constructs the symbol
- * table by preorder traversal of the syntax tree
+ * table by preorder traversal of the syntax tree,
+ * typing the expressions in postorder
  */
 void buildSymtab(TreeNode *syntaxTree) {
-  st_insert("input", 0, "fun", "int", "", 0,0);
-  st_insert("output", 0, "fun", "void", "", 0,0);
+  st_insert("input", 0, "fun", "int", GLOBAL_SCOPE, 0);
+  st_insert("output", 0, "fun", "void", GLOBAL_SCOPE, 0);
   scopeList initialScopeList = getInitialScopeList();
-  traverse(syntaxTree, insertNode, postAddSizeofVars, initialScopeList);
+  traverse(syntaxTree ? syntaxTree->id : AST_NIL, insertNode,
+           postInsertNode, initialScopeList);
   if (TraceAnalyze) {
     pc("\nSymbol table:\n\n");
     printSymTab();
   }
-  free(initialScopeList);
 }
 
 static void typeError(TreeNode *t, char *message) {
@@ -522,7 +398,7 @@ void semanticError(TreeNode *t, char *message) {
 }
 
 void mainError() {
-  if (st_lookup("main", "") == -1) {
+  if (st_lookup("main", GLOBAL_SCOPE) == -1) {
     char *message = (char *)malloc(256 * sizeof(char));
     sprintf(message, "undefined reference to 'main'");
     pce("Semantic error: %s\n", message);
@@ -535,7 +411,6 @@ void mainError() {
  * type checking at a single tree node
  */
 static void checkNode(TreeNode *t, scopeList currentScopeList) {
-  char *scopeName = constructScopeName(currentScopeList);
   switch (t->nodekind) {
   case StmtK:
     switch (t->kind.stmt) {
@@ -546,30 +421,19 @@ static void checkNode(TreeNode *t, scopeList currentScopeList) {
     case CompoundK:
       break;
     case ReturnK:
-      if (t->type != NULL) {
-        if (strcmp(t->type, "void") == 0) {
-          char *dataType = getDataType(currentScopeList->end->name);
-          char *returnType = malloc(256 * sizeof(char));
-          if (t->child[0] != NULL) {
-            if (t->child[0]->kind.exp == ConstK) {
-              returnType = "int";
-            }
-            if (t->child[0]->kind.exp == VarK) {
-              returnType = getDataType(t->child[0]->attr.name);
-            }
-            if (t->child[0]->kind.exp == CallK) {
-              returnType = getDataType(t->child[0]->attr.name);
-            }
-            if (t->child[0]->kind.exp == OpK) {
-              returnType = "int";
-            }
-          } else {
-            returnType = "void";
-          }
-          if (strcmp(dataType, returnType) != 0) {
-            semanticError(t, "Must return same type as function declaration");
-            Error = TRUE;
-          }
+      if (t->type == Void) {
+        TreeNode *e = t->child[0];
+        ExpType returnType = Void;
+        if (e != NULL) {
+          /* an undeclared callee has been reported already */
+          if (e->kind.exp == CallK && e->symbol == NULL)
+            break;
+          /* a comparison returns its 0 or 1 as an int */
+          returnType = e->type == Boolean ? Integer : e->type;
+        }
+        if (returnType != symbolType(t->symbol)) {
+          semanticError(t, "Must return same type as function declaration");
+          Error = TRUE;
         }
       }
       break;
@@ -586,23 +450,12 @@ static void checkNode(TreeNode *t, scopeList currentScopeList) {
     case IdK:
       break;
     case AssignK: {
-      char *possibleScopeName = checkAllPossibleScopes(t, currentScopeList);
-      if (possibleScopeName == NULL) {
+      if (t->symbol == NULL) {
         break;
       } else {
-        if (t->isArray) {
-          if (t->child[1]->kind.exp != ConstK && t->child[1]->kind.exp != OpK &&
-              getDataType(t->child[1]->attr.name) != NULL &&
-              strcmp(getDataType(t->child[1]->attr.name), "void") == 0) {
-            semanticError(t, "invalid use of void expression");
-          }
-        } else {
-
-          if (t->child[0]->kind.exp != ConstK && t->child[0]->kind.exp != OpK &&
-              getDataType(t->child[0]->attr.name) != NULL &&
-              strcmp(getDataType(t->child[0]->attr.name), "void") == 0) {
-            semanticError(t, "invalid use of void expression");
-          }
+        TreeNode *value = t->isArray ? t->child[1] : t->child[0];
+        if (value->type == Void) {
+          semanticError(t, "invalid use of void expression");
         }
       }
       break;
@@ -641,6 +494,70 @@ static void checkNode(TreeNode *t, scopeList currentScopeList) {
  */
 void typeCheck(TreeNode *syntaxTree) {
   scopeList initialScopeList = getInitialScopeList();
-  traverse(syntaxTree, nullProc, checkNode, initialScopeList);
-  free(initialScopeList);
+  traverse(syntaxTree ? syntaxTree->id : AST_NIL, nullProc, checkNode,
+           initialScopeList);
+}
+
+/* type errors found by analyze, listed by
+ * reportTypeErrors
+ */
+static LogCapture typeErrors;
+
+/* where the type errors of this thread are recorded */
+static _Thread_local LogCapture *typeLog = &typeErrors;
+
+/* Procedure insertCheckNode ends the visit of t in
+ * the fused pass: the postorder half of buildSymtab,
+ * then checkNode with its output held back
+ */
+static void insertCheckNode(TreeNode *t, scopeList currentScopeList) {
+  postInsertNode(t, currentScopeList);
+  if (TraceAnalyze) {
+    LogCapture *outer = logCaptureResume(typeLog);
+    checkNode(t, currentScopeList);
+    logCaptureResume(outer);
+  }
+}
+
+/* Procedure analyze does the work of buildSymtab and
+ * typeCheck in one traversal of the syntax tree
+ */
+void analyze(TreeNode *syntaxTree) {
+  st_insert("input", 0, "fun", "int", GLOBAL_SCOPE, 0);
+  st_insert("output", 0, "fun", "void", GLOBAL_SCOPE, 0);
+  scopeList initialScopeList = getInitialScopeList();
+  traverse(syntaxTree ? syntaxTree->id : AST_NIL, insertNode, insertCheckNode,
+           initialScopeList);
+  if (TraceAnalyze) {
+    pc("\nSymbol table:\n\n");
+    printSymTab();
+  }
+}
+
+int analyzeDecl(TreeNode *t, int start, LogCapture *log, Arena *scratch) {
+  Arena *outerFrames = frameArena;
+  LogCapture *outerLog = typeLog;
+  frameArena = scratch;
+  typeLog = log;
+  memloc = start;
+  sizeOfVars = 0;
+  currentFunction = NULL;
+  visit(t->id, insertNode, insertCheckNode, getInitialScopeList());
+  frameArena = outerFrames;
+  typeLog = outerLog;
+  return memloc;
+}
+
+void deferTypeErrors(const LogCapture *log) {
+  LogCapture *outer = logCaptureResume(&typeErrors);
+  logReplay(log);
+  logCaptureResume(outer);
+}
+
+/* Procedure reportTypeErrors lists the type errors
+ * analyze found, where typeCheck would list them
+ */
+void reportTypeErrors(void) {
+  logReplay(&typeErrors);
+  logCaptureFree(&typeErrors);
 }
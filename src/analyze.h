@@ -21,24 +21,43 @@ void buildSymtab(TreeNode *);
  */
 void typeCheck(TreeNode *);
 
-/* Function semanticError reports semantic errors */
-void semanticError(TreeNode *, char *);
+/* Procedure analyze builds the symbol table and type
+ * checks the tree in a single traversal; the output
+ * is that of buildSymtab, and the type errors wait
+ * for reportTypeErrors
+ */
+void analyze(TreeNode *);
 
-void mainError();
+/* Procedure reportTypeErrors lists the type errors
+ * found by analyze, as typeCheck would have
+ */
+void reportTypeErrors(void);
+
+/* Function analyzeDecl does the work of analyze for
+ * the top-level declaration t alone, with the state
+ * of a fresh declaration: its variables are placed
+ * from memory location start, its type errors go to
+ * log and its scope frames to scratch. Returns the
+ * location after the last one it used. The thread
+ * may be working on a private table (panalyze.c).
+ */
+int analyzeDecl(TreeNode *t, int start, LogCapture *log, Arena *scratch);
 
-char **getScopePrefixes(const char *scopeName, int *count);
+/* Procedure deferTypeErrors appends the type errors
+ * in log to those reportTypeErrors lists
+ */
+void deferTypeErrors(const LogCapture *log);
 
-void freeScopeList(scopeList scope);
+/* Function semanticError reports semantic errors */
+void semanticError(TreeNode *, char *);
 
-scopeList deepCopyScopeList(scopeList source);
+void mainError();
 
 scopeList getInitialScopeList();
 
-scopeList buildScopeList(char *name, char *type, int depth);
-
-char *constructScopeName(scopeList currentScopeList);
+scopeList pushScope(scopeList outer, char *name, ScopeKind kind, int depth,
+                    ScopeId scope);
 
-char *returnMostSpecificScopeName(scopeList currentScopeList, TreeNode *t);
 
 scopeList getCurrentScopeList(scopeList initialScopeList, TreeNode *t);
 
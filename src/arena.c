@@ -0,0 +1,141 @@
+/****************************************************/
+/* File: arena.c                                    */
+/* Region (arena) allocator implementation          */
+/* for the C- compiler                              */
+/****************************************************/
+
+#include "arena.h"
+#include "../lib/log.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* every allocation is rounded up to this alignment */
+#define ARENA_ALIGN 8
+#define ALIGN_UP(n) (((n) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+
+Arena compileArena;
+Arena scratchArena;
+_Thread_local Arena *syntaxArena = &compileArena;
+
+void arenaInit(Arena *a, size_t blockSize) {
+  a->head = NULL;
+  a->spare = NULL;
+  a->blockSize = blockSize;
+  a->numAllocs = 0;
+  a->numBlocks = 0;
+  a->inUse = 0;
+  a->peakInUse = 0;
+}
+
+/* newBlock takes a block able to hold n bytes, reusing
+ * a spare one when it is big enough
+ */
+static ArenaBlock newBlock(Arena *a, size_t n) {
+  ArenaBlock b = a->spare;
+  if (b != NULL && b->size >= n) {
+    a->spare = b->next;
+  } else {
+    size_t size = n > a->blockSize ? n : a->blockSize;
+    b = (ArenaBlock)malloc(sizeof(struct ArenaBlockRec) + size);
+    if (b == NULL) {
+      pce("Out of memory error (arena)\n");
+      exit(1);
+    }
+    b->size = size;
+    a->numBlocks++;
+  }
+  b->used = 0;
+  b->next = a->head;
+  a->head = b;
+  return b;
+}
+
+void *arenaAlloc(Arena *a, size_t n) {
+  ArenaBlock b = a->head;
+  void *p;
+  n = ALIGN_UP(n);
+  if (b == NULL || b->size - b->used < n)
+    b = newBlock(a, n);
+  p = b->data + b->used;
+  b->used += n;
+  a->numAllocs++;
+  a->inUse += n;
+  if (a->inUse > a->peakInUse)
+    a->peakInUse = a->inUse;
+  return p;
+}
+
+void *arenaCalloc(Arena *a, size_t n) {
+  void *p = arenaAlloc(a, n);
+  memset(p, 0, n);
+  return p;
+}
+
+char *arenaStrdup(Arena *a, const char *s) {
+  size_t n;
+  char *t;
+  if (s == NULL)
+    return NULL;
+  n = strlen(s) + 1;
+  t = (char *)arenaAlloc(a, n);
+  memcpy(t, s, n);
+  return t;
+}
+
+ArenaMark arenaMark(Arena *a) {
+  ArenaMark m;
+  m.block = a->head;
+  m.used = a->head != NULL ? a->head->used : 0;
+  m.inUse = a->inUse;
+  return m;
+}
+
+void arenaRelease(Arena *a, ArenaMark m) {
+  /* blocks opened after the mark go back to the spare list */
+  while (a->head != m.block) {
+    ArenaBlock b = a->head;
+    a->head = b->next;
+    b->next = a->spare;
+    a->spare = b;
+  }
+  if (a->head != NULL)
+    a->head->used = m.used;
+  a->inUse = m.inUse;
+}
+
+void arenaReset(Arena *a) {
+  ArenaMark empty = {NULL, 0, 0};
+  arenaRelease(a, empty);
+}
+
+void arenaAdopt(Arena *a, Arena *from) {
+  ArenaBlock b;
+  if (from->head != NULL) {
+    /* the adopted blocks go behind the one being filled */
+    for (b = from->head; b->next != NULL; b = b->next)
+      ;
+    if (a->head == NULL)
+      a->head = from->head;
+    else {
+      b->next = a->head->next;
+      a->head->next = from->head;
+    }
+  }
+  a->numAllocs += from->numAllocs;
+  a->numBlocks += from->numBlocks;
+  a->inUse += from->inUse;
+  if (a->inUse > a->peakInUse)
+    a->peakInUse = a->inUse;
+  from->head = NULL;
+  from->inUse = 0;
+  arenaFree(from);
+}
+
+void arenaFree(Arena *a) {
+  ArenaBlock b;
+  arenaReset(a);
+  while ((b = a->spare) != NULL) {
+    a->spare = b->next;
+    free(b);
+  }
+}
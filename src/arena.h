@@ -0,0 +1,97 @@
+/****************************************************/
+/* File: arena.h                                    */
+/* Region (arena) allocator for the C- compiler     */
+/* Objects are bump-allocated out of large blocks   */
+/* and released all at once                         */
+/****************************************************/
+
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+#include <stddef.h>
+
+/* default size of each block requested from malloc */
+#define ARENA_BLOCK_SIZE (64 * 1024)
+
+typedef struct ArenaBlockRec {
+  struct ArenaBlockRec *next;
+  size_t size; /* usable bytes in data */
+  size_t used; /* bytes already handed out */
+  char data[];
+} *ArenaBlock;
+
+typedef struct ArenaRec {
+  ArenaBlock head;  /* block currently being filled */
+  ArenaBlock spare; /* released blocks kept for reuse */
+  size_t blockSize;
+  /* statistics */
+  long numAllocs;   /* number of arenaAlloc calls */
+  long numBlocks;   /* number of blocks obtained from malloc */
+  size_t inUse;     /* bytes currently handed out */
+  size_t peakInUse; /* high-water mark of inUse */
+} Arena;
+
+/* ArenaMark records a position that arenaRelease
+ * can later roll the arena back to
+ */
+typedef struct {
+  ArenaBlock block;
+  size_t used;
+  size_t inUse;
+} ArenaMark;
+
+/* compileArena lives for the whole compilation: AST
+ * nodes, identifier strings and symbol table records
+ */
+extern Arena compileArena;
+
+/* scratchArena holds per-phase temporaries (scope lists,
+ * scope names); it is reset between passes
+ */
+extern Arena scratchArena;
+
+/* syntaxArena is where the scanner and parser put tree
+ * nodes and names: compileArena, unless the calling
+ * thread parses a piece of the source on its own
+ */
+extern _Thread_local Arena *syntaxArena;
+
+/* Procedure arenaInit prepares an empty arena whose
+ * blocks have (at least) blockSize bytes
+ */
+void arenaInit(Arena *a, size_t blockSize);
+
+/* Function arenaAlloc returns n bytes of uninitialized
+ * storage owned by arena a
+ */
+void *arenaAlloc(Arena *a, size_t n);
+
+/* Function arenaCalloc returns n zeroed bytes */
+void *arenaCalloc(Arena *a, size_t n);
+
+/* Function arenaStrdup copies s into arena a;
+ * returns NULL if s is NULL
+ */
+char *arenaStrdup(Arena *a, const char *s);
+
+/* Function arenaMark / procedure arenaRelease free,
+ * in one step, everything allocated after the mark
+ */
+ArenaMark arenaMark(Arena *a);
+void arenaRelease(Arena *a, ArenaMark m);
+
+/* Procedure arenaReset releases every allocation but
+ * keeps the blocks around for the next phase
+ */
+void arenaReset(Arena *a);
+
+/* Procedure arenaAdopt moves every allocation of from
+ * into a, leaving from empty; a must not be released
+ * back to a mark taken before the adoption
+ */
+void arenaAdopt(Arena *a, Arena *from);
+
+/* Procedure arenaFree returns all blocks to malloc */
+void arenaFree(Arena *a);
+
+#endif
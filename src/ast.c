@@ -0,0 +1,78 @@
+/****************************************************/
+/* File: ast.c                                      */
+/* Compact, index-based layout of the syntax tree   */
+/* for the C- compiler                              */
+/****************************************************/
+
+#include "ast.h"
+
+AstTree compactAst;
+
+/* countNodes counts t, its siblings and all their
+ * descendants
+ */
+static uint32_t countNodes(TreeNode *t) {
+  uint32_t n = 0;
+  int i;
+  for (; t != NULL; t = t->sibling) {
+    n++;
+    for (i = 0; i < MAXCHILDREN; i++)
+      n += countNodes(t->child[i]);
+  }
+  return n;
+}
+
+/* layoutChain stores the sibling chain t in preorder and
+ * returns the index of its first node. *tail receives the
+ * index of its last node so chains can be concatenated.
+ */
+static uint32_t layoutChain(AstTree *ast, TreeNode *t, int slot,
+                            uint32_t *tail) {
+  uint32_t first = AST_NIL, prev = AST_NIL;
+  for (; t != NULL; t = t->sibling) {
+    uint32_t idx = ast->count++;
+    uint32_t lastChild = AST_NIL;
+    AstNode *n = &ast->nodes[idx];
+    int i;
+    n->nodekind = (uint8_t)t->nodekind;
+    n->kind = (uint8_t)t->kind.stmt;
+    n->slot = (uint8_t)slot;
+    n->flags = t->isArray ? AST_ARRAY : 0;
+    n->attr = 0;
+    if (t->nodekind == ExpK && t->kind.exp == OpK)
+      n->attr = t->attr.op;
+    else if (t->nodekind == ExpK && t->kind.exp == ConstK)
+      n->attr = t->attr.val;
+    n->firstChild = AST_NIL;
+    n->nextSibling = AST_NIL;
+    ast->tree[idx] = t;
+    t->id = idx;
+    if (prev == AST_NIL)
+      first = idx;
+    else
+      ast->nodes[prev].nextSibling = idx;
+    prev = idx;
+    for (i = 0; i < MAXCHILDREN; i++) {
+      uint32_t childTail;
+      uint32_t c = layoutChain(ast, t->child[i], i, &childTail);
+      if (c == AST_NIL)
+        continue;
+      if (lastChild == AST_NIL)
+        n->firstChild = c;
+      else
+        ast->nodes[lastChild].nextSibling = c;
+      lastChild = childTail;
+    }
+  }
+  *tail = prev;
+  return first;
+}
+
+void astBuild(AstTree *ast, TreeNode *root) {
+  uint32_t n = countNodes(root), tail;
+  /* the layout lives as long as the nodes it lists */
+  ast->nodes = (AstNode *)arenaAlloc(syntaxArena, n * sizeof(AstNode));
+  ast->tree = (TreeNode **)arenaAlloc(syntaxArena, n * sizeof(TreeNode *));
+  ast->count = 0;
+  layoutChain(ast, root, 0, &tail);
+}
@@ -0,0 +1,61 @@
+/****************************************************/
+/* File: ast.h                                      */
+/* Compact, index-based layout of the syntax tree   */
+/* for the C- compiler                              */
+/****************************************************/
+
+#ifndef _AST_H_
+#define _AST_H_
+
+#include "globals.h"
+#include <stdint.h>
+
+/* AST_NIL marks a missing child or sibling */
+#define AST_NIL UINT32_MAX
+
+/* values for AstNode.flags */
+#define AST_ARRAY 0x1
+
+/* AstNode packs the fields every traversal touches
+ * into 16 bytes. Nodes are stored in preorder, so a
+ * preorder walk reads the array front to back.
+ * The children of all slots form a single chain
+ * starting at firstChild; slot tells which child[]
+ * of the pointer tree a node came from.
+ */
+typedef struct {
+  uint8_t nodekind; /* NodeKind */
+  uint8_t kind;     /* StmtKind, ExpKind or DeclKind */
+  uint8_t slot;     /* child slot in the parent */
+  uint8_t flags;
+  int32_t attr;     /* operator token or constant value */
+  uint32_t firstChild;
+  uint32_t nextSibling;
+} AstNode;
+
+typedef struct {
+  AstNode *nodes;  /* hot records, in preorder */
+  TreeNode **tree; /* cold data: the TreeNode of each record */
+  uint32_t count;
+} AstTree;
+
+/* compactAst is the layout of the tree being compiled */
+extern AstTree compactAst;
+
+/* Procedure astBuild lays out the tree rooted at root
+ * (and its siblings) in ast and sets every TreeNode's id
+ */
+void astBuild(AstTree *ast, TreeNode *root);
+
+/* Function astNextInChain returns the sibling of node i
+ * in the pointer-tree sense: the next node of the same
+ * child slot, or AST_NIL
+ */
+static inline uint32_t astNextInChain(const AstTree *ast, uint32_t i) {
+  uint32_t next = ast->nodes[i].nextSibling;
+  if (next != AST_NIL && ast->nodes[next].slot != ast->nodes[i].slot)
+    return AST_NIL;
+  return next;
+}
+
+#endif
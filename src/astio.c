@@ -0,0 +1,215 @@
+/****************************************************/
+/* File: astio.c                                    */
+/* Binary serialization of the syntax tree          */
+/* for the C- compiler                              */
+/****************************************************/
+
+#include "astio.h"
+#include "ast.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* hasName tells whether attr holds a name pointer */
+static int hasName(TreeNode *t) {
+  if (t->nodekind == DeclK)
+    return TRUE;
+  if (t->nodekind == ExpK)
+    return t->kind.exp == IdK || t->kind.exp == AssignK ||
+           t->kind.exp == CallK || t->kind.exp == VarK;
+  return FALSE;
+}
+
+/* the string table keeps one copy of every name;
+ * names are found again through an open-addressing
+ * table of offsets built in scratchArena
+ */
+typedef struct {
+  char *bytes;
+  uint32_t used, capacity;
+  uint32_t *slots; /* 1 + offset, 0 = empty */
+  uint32_t numSlots;
+} StringTable;
+
+static uint32_t hashName(const char *s) {
+  uint32_t h = 2166136261u;
+  while (*s)
+    h = (h ^ (unsigned char)*s++) * 16777619u;
+  return h;
+}
+
+static uint32_t internName(StringTable *st, const char *s) {
+  uint32_t i = hashName(s) & (st->numSlots - 1);
+  uint32_t len = strlen(s) + 1;
+  while (st->slots[i] != 0) {
+    if (strcmp(st->bytes + st->slots[i] - 1, s) == 0)
+      return st->slots[i] - 1;
+    i = (i + 1) & (st->numSlots - 1);
+  }
+  if (st->used + len > st->capacity) {
+    char *bigger;
+    while (st->used + len > st->capacity)
+      st->capacity *= 2;
+    bigger = (char *)arenaAlloc(&scratchArena, st->capacity);
+    memcpy(bigger, st->bytes, st->used);
+    st->bytes = bigger;
+  }
+  memcpy(st->bytes + st->used, s, len);
+  st->slots[i] = st->used + 1;
+  st->used += len;
+  return st->slots[i] - 1;
+}
+
+#define PTR_TO_REC(p) ((TreeNode *)(uintptr_t)((p) ? (p)->id + 1 : 0))
+
+int astSave(const char *fileName, TreeNode *root) {
+  AstFileHeader h;
+  StringTable st;
+  TreeNode *records;
+  uint32_t i;
+  int c, ok;
+  FILE *f;
+  ArenaMark mark = arenaMark(&scratchArena);
+
+  st.numSlots = 64;
+  while (st.numSlots < 2 * compactAst.count)
+    st.numSlots *= 2;
+  st.slots = (uint32_t *)arenaCalloc(&scratchArena,
+                                     st.numSlots * sizeof(uint32_t));
+  st.capacity = 4096;
+  st.used = 0;
+  st.bytes = (char *)arenaAlloc(&scratchArena, st.capacity);
+
+  records = (TreeNode *)arenaAlloc(&scratchArena,
+                                   compactAst.count * sizeof(TreeNode));
+  for (i = 0; i < compactAst.count; i++) {
+    TreeNode *t = compactAst.tree[i];
+    TreeNode *r = &records[i];
+    *r = *t;
+    for (c = 0; c < MAXCHILDREN; c++)
+      r->child[c] = PTR_TO_REC(t->child[c]);
+    r->sibling = PTR_TO_REC(t->sibling);
+    r->symbol = NULL; /* bound again after loading */
+    if (hasName(t))
+      r->attr.name =
+          (char *)(uintptr_t)(t->attr.name ? internName(&st, t->attr.name) + 1
+                                           : 0);
+  }
+
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, AST_FILE_MAGIC, sizeof(h.magic));
+  h.version = AST_FILE_VERSION;
+  h.nodeSize = sizeof(TreeNode);
+  h.nodeCount = root != NULL ? compactAst.count : 0;
+  h.stringBytes = st.used;
+
+  f = fopen(fileName, "wb");
+  ok = f != NULL && fwrite(&h, sizeof(h), 1, f) == 1 &&
+       fwrite(records, sizeof(TreeNode), h.nodeCount, f) == h.nodeCount &&
+       fwrite(st.bytes, 1, st.used, f) == st.used;
+  if (f != NULL && fclose(f) != 0)
+    ok = FALSE;
+  arenaRelease(&scratchArena, mark);
+  return ok;
+}
+
+/* kindInRange tells whether the kinds of the record t
+ * are ones of the compiler
+ */
+static int kindInRange(TreeNode *t) {
+  switch (t->nodekind) {
+  case StmtK:
+    return t->kind.stmt >= IfK && t->kind.stmt <= ReturnK;
+  case ExpK:
+    return t->kind.exp >= OpK && t->kind.exp <= TypeSpecK;
+  case DeclK:
+    return t->kind.decl >= VarDeclK && t->kind.decl <= TypeK;
+  default:
+    return FALSE;
+  }
+}
+
+/* Function validRecords checks the records of h before
+ * they are fixed up: dumps are written in preorder, so
+ * a child or sibling always comes after its record,
+ * which also keeps the graph free of cycles. A record
+ * with a name must have one, in a string table ending
+ * in a NUL.
+ */
+static int validRecords(AstFileHeader *h, TreeNode *nodes) {
+  char *strings = (char *)(nodes + h->nodeCount);
+  uintptr_t p;
+  uint32_t i;
+  int c;
+  if (h->stringBytes > 0 && strings[h->stringBytes - 1] != '\0')
+    return FALSE;
+  for (i = 0; i < h->nodeCount; i++) {
+    TreeNode *t = &nodes[i];
+    if (!kindInRange(t))
+      return FALSE;
+    for (c = 0; c <= MAXCHILDREN; c++) {
+      p = (uintptr_t)(c < MAXCHILDREN ? t->child[c] : t->sibling);
+      if (p != 0 && (p - 1 <= i || p > h->nodeCount))
+        return FALSE;
+    }
+    if (hasName(t) && ((uintptr_t)t->attr.name == 0 ||
+                       (uintptr_t)t->attr.name > h->stringBytes))
+      return FALSE;
+  }
+  return TRUE;
+}
+
+TreeNode *astLoad(const char *fileName) {
+  struct stat sb;
+  AstFileHeader *h;
+  TreeNode *nodes;
+  char *strings;
+  char *base;
+  uint32_t i;
+  size_t need;
+  int c, fd = open(fileName, O_RDONLY);
+
+  if (fd < 0 || fstat(fd, &sb) != 0 || (size_t)sb.st_size < sizeof(*h)) {
+    fprintf(stderr, "AST file %s cannot be read\n", fileName);
+    if (fd >= 0)
+      close(fd);
+    return NULL;
+  }
+  /* private mapping: fixing up pointers never touches the file */
+  base = mmap(NULL, sb.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    fprintf(stderr, "AST file %s cannot be mapped\n", fileName);
+    return NULL;
+  }
+  h = (AstFileHeader *)base;
+  need = sizeof(*h) + (size_t)h->nodeCount * sizeof(TreeNode) + h->stringBytes;
+  if (memcmp(h->magic, AST_FILE_MAGIC, sizeof(h->magic)) != 0 ||
+      h->version != AST_FILE_VERSION || h->nodeSize != sizeof(TreeNode) ||
+      need != (size_t)sb.st_size || h->nodeCount == 0) {
+    fprintf(stderr, "%s is not an AST file for this compiler\n", fileName);
+    munmap(base, sb.st_size);
+    return NULL;
+  }
+  nodes = (TreeNode *)(base + sizeof(*h));
+  strings = (char *)(nodes + h->nodeCount);
+  if (!validRecords(h, nodes)) {
+    fprintf(stderr, "AST file %s is corrupt\n", fileName);
+    munmap(base, sb.st_size);
+    return NULL;
+  }
+
+#define REC_TO_PTR(p) ((p) != NULL ? &nodes[(uintptr_t)(p) - 1] : NULL)
+  for (i = 0; i < h->nodeCount; i++) {
+    TreeNode *t = &nodes[i];
+    for (c = 0; c < MAXCHILDREN; c++)
+      t->child[c] = REC_TO_PTR(t->child[c]);
+    t->sibling = REC_TO_PTR(t->sibling);
+    t->symbol = NULL;
+    if (hasName(t))
+      t->attr.name = strings + (uintptr_t)t->attr.name - 1;
+  }
+#undef REC_TO_PTR
+  return &nodes[0];
+}
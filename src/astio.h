@@ -0,0 +1,52 @@
+/****************************************************/
+/* File: astio.h                                    */
+/* Binary serialization of the syntax tree          */
+/* for the C- compiler                              */
+/****************************************************/
+
+#ifndef _ASTIO_H_
+#define _ASTIO_H_
+
+#include "globals.h"
+#include <stdint.h>
+
+/* Layout of an AST file (all fields in host order):
+ *
+ *   AstFileHeader
+ *   nodeCount TreeNode records, in preorder (record 0
+ *     is the root); every pointer field holds 1 + the
+ *     index of the record it points to, or 0 for NULL,
+ *     and attr.name holds 1 + an offset into the string
+ *     table, or 0
+ *   stringBytes of NUL-terminated identifier names,
+ *     each name stored once
+ *
+ * A loader maps the file, rejects a record pointing
+ * to itself, back, or past the end, and turns the
+ * offsets back into pointers in place; no node is
+ * allocated.
+ */
+
+#define AST_FILE_MAGIC "CMINAST"
+#define AST_FILE_VERSION 2
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t nodeSize; /* sizeof(TreeNode) of the writer */
+  uint32_t nodeCount;
+  uint32_t stringBytes;
+} AstFileHeader;
+
+/* Function astSave writes the tree rooted at root to
+ * fileName. root must have been laid out by astBuild.
+ * Returns FALSE if the file cannot be written.
+ */
+int astSave(const char *fileName, TreeNode *root);
+
+/* Function astLoad maps fileName and returns its root,
+ * or NULL (after printing the reason to stderr)
+ */
+TreeNode *astLoad(const char *fileName);
+
+#endif
@@ -0,0 +1,211 @@
+/****************************************************/
+/* File: callgraph.c                                */
+/* Call graph of a C- program, rooted at main       */
+/****************************************************/
+
+#include "callgraph.h"
+#include "ast.h"
+
+/* allocate the call graph */
+CallGraph callGraph;
+
+/* a call of Tarjan's search: the function and the
+ * next of its edges to follow
+ */
+typedef struct {
+  CallNode node;
+  CallEdge edge;
+} Frame;
+
+/* Procedure addCall records the call site t in the
+ * body of caller; calls of input, output or a name
+ * that is no function count only as sites
+ */
+static void addCall(CallNode caller, TreeNode *t) {
+  CallNode callee = t->symbol != NULL ? t->symbol->call : NULL;
+  CallEdge e, last = NULL;
+  caller->numSites++;
+  if (callee == NULL)
+    return;
+  callee->numCallers++;
+  for (e = caller->calls; e != NULL; last = e, e = e->next)
+    if (e->callee == callee) {
+      e->count++;
+      return;
+    }
+  /* the edges keep the order of the first calls */
+  e = (CallEdge)arenaAlloc(&compileArena, sizeof(struct CallEdgeRec));
+  e->callee = callee;
+  e->site = t;
+  e->count = 1;
+  e->next = NULL;
+  if (last == NULL)
+    caller->calls = e;
+  else
+    last->next = e;
+  if (callee == caller)
+    caller->recursive = TRUE;
+}
+
+/* Procedure scanCalls adds the calls of the chain of
+ * nodes starting at i, caller being the function
+ * they are in (NULL outside any)
+ */
+static void scanCalls(uint32_t i, CallNode caller) {
+  for (; i != AST_NIL; i = compactAst.nodes[i].nextSibling) {
+    AstNode *a = &compactAst.nodes[i];
+    TreeNode *t = compactAst.tree[i];
+    CallNode inner = caller;
+    if (a->nodekind == DeclK && a->kind == FunDeclK && t->symbol != NULL)
+      inner = t->symbol->call;
+    else if (a->nodekind == ExpK && a->kind == CallK && caller != NULL)
+      addCall(caller, t);
+    scanCalls(a->firstChild, inner);
+  }
+}
+
+/* Procedure markReachable marks the functions main
+ * calls, directly or not
+ */
+static void markReachable(CallNode root) {
+  CallNode *stack = (CallNode *)malloc(callGraph.count * sizeof(CallNode));
+  int top = 0;
+  root->reachable = TRUE;
+  stack[top++] = root;
+  while (top > 0) {
+    CallEdge e;
+    for (e = stack[--top]->calls; e != NULL; e = e->next)
+      if (!e->callee->reachable) {
+        e->callee->reachable = TRUE;
+        stack[top++] = e->callee;
+      }
+  }
+  free(stack);
+}
+
+/* Procedure findComponents numbers the strongly
+ * connected components with Tarjan's algorithm, which
+ * closes a component only after those it reaches
+ */
+static void findComponents(void) {
+  int n = callGraph.count, counter = 0, top = 0, depth = 0, i, k;
+  int *index = (int *)malloc(n * sizeof(int));
+  int *low = (int *)malloc(n * sizeof(int));
+  char *onStack = (char *)calloc(n, sizeof(char));
+  CallNode *stack = (CallNode *)malloc(n * sizeof(CallNode));
+  Frame *frames = (Frame *)malloc(n * sizeof(Frame));
+
+  for (i = 0; i < n; i++)
+    index[i] = -1;
+  for (i = 0; i < n; i++) {
+    if (index[i] != -1)
+      continue;
+    index[i] = low[i] = counter++;
+    stack[top++] = callGraph.nodes[i];
+    onStack[i] = TRUE;
+    frames[depth].node = callGraph.nodes[i];
+    frames[depth++].edge = callGraph.nodes[i]->calls;
+    while (depth > 0) {
+      Frame *f = &frames[depth - 1];
+      int v = f->node->id;
+      if (f->edge != NULL) {
+        int w = f->edge->callee->id;
+        f->edge = f->edge->next;
+        if (index[w] == -1) {
+          index[w] = low[w] = counter++;
+          stack[top++] = callGraph.nodes[w];
+          onStack[w] = TRUE;
+          frames[depth].node = callGraph.nodes[w];
+          frames[depth++].edge = callGraph.nodes[w]->calls;
+        } else if (onStack[w] && index[w] < low[v])
+          low[v] = index[w];
+        continue;
+      }
+      depth--;
+      if (low[v] == index[v]) {
+        int size = 0;
+        CallNode w;
+        do {
+          w = stack[--top];
+          onStack[w->id] = FALSE;
+          w->scc = callGraph.numSccs;
+          size++;
+        } while (w->id != v);
+        if (size > 1)
+          for (k = top; k < top + size; k++)
+            stack[k]->recursive = TRUE;
+        callGraph.numSccs++;
+      }
+      if (depth > 0 && low[v] < low[frames[depth - 1].node->id])
+        low[frames[depth - 1].node->id] = low[v];
+    }
+  }
+  free(frames);
+  free(stack);
+  free(onStack);
+  free(low);
+  free(index);
+}
+
+void buildCallGraph(void) {
+  BucketList root;
+  uint32_t i;
+  int n = 0;
+
+  for (i = 0; i < compactAst.count; i++)
+    if (compactAst.nodes[i].nodekind == DeclK &&
+        compactAst.nodes[i].kind == FunDeclK)
+      n++;
+  callGraph.nodes =
+      (CallNode *)arenaAlloc(&compileArena, n * sizeof(CallNode));
+  callGraph.count = 0;
+  callGraph.numSccs = 0;
+  callGraph.numReachable = 0;
+  /* one node per function record, in source order */
+  for (i = 0; i < compactAst.count; i++) {
+    TreeNode *t = compactAst.tree[i];
+    CallNode node;
+    if (compactAst.nodes[i].nodekind != DeclK ||
+        compactAst.nodes[i].kind != FunDeclK || t->symbol == NULL ||
+        t->symbol->call != NULL)
+      continue;
+    node = (CallNode)arenaCalloc(&compileArena, sizeof(struct CallNodeRec));
+    node->fun = t->symbol;
+    node->decl = t;
+    node->id = callGraph.count;
+    callGraph.nodes[callGraph.count++] = node;
+    t->symbol->call = node;
+  }
+  if (compactAst.count > 0)
+    scanCalls(0, NULL);
+
+  root = st_lookup_bucket("main", GLOBAL_SCOPE);
+  if (root != NULL && root->call != NULL)
+    markReachable(root->call);
+  for (n = 0; n < callGraph.count; n++) {
+    CallNode node = callGraph.nodes[n];
+    if (root == NULL || root->call == NULL)
+      node->reachable = TRUE;
+    node->leaf = node->calls == NULL;
+    if (node->reachable)
+      callGraph.numReachable++;
+  }
+  findComponents();
+}
+
+void printCallGraph(FILE *out) {
+  int i;
+  fprintf(out, "call graph: %d functions, %d reachable, %d components\n",
+          callGraph.count, callGraph.numReachable, callGraph.numSccs);
+  for (i = 0; i < callGraph.count; i++) {
+    CallNode node = callGraph.nodes[i];
+    CallEdge e;
+    fprintf(out, "  %-12s scc %-3d sites %-3d callers %-3d%s%s%s",
+            node->fun->name, node->scc, node->numSites, node->numCallers,
+            node->reachable ? "" : " unreachable",
+            node->recursive ? " recursive" : "", node->leaf ? " leaf" : "");
+    for (e = node->calls; e != NULL; e = e->next)
+      fprintf(out, " %s(%d)", e->callee->fun->name, e->count);
+    fprintf(out, "\n");
+  }
+}
@@ -0,0 +1,61 @@
+/****************************************************/
+/* File: callgraph.h                                */
+/* Call graph of a C- program, rooted at main       */
+/****************************************************/
+
+#ifndef _CALLGRAPH_H_
+#define _CALLGRAPH_H_
+
+#include "globals.h"
+
+/* the calls from one function to another: the first
+ * call site and how many sites there are
+ */
+typedef struct CallEdgeRec {
+  struct CallNodeRec *callee;
+  TreeNode *site;
+  int count;
+  struct CallEdgeRec *next;
+} *CallEdge;
+
+/* A CallNode annotates a function record (its field
+ * call). Components are numbered callees first, so
+ * a function's component is never above those of the
+ * functions it calls, save for its own.
+ */
+typedef struct CallNodeRec {
+  BucketList fun;
+  TreeNode *decl;   /* the FunDeclK of the body */
+  CallEdge calls;   /* one edge per callee */
+  int numSites;     /* call sites in the body */
+  int numCallers;   /* call sites calling it */
+  int scc;          /* strongly connected component */
+  int recursive;    /* may call itself, directly or not */
+  int leaf;         /* calls no function but input/output */
+  int reachable;    /* called, directly or not, from main */
+  int id;           /* position in callGraph.nodes */
+} *CallNode;
+
+typedef struct {
+  CallNode *nodes; /* in source order */
+  int count;
+  int numSccs;
+  int numReachable;
+} CallGraph;
+
+/* callGraph is the graph of the program being compiled */
+extern CallGraph callGraph;
+
+/* Procedure buildCallGraph builds callGraph over the
+ * CallK nodes of compactAst, after analysis, and sets
+ * the call field of every function record. Without a
+ * main every function counts as reachable.
+ */
+void buildCallGraph(void);
+
+/* Procedure printCallGraph lists callGraph to out,
+ * one function per line
+ */
+void printCallGraph(FILE *out);
+
+#endif
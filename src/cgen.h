@@ -14,26 +14,38 @@
 #define ofpFO 0
 #define retFO -1
 #define initFO -2
-#define MAX_FUNC_HASH 20
+#define MAX_FUNC_HASH 20 /* first room in funcHash; it grows */
 
+/* a function generated: where its code starts, and
+ * the size of its frame below the return address
+ */
 typedef struct FunctionInfosRec {
   char *funcName;
   int startAddr;
-  int sizeOfVars;
+  int frameSize;
 } FunctionInfosRec;
 
+/* Function findFunction returns the function name
+ * generated so far, NULL if there is none
+ */
+FunctionInfosRec *findFunction(char *name);
+
 
 /* Procedure codeGen generates code to a code
  * file by traversal of the syntax tree. 
  */
 void codeGen(TreeNode * syntaxTree, FILE * code);
 
-void cGen(TreeNode *t, scopeList scope, char *funcName);
-
-void genPrologue(TreeNode *t, scopeList scope, char *funcName);
-void genEpilogue(TreeNode *t, scopeList scope, char *funcName);
-void genStmt(TreeNode *t, scopeList scope, char *funcName);
-void genExp(TreeNode *t, scopeList scope, int isAddr);
-void genDecl(TreeNode *t, scopeList scope, char *funcName);
+/* codeGen in three steps, for a tree that is given
+ * one top-level declaration at a time: codeGenBegin
+ * emits the prelude, codeGenDecl the code of the
+ * functions t and its siblings declare (lowered to
+ * the intermediate code of ir.h on the way), and codeGenEnd the final HALT,
+ * writing out the code (emitCode) once the peephole
+ * pass is done with it (peephole.h)
+ */
+void codeGenBegin(void);
+void codeGenDecl(TreeNode *t);
+void codeGenEnd(void);
 
 #endif
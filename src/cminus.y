@@ -6,20 +6,20 @@
 #include "parse.h"
 
 #define YYSTYPE TreeNode *
-static char * savedName; /* for use in assignments */
-static int savedLineNo;  /* ditto */
-static int savedMultOperator;  
-static int savedSumOperator;
-static int savedRelOperator;
-static int saveNumber;
-static char * savedFunctionName;
-static TreeNode * savedTree; /* stores syntax tree for later return */
-static int yylex(void);
+/* parser state is per thread (see pparse.c) */
+static _Thread_local char * savedName; /* for use in assignments */
+static _Thread_local int saveNumber;
+static _Thread_local TreeNode * savedTree; /* stores syntax tree for later return */
+static _Thread_local int lastToken; /* lookahead, for yyerror */
+static _Thread_local int syntaxError; /* set by yyerror */
+/* if set, takes each top-level declaration (parseEach) */
+static _Thread_local void (*declHandler)(TreeNode *);
+static int yylex(YYSTYPE *lvalp);
 int yyerror(char *);
 
 #define MAX_NAME_STACK 100
-static char *nameStack[MAX_NAME_STACK];
-static int nameStackTop = -1;
+static _Thread_local char *nameStack[MAX_NAME_STACK];
+static _Thread_local int nameStackTop = -1;
 
 static void pushName(char *name) {
   nameStack[++nameStackTop] = name;
@@ -37,13 +37,18 @@ static char *popName() {
 %token IF THEN ELSE END REPEAT UNTIL READ WRITE VOID INT %token WHILE RETURN ASSIGN EQ EQQ NEQ LT GT LTE GTE PLUS %token MINUS TIMES OVER LPAREN RPAREN SEMI COMMA NUM ID %token ENDFILE
 %token LBRACE RBRACE LBRACKET RBRACKET ERROR
 
+%define api.pure full
+
 
 %% /* Grammar for C- */
 program : list_decl {savedTree = $1; };
 list_decl : list_decl decl 
                 {
                   YYSTYPE t = $1;
-                  if (t != NULL) {
+                  if (declHandler != NULL) {
+                    declHandler($2);
+                    $$ = NULL;
+                  } else if (t != NULL) {
                     while (t->sibling != NULL) {
                       t = t->sibling;
                     }
@@ -55,7 +60,11 @@ list_decl : list_decl decl
                 }
           | decl
                 {
-                  $$ = $1;
+                  if (declHandler != NULL) {
+                    declHandler($1);
+                    $$ = NULL;
+                  } else
+                    $$ = $1;
                 }
         ;
 decl : var_decl 
@@ -93,24 +102,23 @@ var_decl : type_spec ID { savedName = copyString(prevTokenString); } SEMI
 type_spec : INT 
                 {
                   $$ = newExpNode(TypeSpecK);
-                  $$->type = copyString(tokenString);
+                  $$->type = Integer;
                   $$->lineno = lineno;
                 }
           | VOID
                 {
                   $$ = newExpNode(TypeSpecK);
-                  $$->type = copyString(tokenString);
+                  $$->type = Void;
                   $$->lineno = lineno;
                 }
         ;
 fun_decl : type_spec ID 
-           { savedFunctionName = copyString(prevTokenString); 
-             savedLineNo = lineno; }
+           { /* on the stack, not in a global: the body may declare functions too */
+             $$ = newDeclNode(FunDeclK);
+             $$->attr.name = copyString(prevTokenString); }
            LPAREN params RPAREN decl_compo
                 {
-                  $$ = newDeclNode(FunDeclK);
-                  $$->attr.name = savedFunctionName;
-                  $$->lineno = savedLineNo ;
+                  $$ = $3;
                   $$->typeReturn = $1->type;
                   $$->type = $1->type;
                   $$->child[0] = $5; 
@@ -120,7 +128,6 @@ fun_decl : type_spec ID
 decl_compo : LBRACE local_decl list_stmt RBRACE
                 {
                   $$ = newStmtNode(CompoundK);
-                  $$->type = "block";
                   $$->child[0] = $2;
                   $$->child[1] = $3;
                   $$->lineno = lineno;
@@ -220,7 +227,6 @@ decl_sel : IF LPAREN exp RPAREN stmt
                   $$ = newStmtNode(IfK);
                   $$->child[0] = $3;
                   $$->child[1] = $5;
-                  $$->type = "if";
                   $$->lineno = lineno;
                 }
           | IF LPAREN exp RPAREN stmt ELSE stmt
@@ -229,7 +235,6 @@ decl_sel : IF LPAREN exp RPAREN stmt
                   $$->child[0] = $3;
                   $$->child[1] = $5;
                   $$->child[2] = $7;
-                  $$->type = "if";
                   $$->lineno = lineno;
                 }
         ;
@@ -238,7 +243,6 @@ decl_ite : WHILE LPAREN exp RPAREN stmt
                   $$ = newStmtNode(WhileK);
                   $$->child[0] = $3;
                   $$->child[1] = $5;
-                  $$->type = "while";
                   $$->lineno = lineno;
                 }
         ;
@@ -246,7 +250,7 @@ decl_return : RETURN SEMI
                 {
                   $$ = newStmtNode(ReturnK);
                   $$->lineno = lineno;
-                  $$->type = "void";
+                  $$->type = Void;
                 }
           | RETURN exp SEMI
                 {
@@ -281,10 +285,13 @@ var : ID
                   $$->attr.name = copyString(prevTokenString);
                   $$->lineno = lineno;
                 }
-      | ID { savedName = copyString(prevTokenString); } LBRACKET exp RBRACKET
-      {
+      | ID
+      { /* on the stack: the index may name arrays too */
         $$ = newExpNode(VarK);
-        $$->attr.name = savedName;
+        $$->attr.name = copyString(prevTokenString); }
+      LBRACKET exp RBRACKET
+      {
+        $$ = $2;
         $$->isArray = 1;
         $$->child[0] = $4;
         $$->lineno = lineno;
@@ -292,10 +299,9 @@ var : ID
       ;
 simple_exp : sum_exp rel sum_exp 
                 {
-                  $$ = newExpNode(OpK);
+                  $$ = $2;
                   $$->child[0] = $1;
                   $$->child[1] = $3;
-                  $$->attr.op = savedRelOperator;
                   $$->lineno = lineno;
                 }
           | sum_exp
@@ -303,12 +309,15 @@ simple_exp : sum_exp rel sum_exp
                   $$ = $1;
                 }
         ;
-rel : LTE {savedRelOperator = LTE;}
-| LT {savedRelOperator = LT;}
-| GT {savedRelOperator = GT;}
-| GTE {savedRelOperator = GTE;}
-| EQQ {savedRelOperator = EQQ;}
-| NEQ {savedRelOperator = NEQ;}
+/* the operator node is made here, so that a relation
+ * in the right operand cannot change it
+ */
+rel : LTE {$$ = newExpNode(OpK); $$->attr.op = LTE;}
+| LT {$$ = newExpNode(OpK); $$->attr.op = LT;}
+| GT {$$ = newExpNode(OpK); $$->attr.op = GT;}
+| GTE {$$ = newExpNode(OpK); $$->attr.op = GTE;}
+| EQQ {$$ = newExpNode(OpK); $$->attr.op = EQQ;}
+| NEQ {$$ = newExpNode(OpK); $$->attr.op = NEQ;}
         ;
 sum_exp : sum_exp PLUS term 
                 {
@@ -333,7 +342,6 @@ sum_exp : sum_exp PLUS term
                   $$ = newExpNode(OpK);
                   $$->child[0] = $2;
                   $$->attr.op = MINUS;
-                  $$->type = "unary";
                   $$->lineno = lineno;
                 }
           | term
@@ -381,7 +389,7 @@ factor  : LPAREN exp RPAREN
                   $$ = newExpNode(ConstK);
                   $$->attr.val = atoi(tokenString);
                   $$->lineno = lineno;
-                  $$->type = "int";
+                  $$->type = Integer;
                 }
         ;
 ativ : ID 
@@ -428,19 +436,41 @@ list_args : list_args COMMA exp
 int yyerror(char * message)
 { pce("Syntax error at line %d: %s\n",lineno,message);
   pce("Current token: ");
-  printToken(yychar,tokenString);
-  Error = TRUE;
+  printToken(lastToken,tokenString);
+  syntaxError = TRUE;
   return 0;
 }
 
 /* yylex calls getToken to make Yacc/Bison output
  * compatible with ealier versions of the TINY scanner
  */
-static int yylex(void)
-{ return getToken(); }
+static int yylex(YYSTYPE *lvalp)
+{ return lastToken = getToken(); }
 
 TreeNode * parse(void)
 { 
 	yyparse();
+  if (syntaxError)
+    Error = TRUE;
+  return savedTree;
+}
+
+int parseEach(void (*handle)(TreeNode *))
+{ declHandler = handle;
+  yyparse();
+  declHandler = NULL;
+  if (syntaxError)
+    Error = TRUE;
+  return syntaxError;
+}
+
+TreeNode * parseText(const char *text, int len, int firstLine, int isEnd,
+                     int *failed)
+{ scanText(text, len, firstLine, isEnd);
+  savedTree = NULL;
+  syntaxError = FALSE;
+  yyparse();
+  scanTextDone();
+  *failed = syntaxError;
   return savedTree;
 }
\ No newline at end of file
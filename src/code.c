@@ -17,11 +17,73 @@ static int emitLoc = 0 ;
    emitBackup, and emitRestore */
 static int highEmitLoc = 0;
 
-/* Procedure emitComment prints a comment line 
- * with comment c in the code file
+/* allocate the code buffer */
+TmCode codeBuffer;
+static int maxInstrs = 0;
+
+/* comment lines, chained per location */
+typedef struct {
+  char *text;
+  int next;
+} Note;
+
+static Note *notes = NULL;
+static int numNotes = 0, maxNotes = 0;
+
+static const char *opNames[] = {
+  "", "HALT", "IN", "OUT", "ADD", "SUB", "MUL", "DIV",
+  "LD", "ST", "LDA", "LDC", "JLT", "JLE", "JGT", "JGE", "JEQ", "JNE"
+};
+
+/* Function slot returns the entry of location loc,
+ * growing the buffer to hold it
+ */
+static TmInstr * slot( int loc)
+{ if (loc >= maxInstrs)
+  { int i, n = maxInstrs == 0 ? 1024 : maxInstrs;
+    while (n <= loc) n *= 2;
+    codeBuffer.instrs =
+        (TmInstr *) realloc(codeBuffer.instrs, n * sizeof(TmInstr));
+    for (i = maxInstrs; i < n; i++)
+    { codeBuffer.instrs[i].op = opSKIP;
+      codeBuffer.instrs[i].comment = NULL;
+      codeBuffer.instrs[i].notes = -1;
+      codeBuffer.instrs[i].flags = 0;
+    }
+    maxInstrs = n;
+  }
+  return &codeBuffer.instrs[loc];
+} /* slot */
+
+/* Procedure emit fills the current location, the
+ * one before the operands are read when backpatching
+ */
+static void emit( TmOp op, int r, int s, int t, int d, char *c)
+{ TmInstr *in = slot(emitLoc++);
+  in->op = op;
+  in->r = r; in->s = s; in->t = t; in->d = d;
+  in->comment = TraceCode ? c : NULL;
+  in->flags = 0;
+  if (highEmitLoc < emitLoc) highEmitLoc = emitLoc ;
+  codeBuffer.size = highEmitLoc;
+} /* emit */
+
+/* Procedure emitComment records a comment line
+ * with comment c before the current location
  */
 void emitComment( char * c )
-{ if (TraceCode) pc("* %s\n",c);}
+{ int *link;
+  if (!TraceCode) return;
+  if (numNotes == maxNotes)
+  { maxNotes = maxNotes == 0 ? 1024 : 2 * maxNotes;
+    notes = (Note *) realloc(notes, maxNotes * sizeof(Note));
+  }
+  notes[numNotes].text = c;
+  notes[numNotes].next = -1;
+  link = &slot(emitLoc)->notes;
+  while (*link != -1) link = &notes[*link].next;
+  *link = numNotes++;
+}
 
 /* Procedure emitRO emits a register-only
  * TM instruction
@@ -31,11 +93,8 @@ void emitComment( char * c )
  * t = 2nd source register
  * c = a comment to be printed if TraceCode is TRUE
  */
-void emitRO( char *op, int r, int s, int t, char *c)
-{ pc("%3d:  %5s  %d,%d,%d ",emitLoc++,op,r,s,t);
-  if (TraceCode) pc("\t%s",c) ;
-  pc("\n") ;
-  if (highEmitLoc < emitLoc) highEmitLoc = emitLoc ;
+void emitRO( TmOp op, int r, int s, int t, char *c)
+{ emit(op,r,s,t,0,c);
 } /* emitRO */
 
 /* Procedure emitRM emits a register-to-memory
@@ -46,11 +105,8 @@ void emitRO( char *op, int r, int s, int t, char *c)
  * s = the base register
  * c = a comment to be printed if TraceCode is TRUE
  */
-void emitRM( char * op, int r, int d, int s, char *c)
-{ pc("%3d:  %5s  %d,%d(%d) ",emitLoc++,op,r,d,s);
-  if (TraceCode) pc("\t%s",c) ;
-  pc("\n") ;
-  if (highEmitLoc < emitLoc)  highEmitLoc = emitLoc ;
+void emitRM( TmOp op, int r, int d, int s, char *c)
+{ emit(op,r,s,0,d,c);
 } /* emitRM */
 
 /* Function emitSkip skips "howMany" code
@@ -61,6 +117,7 @@ int emitSkip( int howMany)
 {  int i = emitLoc;
    emitLoc += howMany ;
    if (highEmitLoc < emitLoc)  highEmitLoc = emitLoc ;
+   codeBuffer.size = highEmitLoc;
    return i;
 } /* emitSkip */
 
@@ -87,11 +144,134 @@ void emitRestore(void)
  * a = the absolute location in memory
  * c = a comment to be printed if TraceCode is TRUE
  */
-void emitRM_Abs( char *op, int r, int a, char * c)
-{ pc("%3d:  %5s  %d,%d(%d) ",
-               emitLoc,op,r,a-(emitLoc+1),PC);
-  ++emitLoc ;
-  if (TraceCode) pc("\t%s",c) ;
-  pc("\n") ;
-  if (highEmitLoc < emitLoc) highEmitLoc = emitLoc ;
+void emitRM_Abs( TmOp op, int r, int a, char * c)
+{ emit(op,r,PC,0,a-(emitLoc+1),c);
 } /* emitRM_Abs */
+
+/* Procedure emitLDC_Abs loads the absolute code
+ * location a into register r, marked so that a is
+ * moved along with the instruction it names
+ * c = a comment to be printed if TraceCode is TRUE
+ */
+void emitLDC_Abs( int r, int a, char * c)
+{ emit(opLDC,r,0,0,a,c);
+  codeBuffer.instrs[emitLoc-1].flags = TM_ADDR;
+} /* emitLDC_Abs */
+
+/* Function jumpTarget returns the location the
+ * instruction at loc jumps to relative to the pc,
+ * -1 if it is no such jump
+ */
+int jumpTarget( int loc)
+{ TmInstr *in = &codeBuffer.instrs[loc];
+  if (in->op >= opLD && in->s == PC &&
+      (in->op >= opJLT || (in->op == opLDA && in->r == PC)))
+    return loc + 1 + in->d;
+  return -1;
+}
+
+/* Procedure emitCompact removes the instructions
+ * flagged TM_DEAD, moving their comment lines to the
+ * next instruction kept, and renumbers the jump
+ * targets and TM_ADDR locations of the rest; a target
+ * removed becomes the next instruction kept
+ */
+void emitCompact(void)
+{ int size = codeBuffer.size, loc, kept = 0, pending = -1;
+  int *pendingEnd = &pending;
+  /* newLoc[loc] is the number of instructions kept
+   * before loc, which is where loc, or the next one
+   * kept, lands
+   */
+  int *newLoc = (int *) malloc((size + 1) * sizeof(int));
+  slot(size);
+  for (loc = 0; loc <= size; loc++)
+  { newLoc[loc] = kept;
+    if (loc < size && !(codeBuffer.instrs[loc].flags & TM_DEAD)) kept++;
+  }
+  for (loc = 0; loc <= size; loc++)
+  { int target = loc < size ? jumpTarget(loc) : -1;
+    TmInstr in = codeBuffer.instrs[loc];
+    codeBuffer.instrs[loc].op = opSKIP;
+    codeBuffer.instrs[loc].comment = NULL;
+    codeBuffer.instrs[loc].notes = -1;
+    codeBuffer.instrs[loc].flags = 0;
+    /* the comment lines of removed ones go first */
+    *pendingEnd = in.notes;
+    while (*pendingEnd != -1) pendingEnd = &notes[*pendingEnd].next;
+    if (loc < size && (in.flags & TM_DEAD)) continue;
+    if (target != -1)
+    { if (target < 0) target = 0;
+      if (target > size) target = size;
+      in.d = newLoc[target] - (newLoc[loc] + 1);
+    }
+    else if ((in.flags & TM_ADDR) && in.d >= 0 && in.d <= size)
+      in.d = newLoc[in.d];
+    in.notes = pending;
+    pending = -1;
+    pendingEnd = &pending;
+    codeBuffer.instrs[newLoc[loc]] = in;
+  }
+  free(newLoc);
+  codeBuffer.size = emitLoc = highEmitLoc = kept;
+} /* emitCompact */
+
+/* the text of the code, written out a block at a time */
+#define OUT_BLOCK 65536
+static char outBlock[OUT_BLOCK];
+static int outLen = 0;
+
+static void flushOut(void)
+{ outBlock[outLen] = '\0';
+  pcs(outBlock);
+  outLen = 0;
+}
+
+/* Procedure putText appends text to the block */
+static void putText(const char *text)
+{ size_t len = strlen(text);
+  if (outLen + len >= OUT_BLOCK) flushOut();
+  if (len >= OUT_BLOCK) pcs(text);
+  else
+  { memcpy(outBlock + outLen, text, len);
+    outLen += len;
+  }
+}
+
+/* Procedure emitCode writes codeBuffer to the code
+ * listing in one pass, in location order, and
+ * empties it
+ */
+void emitCode(void)
+{ int loc, k;
+  /* comment lines may follow the last instruction */
+  int end = codeBuffer.size + 1 < maxInstrs ? codeBuffer.size + 1 : maxInstrs;
+  for (loc = 0; loc < end; loc++)
+  { TmInstr *in = &codeBuffer.instrs[loc];
+    for (k = in->notes; k != -1; k = notes[k].next)
+    { putText("* ");
+      putText(notes[k].text);
+      putText("\n");
+    }
+    if (in->op != opSKIP)
+    { if (outLen + 96 >= OUT_BLOCK) flushOut();
+      if (in->op <= opDIV)
+        outLen += sprintf(outBlock + outLen, "%3d:  %5s  %d,%d,%d ",
+                          loc, opNames[in->op], in->r, in->s, in->t);
+      else
+        outLen += sprintf(outBlock + outLen, "%3d:  %5s  %d,%d(%d) ",
+                          loc, opNames[in->op], in->r, in->d, in->s);
+      if (in->comment != NULL)
+      { putText("\t");
+        putText(in->comment);
+      }
+      putText("\n");
+    }
+    in->op = opSKIP;
+    in->comment = NULL;
+    in->notes = -1;
+    in->flags = 0;
+  }
+  if (outLen > 0) flushOut();
+  numNotes = 0;
+} /* emitCode */
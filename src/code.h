@@ -9,6 +9,7 @@
 #ifndef _CODE_H_
 #define _CODE_H_
 
+#include <stdint.h>
 
 /* pc = program counter  */
 #define  PC 7
@@ -35,11 +36,56 @@
 
 #define sp 3
 
+/* TM opcodes; opSKIP marks a location skipped for a
+ * backpatch and not filled yet
+ */
+typedef enum {
+  opSKIP,
+  /* register-only */
+  opHALT, opIN, opOUT, opADD, opSUB, opMUL, opDIV,
+  /* register-to-memory */
+  opLD, opST, opLDA, opLDC, opJLT, opJLE, opJGT, opJGE, opJEQ, opJNE
+} TmOp;
+
+/* flags of an emitted instruction: TM_ADDR marks a d
+ * that is an absolute code location (a return address
+ * loaded by LDC), TM_DEAD one emitCompact removes
+ */
+#define TM_ADDR 1
+#define TM_DEAD 2
+
+/* an emitted instruction: register-only ops use r, s
+ * and t, register-to-memory ones r, d(s). The comment
+ * is kept only if TraceCode is TRUE; the notes are the
+ * comment lines printed before the instruction.
+ */
+typedef struct {
+  uint8_t op; /* TmOp */
+  uint8_t r, s, t;
+  int32_t d;
+  char *comment;
+  int32_t notes; /* first one, -1 if none */
+  uint8_t flags;
+} TmInstr;
+
+/* the code emitted so far, indexed by location:
+ * size is one past the highest location emitted
+ */
+typedef struct {
+  TmInstr *instrs;
+  int size;
+} TmCode;
+
+extern TmCode codeBuffer;
 
-/* code emitting utilities */
+/* code emitting utilities: instructions go to
+ * codeBuffer, and emitCode writes them out. The
+ * buffer keeps the comments by pointer, so they
+ * must live until then.
+ */
 
-/* Procedure emitComment prints a comment line 
- * with comment c in the code file
+/* Procedure emitComment records a comment line
+ * with comment c before the current location
  */
 void emitComment( char * c );
 
@@ -51,7 +97,7 @@ void emitComment( char * c );
  * t = 2nd source register
  * c = a comment to be printed if TraceCode is TRUE
  */
-void emitRO( char *op, int r, int s, int t, char *c);
+void emitRO( TmOp op, int r, int s, int t, char *c);
 
 /* Procedure emitRM emits a register-to-memory
  * TM instruction
@@ -61,7 +107,7 @@ void emitRO( char *op, int r, int s, int t, char *c);
  * s = the base register
  * c = a comment to be printed if TraceCode is TRUE
  */
-void emitRM( char * op, int r, int d, int s, char *c);
+void emitRM( TmOp op, int r, int d, int s, char *c);
 
 /* Function emitSkip skips "howMany" code
  * locations for later backpatch. It also
@@ -88,6 +134,33 @@ void emitRestore(void);
  * a = the absolute location in memory
  * c = a comment to be printed if TraceCode is TRUE
  */
-void emitRM_Abs( char *op, int r, int a, char * c);
+void emitRM_Abs( TmOp op, int r, int a, char * c);
+
+/* Procedure emitLDC_Abs loads the absolute code
+ * location a into register r, marked so that a is
+ * moved along with the instruction it names
+ * c = a comment to be printed if TraceCode is TRUE
+ */
+void emitLDC_Abs( int r, int a, char * c);
+
+/* Function jumpTarget returns the location the
+ * instruction at loc jumps to relative to the pc,
+ * -1 if it is no such jump
+ */
+int jumpTarget( int loc);
+
+/* Procedure emitCompact removes the instructions
+ * flagged TM_DEAD, moving their comment lines to the
+ * next instruction kept, and renumbers the jump
+ * targets and TM_ADDR locations of the rest; a target
+ * removed becomes the next instruction kept
+ */
+void emitCompact(void);
+
+/* Procedure emitCode writes codeBuffer to the code
+ * listing in one pass, in location order, and
+ * empties it
+ */
+void emitCode(void);
 
 #endif
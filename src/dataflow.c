@@ -0,0 +1,498 @@
+/****************************************************/
+/* File: dataflow.c                                 */
+/* Dataflow analysis over the blocks of the         */
+/* intermediate code (ir.h)                         */
+/****************************************************/
+
+#include "dataflow.h"
+#include <stdlib.h>
+#include <string.h>
+
+void dfInit(Dataflow *d, IrFunc *f, int forward, int intersect, int numBits) {
+  size_t size;
+  d->forward = forward;
+  d->intersect = intersect;
+  d->numBits = numBits;
+  d->numWords = (numBits + DF_BITS - 1) / DF_BITS;
+  if (d->numWords == 0)
+    d->numWords = 1;
+  size = (size_t)f->numBlocks * d->numWords * sizeof(DfWord);
+  d->gen = (DfWord *)calloc(1, size);
+  d->kill = (DfWord *)calloc(1, size);
+  d->in = (DfWord *)calloc(1, size);
+  d->out = (DfWord *)calloc(1, size);
+  d->boundary = (DfWord *)calloc(d->numWords, sizeof(DfWord));
+}
+
+void dfFree(Dataflow *d) {
+  free(d->gen);
+  free(d->kill);
+  free(d->in);
+  free(d->out);
+  free(d->boundary);
+}
+
+/* meet sets to the meet of from, or for no block at
+ * all (n == 0) to what the problem starts from
+ */
+static void meet(Dataflow *d, DfWord *to, DfWord **from, int n) {
+  int i, k;
+  if (n == 0) {
+    memset(to, d->intersect ? 0xff : 0, d->numWords * sizeof(DfWord));
+    return;
+  }
+  memcpy(to, from[0], d->numWords * sizeof(DfWord));
+  for (i = 1; i < n; i++)
+    for (k = 0; k < d->numWords; k++)
+      if (d->intersect)
+        to[k] &= from[i][k];
+      else
+        to[k] |= from[i][k];
+}
+
+void dfSolve(Dataflow *d, IrFunc *f) {
+  IrBlock **queue, *b, *succ[2];
+  DfWord **from, *get, *give, w;
+  char *queued;
+  int head = 0, tail = 0, size = f->numBlocks + 1, n, i, k, changed;
+  queue = (IrBlock **)malloc(size * sizeof(IrBlock *));
+  queued = (char *)calloc(f->numBlocks, 1);
+  from = (DfWord **)malloc((f->numBlocks + 2) * sizeof(DfWord *));
+  for (b = d->forward ? f->first : f->last; b != NULL;
+       b = d->forward ? b->next : b->prev) {
+    memset(DF_SET(d, d->in, b), d->intersect ? 0xff : 0,
+           d->numWords * sizeof(DfWord));
+    memset(DF_SET(d, d->out, b), d->intersect ? 0xff : 0,
+           d->numWords * sizeof(DfWord));
+    queue[tail++] = b;
+    queued[b->id] = TRUE;
+  }
+  tail %= size;
+  while (head != tail) {
+    b = queue[head];
+    head = (head + 1) % size;
+    queued[b->id] = FALSE;
+    get = DF_SET(d, d->forward ? d->in : d->out, b);
+    give = DF_SET(d, d->forward ? d->out : d->in, b);
+    n = 0;
+    if (d->forward) {
+      for (i = 0; i < b->numPreds; i++)
+        from[n++] = DF_SET(d, d->out, b->preds[i]);
+    } else {
+      k = irSuccessors(b, succ);
+      for (i = 0; i < k; i++)
+        from[n++] = DF_SET(d, d->in, succ[i]);
+    }
+    if (d->forward ? b == f->first : n == 0)
+      memcpy(get, d->boundary, d->numWords * sizeof(DfWord));
+    else
+      meet(d, get, from, n);
+    changed = FALSE;
+    for (k = 0; k < d->numWords; k++) {
+      w = DF_SET(d, d->gen, b)[k] | (get[k] & ~DF_SET(d, d->kill, b)[k]);
+      if (w != give[k]) {
+        give[k] = w;
+        changed = TRUE;
+      }
+    }
+    if (!changed)
+      continue;
+    /* what depends on b goes again */
+    n = d->forward ? irSuccessors(b, succ) : b->numPreds;
+    for (i = 0; i < n; i++) {
+      IrBlock *next = d->forward ? succ[i] : b->preds[i];
+      if (!queued[next->id]) {
+        queued[next->id] = TRUE;
+        queue[tail] = next;
+        tail = (tail + 1) % size;
+      }
+    }
+  }
+  free(from);
+  free(queued);
+  free(queue);
+}
+
+void liveRegisters(Dataflow *d, IrFunc *f) {
+  IrBlock *b;
+  IrInstr *in;
+  DfWord *gen, *kill;
+  int k, n, v;
+  dfInit(d, f, FALSE, FALSE, f->numVregs);
+  for (b = f->first; b != NULL; b = b->next) {
+    gen = DF_SET(d, d->gen, b);
+    kill = DF_SET(d, d->kill, b);
+    for (in = b->first; in != NULL; in = in->next) {
+      n = irNumUses(in);
+      for (k = 0; k < n; k++) {
+        v = *irUse(in, k);
+        if (v >= IR_FIRST && !dfTest(kill, v))
+          dfSet(gen, v);
+      }
+      if (in->dst != IR_NONE)
+        dfSet(kill, in->dst);
+    }
+  }
+  dfSolve(d, f);
+}
+
+/* slot of the place base + offset in the table of v */
+static int slotOf(IrVars *v, int base, int offset) {
+  unsigned int h = ((unsigned int)offset * 2u + (unsigned int)base) * 2654435761u;
+  int i = (int)(h & (unsigned int)(v->size - 1)), x;
+  while ((x = v->slots[i]) != -1 &&
+         (v->base[x] != base || v->offset[x] != offset))
+    i = (i + 1) & (v->size - 1);
+  return i;
+}
+
+static int isVarAccess(IrInstr *in) {
+  return (in->op == IR_LOAD || in->op == IR_STORE) && in->sym != NULL;
+}
+
+void varsInit(IrVars *v, IrFunc *f) {
+  IrBlock *b;
+  IrInstr *in;
+  int n = 0, i;
+  for (b = f->first; b != NULL; b = b->next)
+    for (in = b->first; in != NULL; in = in->next)
+      n += isVarAccess(in);
+  for (v->size = 16; v->size < 2 * n; v->size *= 2)
+    ;
+  v->slots = (int *)malloc(v->size * sizeof(int));
+  for (i = 0; i < v->size; i++)
+    v->slots[i] = -1;
+  v->base = (int *)malloc((n + 1) * sizeof(int));
+  v->offset = (int *)malloc((n + 1) * sizeof(int));
+  v->numVars = 0;
+  for (b = f->first; b != NULL; b = b->next)
+    for (in = b->first; in != NULL; in = in->next)
+      if (isVarAccess(in)) {
+        i = slotOf(v, in->a, in->imm);
+        if (v->slots[i] == -1) {
+          v->base[v->numVars] = in->a;
+          v->offset[v->numVars] = in->imm;
+          v->slots[i] = v->numVars++;
+        }
+      }
+}
+
+void varsFree(IrVars *v) {
+  free(v->slots);
+  free(v->base);
+  free(v->offset);
+}
+
+int varOf(IrVars *v, IrInstr *in) {
+  if (!isVarAccess(in))
+    return -1;
+  return v->slots[slotOf(v, in->a, in->imm)];
+}
+
+/* Procedure define makes set hold the definition k,
+ * in place of the others of its variable
+ */
+static void define(ReachingDefs *r, DfWord *set, DfWord *kill, int k) {
+  DfWord *defs = r->varDefs + (size_t)r->var[k] * r->df.numWords;
+  int i;
+  for (i = 0; i < r->df.numWords; i++) {
+    set[i] &= ~defs[i];
+    if (kill != NULL)
+      kill[i] |= defs[i];
+  }
+  dfSet(set, k);
+}
+
+/* numDefsOf returns how many definitions in makes */
+static int numDefsOf(ReachingDefs *r, IrInstr *in) {
+  if (in->op == IR_CALL)
+    return r->numGlobals;
+  return in->op == IR_STORE && in->sym != NULL;
+}
+
+void rdStep(ReachingDefs *r, DfWord *set, IrInstr *in) {
+  int j, n = numDefsOf(r, in);
+  for (j = 0; j < n; j++)
+    define(r, set, NULL, in->mark + j);
+}
+
+void reachingDefinitions(ReachingDefs *r, IrFunc *f) {
+  IrBlock *b;
+  IrInstr *in;
+  int *globals, n, j, k, v;
+  varsInit(&r->vars, f);
+  globals = (int *)malloc((r->vars.numVars + 1) * sizeof(int));
+  r->numGlobals = 0;
+  for (v = 0; v < r->vars.numVars; v++)
+    if (r->vars.base[v] == IR_GP)
+      globals[r->numGlobals++] = v;
+  n = r->vars.numVars;
+  for (b = f->first; b != NULL; b = b->next)
+    for (in = b->first; in != NULL; in = in->next)
+      n += numDefsOf(r, in);
+  r->numDefs = n;
+  r->def = (IrInstr **)malloc((n + 1) * sizeof(IrInstr *));
+  r->var = (int *)malloc((n + 1) * sizeof(int));
+  for (v = 0; v < r->vars.numVars; v++) {
+    r->def[v] = NULL;
+    r->var[v] = v;
+  }
+  k = r->vars.numVars;
+  for (b = f->first; b != NULL; b = b->next)
+    for (in = b->first; in != NULL; in = in->next) {
+      n = numDefsOf(r, in);
+      in->mark = n > 0 ? k : -1;
+      for (j = 0; j < n; j++, k++) {
+        r->def[k] = in;
+        r->var[k] = in->op == IR_CALL ? globals[j] : varOf(&r->vars, in);
+      }
+    }
+  dfInit(&r->df, f, TRUE, FALSE, r->numDefs);
+  r->varDefs = (DfWord *)calloc((size_t)(r->vars.numVars + 1) * r->df.numWords,
+                                sizeof(DfWord));
+  for (k = 0; k < r->numDefs; k++)
+    dfSet(r->varDefs + (size_t)r->var[k] * r->df.numWords, k);
+  for (v = 0; v < r->vars.numVars; v++)
+    dfSet(r->df.boundary, v);
+  for (b = f->first; b != NULL; b = b->next)
+    for (in = b->first; in != NULL; in = in->next)
+      for (j = 0, n = numDefsOf(r, in); j < n; j++)
+        define(r, DF_SET(&r->df, r->df.gen, b), DF_SET(&r->df, r->df.kill, b),
+               in->mark + j);
+  dfSolve(&r->df, f);
+  free(globals);
+}
+
+void reachingDefsFree(ReachingDefs *r) {
+  dfFree(&r->df);
+  varsFree(&r->vars);
+  free(r->def);
+  free(r->var);
+  free(r->varDefs);
+}
+
+int aeIsExpr(IrInstr *in) {
+  switch (in->op) {
+  case IR_ADD:
+  case IR_SUB:
+  case IR_MUL:
+  case IR_DIV:
+  case IR_ADDI:
+  case IR_SET:
+  case IR_LOAD:
+    return TRUE;
+  default:
+    return FALSE;
+  }
+}
+
+/* killed applies to set what in kills: clears those
+ * facts, or, if add, sets them
+ */
+static void killed(AvailExprs *a, DfWord *set, IrInstr *in, int add) {
+  DfWord *kill = NULL;
+  int i, k;
+  if (in->op == IR_STORE && in->sym != NULL) {
+    for (k = a->varLoads[varOf(&a->vars, in)]; k != -1; k = a->nextLoad[k])
+      if (add)
+        dfSet(set, k);
+      else
+        dfClear(set, k);
+    return;
+  }
+  if (in->op == IR_STORE)
+    kill = a->arrayLoads;
+  else if (in->op == IR_CALL)
+    kill = a->callKills;
+  if (kill == NULL)
+    return;
+  for (i = 0; i < a->df.numWords; i++)
+    if (add)
+      set[i] |= kill[i];
+    else
+      set[i] &= ~kill[i];
+}
+
+void aeStep(AvailExprs *a, DfWord *set, IrInstr *in) {
+  killed(a, set, in, FALSE);
+  if (in->mark >= 0)
+    dfSet(set, in->mark);
+}
+
+void availableExpressions(AvailExprs *a, IrFunc *f) {
+  IrBlock *b;
+  IrInstr *in;
+  int n = 0, k, v;
+  varsInit(&a->vars, f);
+  for (b = f->first; b != NULL; b = b->next)
+    for (in = b->first; in != NULL; in = in->next)
+      n += aeIsExpr(in);
+  a->numExprs = n;
+  a->expr = (IrInstr **)malloc((n + 1) * sizeof(IrInstr *));
+  a->nextLoad = (int *)malloc((n + 1) * sizeof(int));
+  a->varLoads = (int *)malloc((a->vars.numVars + 1) * sizeof(int));
+  for (v = 0; v < a->vars.numVars; v++)
+    a->varLoads[v] = -1;
+  dfInit(&a->df, f, TRUE, TRUE, n);
+  a->arrayLoads = (DfWord *)calloc(a->df.numWords, sizeof(DfWord));
+  a->callKills = (DfWord *)calloc(a->df.numWords, sizeof(DfWord));
+  k = 0;
+  for (b = f->first; b != NULL; b = b->next)
+    for (in = b->first; in != NULL; in = in->next) {
+      in->mark = -1;
+      if (!aeIsExpr(in))
+        continue;
+      a->expr[k] = in;
+      a->nextLoad[k] = -1;
+      in->mark = k;
+      if (in->op == IR_LOAD) {
+        v = varOf(&a->vars, in);
+        if (v == -1) {
+          dfSet(a->arrayLoads, k);
+          dfSet(a->callKills, k);
+        } else {
+          a->nextLoad[k] = a->varLoads[v];
+          a->varLoads[v] = k;
+          if (a->vars.base[v] != IR_FP) /* the callee has its own frame */
+            dfSet(a->callKills, k);
+        }
+      }
+      k++;
+    }
+  for (b = f->first; b != NULL; b = b->next)
+    for (in = b->first; in != NULL; in = in->next) {
+      killed(a, DF_SET(&a->df, a->df.gen, b), in, FALSE);
+      killed(a, DF_SET(&a->df, a->df.kill, b), in, TRUE);
+      if (in->mark >= 0)
+        dfSet(DF_SET(&a->df, a->df.gen, b), in->mark);
+    }
+  dfSolve(&a->df, f);
+}
+
+void availExprsFree(AvailExprs *a) {
+  dfFree(&a->df);
+  varsFree(&a->vars);
+  free(a->expr);
+  free(a->nextLoad);
+  free(a->varLoads);
+  free(a->arrayLoads);
+  free(a->callKills);
+}
+
+/* intersect returns the nearest block dominating both
+ * x and y, walking up the dominators found so far
+ */
+static IrBlock *intersect(IrBlock *x, IrBlock *y) {
+  while (x != y) {
+    while (x->order > y->order)
+      x = x->idom;
+    while (y->order > x->order)
+      y = y->idom;
+  }
+  return x;
+}
+
+void computeDominators(IrFunc *f) {
+  IrBlock *b, **post, **stack, *succ[2];
+  int *next, top = 0, numPost = 0, i, n, changed;
+  for (b = f->first; b != NULL; b = b->next) {
+    b->order = -1;
+    b->idom = NULL;
+    b->mark = FALSE;
+  }
+  if (f->first == NULL)
+    return;
+  /* number the blocks in reverse postorder */
+  post = (IrBlock **)malloc(f->numBlocks * sizeof(IrBlock *));
+  stack = (IrBlock **)malloc(f->numBlocks * sizeof(IrBlock *));
+  next = (int *)calloc(f->numBlocks, sizeof(int));
+  stack[top++] = f->first;
+  f->first->mark = TRUE;
+  while (top > 0) {
+    b = stack[top - 1];
+    n = irSuccessors(b, succ);
+    if (next[b->id] < n) {
+      IrBlock *s = succ[next[b->id]++];
+      if (!s->mark) {
+        s->mark = TRUE;
+        stack[top++] = s;
+      }
+    } else {
+      post[numPost++] = b;
+      top--;
+    }
+  }
+  for (i = 0; i < numPost; i++)
+    post[i]->order = numPost - 1 - i;
+  /* Cooper, Harvey and Kennedy's iteration */
+  f->first->idom = f->first;
+  do {
+    changed = FALSE;
+    for (i = numPost - 2; i >= 0; i--) {
+      IrBlock *idom = NULL;
+      int k;
+      b = post[i];
+      for (k = 0; k < b->numPreds; k++) {
+        IrBlock *p = b->preds[k];
+        if (p->idom == NULL)
+          continue;
+        idom = idom == NULL ? p : intersect(p, idom);
+      }
+      if (idom != b->idom) {
+        b->idom = idom;
+        changed = TRUE;
+      }
+    }
+  } while (changed);
+  f->first->idom = NULL;
+  free(next);
+  free(stack);
+  free(post);
+}
+
+int dominates(IrBlock *a, IrBlock *b) {
+  if (a->order < 0 || b->order < 0)
+    return FALSE;
+  while (b != NULL && b != a)
+    b = b->idom;
+  return b == a;
+}
+
+IrBlock ***dominanceFrontiers(IrFunc *f) {
+  IrBlock ***df, *b, *runner;
+  int *count, *last, k, pass;
+  df = (IrBlock ***)arenaCalloc(f->arena, f->numBlocks * sizeof(IrBlock **));
+  count = (int *)calloc(f->numBlocks, sizeof(int));
+  last = (int *)malloc(f->numBlocks * sizeof(int));
+  /* count the frontiers, then fill them */
+  for (pass = 0; pass < 2; pass++) {
+    for (k = 0; k < f->numBlocks; k++)
+      last[k] = -1;
+    for (b = f->first; b != NULL; b = b->next) {
+      if (pass == 1)
+        df[b->id] = (IrBlock **)arenaAlloc(f->arena,
+                                           (count[b->id] + 1) * sizeof(IrBlock *));
+      count[b->id] = 0;
+    }
+    for (b = f->first; b != NULL; b = b->next) {
+      if (b->order < 0 || b->numPreds < 2)
+        continue;
+      for (k = 0; k < b->numPreds; k++)
+        for (runner = b->preds[k]; runner != NULL && runner->order >= 0 &&
+                                   runner != b->idom;
+             runner = runner->idom) {
+          if (last[runner->id] == b->id)
+            break;
+          last[runner->id] = b->id;
+          if (pass == 1)
+            df[runner->id][count[runner->id]] = b;
+          count[runner->id]++;
+        }
+    }
+  }
+  for (b = f->first; b != NULL; b = b->next)
+    df[b->id][count[b->id]] = NULL;
+  free(last);
+  free(count);
+  return df;
+}
@@ -0,0 +1,160 @@
+/****************************************************/
+/* File: dataflow.h                                 */
+/* Dataflow analysis over the blocks of the         */
+/* intermediate code (ir.h)                         */
+/****************************************************/
+
+#ifndef _DATAFLOW_H_
+#define _DATAFLOW_H_
+
+#include "ir.h"
+
+/* sets of facts, numbered from 0, one bit each */
+typedef unsigned long DfWord;
+#define DF_BITS ((int)(8 * sizeof(DfWord)))
+
+static inline int dfTest(const DfWord *s, int i) {
+  return (s[i / DF_BITS] >> (i % DF_BITS)) & 1;
+}
+
+static inline void dfSet(DfWord *s, int i) {
+  s[i / DF_BITS] |= (DfWord)1 << (i % DF_BITS);
+}
+
+static inline void dfClear(DfWord *s, int i) {
+  s[i / DF_BITS] &= ~((DfWord)1 << (i % DF_BITS));
+}
+
+/* a dataflow problem on the blocks of a function: a
+ * block gives out gen plus what it gets less kill,
+ * and gets the union (or, if intersect, the
+ * intersection) of what its neighbours give out.
+ * A forward problem flows along the edges, from
+ * boundary at the entry; a backward one against
+ * them, from boundary at the blocks that return.
+ * Sets are numWords words per block id.
+ */
+typedef struct {
+  int forward, intersect;
+  int numBits, numWords;
+  DfWord *gen, *kill; /* filled by the caller */
+  DfWord *in, *out;   /* the solution */
+  DfWord *boundary;
+} Dataflow;
+
+/* Procedure dfInit sets up the problem over numBits
+ * facts for f, with empty gen, kill and boundary
+ */
+void dfInit(Dataflow *d, IrFunc *f, int forward, int intersect, int numBits);
+
+/* Procedure dfSolve computes in and out of every block
+ * of f by a worklist, to the fixed point; the
+ * predecessors of f must be computed
+ */
+void dfSolve(Dataflow *d, IrFunc *f);
+
+void dfFree(Dataflow *d);
+
+/* the set of block b in the sets s of d */
+#define DF_SET(d, s, b) ((s) + (size_t)(b)->id * (d)->numWords)
+
+/* Procedure liveRegisters solves in d which virtual
+ * registers are live at the start (in) and end (out)
+ * of each block. A PHI argument counts as a use at
+ * the start of its block.
+ */
+void liveRegisters(Dataflow *d, IrFunc *f);
+
+/* the variables of a function, numbered: the places
+ * its LOADs and STOREs with a sym read and write, at
+ * an offset from fp or gp
+ */
+typedef struct {
+  int numVars;
+  int *base, *offset; /* of each variable */
+  int size, *slots;   /* hash table of the places */
+} IrVars;
+
+void varsInit(IrVars *v, IrFunc *f);
+void varsFree(IrVars *v);
+
+/* Function varOf returns the variable in reads or
+ * writes, -1 if it is none
+ */
+int varOf(IrVars *v, IrInstr *in);
+
+/* the definitions reaching each block: the STOREs to
+ * a variable, a call for each global, which it may
+ * store to, and one for the value each variable has
+ * on entry. reachingDefinitions sets the mark of an
+ * instruction to its (first) definition, -1 if it
+ * has none.
+ */
+typedef struct {
+  Dataflow df;
+  IrVars vars;
+  int numDefs;
+  int numGlobals;   /* definitions of each call */
+  IrInstr **def;    /* of each definition, NULL on entry */
+  int *var;         /* variable of each */
+  DfWord *varDefs;  /* numWords per variable: its defs */
+} ReachingDefs;
+
+void reachingDefinitions(ReachingDefs *r, IrFunc *f);
+void reachingDefsFree(ReachingDefs *r);
+
+/* Procedure rdStep makes set, the definitions reaching
+ * in, those reaching the instruction after it
+ */
+void rdStep(ReachingDefs *r, DfWord *set, IrInstr *in);
+
+/* the expressions available at each block: fact k is
+ * that the value expr[k] computed is still what it
+ * would compute, on every path. An instruction whose
+ * fact holds where the same expression comes again
+ * dominates it, so its register can stand for the
+ * new one. The facts are the pure operations and the
+ * loads; a load is killed by a store or call that
+ * may change what it reads. Registers have one
+ * definition each (SSA form), so an operand never
+ * changes. availableExpressions sets the mark of an
+ * instruction to its fact, -1 if it has none.
+ */
+typedef struct {
+  Dataflow df;
+  IrVars vars;
+  int numExprs;
+  IrInstr **expr;
+  int *varLoads;      /* first load of each variable */
+  int *nextLoad;      /* next load of the same one */
+  DfWord *arrayLoads; /* the loads without a sym */
+  DfWord *callKills;  /* the loads a call may change */
+} AvailExprs;
+
+void availableExpressions(AvailExprs *a, IrFunc *f);
+void availExprsFree(AvailExprs *a);
+
+/* Function aeIsExpr tells whether in computes an
+ * available expression
+ */
+int aeIsExpr(IrInstr *in);
+
+/* Procedure aeStep makes set, the facts holding before
+ * in, those holding after it
+ */
+void aeStep(AvailExprs *a, DfWord *set, IrInstr *in);
+
+/* Procedure computeDominators sets order and idom of
+ * every block of f; the predecessors must be computed.
+ * dominates tells whether a dominates b.
+ */
+void computeDominators(IrFunc *f);
+int dominates(IrBlock *a, IrBlock *b);
+
+/* Function dominanceFrontiers returns, for each block
+ * id, the list of blocks in its dominance frontier,
+ * ended by NULL, allocated in the arena of f
+ */
+IrBlock ***dominanceFrontiers(IrFunc *f);
+
+#endif
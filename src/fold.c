@@ -0,0 +1,205 @@
+/****************************************************/
+/* File: fold.c                                     */
+/* Constant folding and algebraic simplification    */
+/* of the C- syntax tree                            */
+/****************************************************/
+
+#include "fold.h"
+#include "../build/parser.h"
+#include "ast.h"
+#include <limits.h>
+
+static int isConst(TreeNode *t) {
+  return t != NULL && t->nodekind == ExpK && t->kind.exp == ConstK;
+}
+
+static int isConstValue(TreeNode *t, int v) {
+  return isConst(t) && t->attr.val == v;
+}
+
+/* droppable tells whether t may be left unevaluated:
+ * it calls nothing, assigns nothing and divides only
+ * by constants that cannot trap
+ */
+static int droppable(TreeNode *t) {
+  int i;
+  if (t == NULL)
+    return TRUE;
+  if (t->nodekind != ExpK || t->kind.exp == CallK || t->kind.exp == AssignK)
+    return FALSE;
+  if (t->kind.exp == OpK && t->attr.op == OVER &&
+      !(isConst(t->child[1]) && t->child[1]->attr.val != 0 &&
+        t->child[1]->attr.val != -1))
+    return FALSE;
+  for (i = 0; i < MAXCHILDREN; i++)
+    if (!droppable(t->child[i]))
+      return FALSE;
+  return TRUE;
+}
+
+/* sameValue tells whether the droppable expressions a
+ * and b always have the same value
+ */
+static int sameValue(TreeNode *a, TreeNode *b) {
+  if (a == NULL || b == NULL)
+    return a == b;
+  if (a->nodekind != ExpK || b->nodekind != ExpK ||
+      a->kind.exp != b->kind.exp)
+    return FALSE;
+  switch (a->kind.exp) {
+  case ConstK:
+    return a->attr.val == b->attr.val;
+  case IdK:
+  case VarK:
+    return a->symbol != NULL && a->symbol == b->symbol &&
+           a->isArray == b->isArray && sameValue(a->child[0], b->child[0]);
+  case OpK:
+    return a->attr.op == b->attr.op && sameValue(a->child[0], b->child[0]) &&
+           sameValue(a->child[1], b->child[1]);
+  default:
+    return FALSE;
+  }
+}
+
+/* evaluate computes a op b in *v as the TM does, with
+ * 32-bit registers that wrap around; it returns FALSE
+ * for a division the TM would trap on
+ */
+static int evaluate(TokenType op, int a, int b, int *v) {
+  unsigned int ua = (unsigned int)a, ub = (unsigned int)b;
+  switch (op) {
+  case PLUS:
+    *v = (int)(ua + ub);
+    break;
+  case MINUS:
+    *v = (int)(ua - ub);
+    break;
+  case TIMES:
+    *v = (int)(ua * ub);
+    break;
+  case OVER:
+    if (b == 0 || (a == INT_MIN && b == -1))
+      return FALSE;
+    *v = a / b;
+    break;
+  case LT:
+    *v = a < b;
+    break;
+  case LTE:
+    *v = a <= b;
+    break;
+  case GT:
+    *v = a > b;
+    break;
+  case GTE:
+    *v = a >= b;
+    break;
+  case EQQ:
+    *v = a == b;
+    break;
+  case NEQ:
+    *v = a != b;
+    break;
+  default:
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/* makeConst turns the operator t into the constant v */
+static TreeNode *makeConst(TreeNode *t, int v) {
+  int i;
+  t->kind.exp = ConstK;
+  t->attr.val = v;
+  for (i = 0; i < MAXCHILDREN; i++)
+    t->child[i] = NULL;
+  return t;
+}
+
+/* foldOp simplifies the operator t, whose operands are
+ * folded, and returns the node that replaces it
+ */
+static TreeNode *foldOp(TreeNode *t) {
+  TreeNode *l = t->child[0], *r = t->child[1];
+  int v;
+  if (r == NULL) { /* unary minus */
+    if (isConst(l) && evaluate(MINUS, 0, l->attr.val, &v))
+      return makeConst(t, v);
+    return t;
+  }
+  if (isConst(l) && isConst(r) && evaluate(t->attr.op, l->attr.val,
+                                           r->attr.val, &v))
+    return makeConst(t, v);
+  switch (t->attr.op) {
+  case PLUS:
+    if (isConstValue(r, 0))
+      return l;
+    if (isConstValue(l, 0))
+      return r;
+    break;
+  case MINUS:
+    if (isConstValue(r, 0))
+      return l;
+    if (droppable(l) && sameValue(l, r))
+      return makeConst(t, 0);
+    break;
+  case TIMES:
+    if (isConstValue(r, 1))
+      return l;
+    if (isConstValue(l, 1))
+      return r;
+    if ((isConstValue(r, 0) && droppable(l)) ||
+        (isConstValue(l, 0) && droppable(r)))
+      return makeConst(t, 0);
+    break;
+  case OVER:
+    if (isConstValue(r, 1))
+      return l;
+    break;
+  default:
+    break;
+  }
+  return t;
+}
+
+static TreeNode *foldChain(TreeNode *t);
+
+/* fold simplifies the subtree of t, leaving its
+ * siblings alone, and returns the node that replaces t
+ */
+static TreeNode *fold(TreeNode *t) {
+  int i;
+  for (i = 0; i < MAXCHILDREN; i++)
+    t->child[i] = foldChain(t->child[i]);
+  if (t->nodekind == ExpK && t->kind.exp == OpK)
+    return foldOp(t);
+  if (t->nodekind == StmtK && isConst(t->child[0])) {
+    /* code generation runs the branch left, if any */
+    if (t->kind.stmt == IfK)
+      t->child[t->child[0]->attr.val != 0 ? 2 : 1] = NULL;
+    else if (t->kind.stmt == WhileK && t->child[0]->attr.val == 0)
+      t->child[1] = NULL;
+  }
+  return t;
+}
+
+/* foldChain folds t and its siblings and returns the
+ * new head of the chain
+ */
+static TreeNode *foldChain(TreeNode *t) {
+  TreeNode *head = NULL, **link = &head;
+  while (t != NULL) {
+    TreeNode *next = t->sibling;
+    TreeNode *n = fold(t);
+    n->sibling = next;
+    *link = n;
+    link = &n->sibling;
+    t = next;
+  }
+  return head;
+}
+
+void foldConstants(TreeNode *syntaxTree) {
+  syntaxTree = foldChain(syntaxTree);
+  astBuild(&compactAst, syntaxTree);
+}
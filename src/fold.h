@@ -0,0 +1,27 @@
+/****************************************************/
+/* File: fold.h                                     */
+/* Constant folding and algebraic simplification    */
+/* of the C- syntax tree                            */
+/****************************************************/
+
+#ifndef _FOLD_H_
+#define _FOLD_H_
+
+#include "globals.h"
+
+/* Procedure foldConstants rewrites the analyzed tree
+ * rooted at syntaxTree (and its siblings) before code
+ * generation:
+ *  - an operator on constants becomes a constant,
+ *    computed as the TM does on 32-bit registers;
+ *    a division by 0 is left for the TM to trap;
+ *  - x+0, 0+x, x-0, x*1, 1*x and x/1 become x, and
+ *    x*0, 0*x and x-x become 0 when x can be dropped
+ *    (no call, assignment or division that may trap);
+ *  - the branch an if with a constant test never takes
+ *    and the body of a while whose test is 0 are cut.
+ * compactAst is laid out again for the new tree.
+ */
+void foldConstants(TreeNode *syntaxTree);
+
+#endif
@@ -10,6 +10,7 @@
 #define _GLOBALS_H_
 
 #include "../lib/log.h"
+#include "arena.h"
 #include "symtab.h"
 #include <ctype.h>
 #include <stdio.h>
@@ -30,20 +31,20 @@ typedef int TokenType;
 
 
 extern FILE *source;           /* source code text file */
-extern FILE *redundant_source; /* source code text file */
 extern FILE *listing;          /* listing output text file */
 extern FILE *code;             /* code text file for TM simulator */
 
-extern int lineno; /* source line number for listing */
+/* the scanner state below is per thread, so that pieces
+ * of the source can be scanned concurrently (pparse.c)
+ */
+extern _Thread_local FILE *redundant_source; /* source code text file */
+extern _Thread_local int lineno; /* source line number for listing */
 
 /**************************************************/
 /***********   Syntax tree for parsing ************/
 /**************************************************/
 
 
-// /* ExpType is used for type checking */
-typedef enum { Void, Integer, Boolean } ExpType;
-
 typedef enum { StmtK, ExpK, DeclK } NodeKind;
 
 typedef enum {
@@ -70,20 +71,25 @@ typedef enum {
   TypeSpecK // For storing INT or VOID
 } ExpKind;
 
+/* ScopeKind tells which construct opened a scope */
+typedef enum { GlobalScope, FunScope, BlockScope, IfScope, WhileScope } ScopeKind;
+
+/* A scopeList is the innermost frame of a chain that
+ * runs out to the global frame. Frames are never
+ * changed once pushed, so chains share their outer
+ * frames and entering a scope copies nothing.
+ */
 typedef struct scopeListRec {
   char *name;
-  char *type;
+  ScopeKind kind;
+  ScopeId scope; /* symbol table scope of the frame */
   int depth;
-  struct scopeListRec *end;
-  struct scopeListRec *next;
+  struct scopeListRec *outer;
 } *scopeList;
 
 #define MAXCHILDREN 3
 
 typedef struct treeNode {
-  struct treeNode *child[MAXCHILDREN];
-  struct treeNode *sibling;
-  int lineno;
   NodeKind nodekind;
   union {
     StmtKind stmt;
@@ -95,10 +101,14 @@ typedef struct treeNode {
     int val;
     char *name;
   } attr;
-  char *type; /* for type checking of exps */
-  char *typeReturn;
+  struct treeNode *child[MAXCHILDREN];
+  struct treeNode *sibling;
+  int lineno;
+  ExpType type; /* declared type; for type checking of exps */
+  ExpType typeReturn;
   int isArray;
-  scopeList nodeScopeList;
+  unsigned int id; /* index of the node in the compact AST (ast.h) */
+  BucketList symbol; /* record the identifier is bound to (analyze.c) */
 } TreeNode;
 
 /**************************************************/
@@ -136,5 +146,89 @@ extern int TraceCode;
 /* Error = TRUE prevents further passes if an error occurs */
 extern int Error;
 
-extern int FirstLine;
+extern _Thread_local int FirstLine;
+
+/**************************************************/
+/***********   Command-line options    ************/
+/**************************************************/
+
+/* DumpAstFile != NULL writes the syntax tree to that
+ * file after parsing (see astio.h)
+ */
+extern char *DumpAstFile;
+
+/* LoadAstFile != NULL reads the syntax tree from that
+ * file instead of scanning and parsing the source
+ */
+extern char *LoadAstFile;
+
+/* ParseThreads > 1 scans and parses the top-level
+ * declarations of the source in that many pieces
+ * at once (see pparse.h)
+ */
+extern int ParseThreads;
+
+/* HandParser = TRUE parses with the hand-written
+ * recursive-descent parser (rdparse.h) instead of
+ * the bison one
+ */
+extern int HandParser;
+
+/* SymtabStats = TRUE prints the symbol table sizes and
+ * probe-length histograms to stderr after analysis
+ */
+extern int SymtabStats;
+
+/* TwoPassAnalysis = TRUE builds the symbol table and
+ * type checks in two traversals (buildSymtab, then
+ * typeCheck) instead of the fused one (analyze)
+ */
+extern int TwoPassAnalysis;
+
+/* SemanticThreads > 1 analyzes the function bodies on
+ * that many threads once the global declarations are
+ * in the symbol table (see panalyze.h)
+ */
+extern int SemanticThreads;
+
+/* StreamCompile = TRUE compiles each top-level
+ * declaration as soon as it is parsed and frees it
+ * (see stream.h)
+ */
+extern int StreamCompile;
+
+/* KeepUnusedFunctions = TRUE generates code for the
+ * functions main never calls, which are otherwise left
+ * out (see callgraph.h)
+ */
+extern int KeepUnusedFunctions;
+
+/* PrintCallGraph = TRUE lists the call graph to stderr
+ * before code generation
+ */
+extern int PrintCallGraph;
+
+/* PeepholeRules names the peephole rules to apply to
+ * the code, comma separated, or none; NULL applies
+ * them all (see peephole.h)
+ */
+extern char *PeepholeRules;
+
+/* DumpIr = TRUE lists the intermediate code of each
+ * function to stderr, as it goes to the register
+ * allocator (see ir.h)
+ */
+extern int DumpIr;
+
+/* IrPasses names the passes to run over the
+ * intermediate code, comma separated, or none; NULL
+ * runs them all (see ir.c)
+ */
+extern char *IrPasses;
+
+/* UnrollFactor is the most copies of its body a
+ * counted while loop runs per test (see unroll.h);
+ * 1 unrolls none
+ */
+extern int UnrollFactor;
 #endif
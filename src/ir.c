@@ -0,0 +1,390 @@
+/****************************************************/
+/* File: ir.c                                       */
+/* Three-address intermediate code of a C- function */
+/* between the syntax tree and the TM code          */
+/****************************************************/
+
+#include "ir.h"
+#include "iropt.h"
+#include "loops.h"
+#include "ssa.h"
+#include <string.h>
+
+IrFunc *irNewFunc(TreeNode *decl, Arena *arena) {
+  IrFunc *f = (IrFunc *)arenaCalloc(arena, sizeof(IrFunc));
+  f->decl = decl;
+  f->name = decl->attr.name;
+  f->isMain = strcmp(decl->attr.name, "main") == 0;
+  f->sizeOfVars = decl->symbol->sizeOfVars;
+  f->numVregs = IR_FIRST;
+  f->arena = arena;
+  return f;
+}
+
+IrBlock *irNewBlock(IrFunc *f, const char *comment) {
+  IrBlock *b = (IrBlock *)arenaCalloc(f->arena, sizeof(IrBlock));
+  b->id = f->numBlocks++;
+  b->comment = comment;
+  return b;
+}
+
+void irPlaceBlock(IrFunc *f, IrBlock *b) {
+  b->prev = f->last;
+  b->next = NULL;
+  if (f->last == NULL)
+    f->first = b;
+  else
+    f->last->next = b;
+  f->last = b;
+}
+
+void irPlaceBlockAfter(IrFunc *f, IrBlock *b, IrBlock *after) {
+  b->prev = after;
+  b->next = after->next;
+  if (after->next == NULL)
+    f->last = b;
+  else
+    after->next->prev = b;
+  after->next = b;
+}
+
+void irUnplaceBlock(IrFunc *f, IrBlock *b) {
+  if (b->prev == NULL)
+    f->first = b->next;
+  else
+    b->prev->next = b->next;
+  if (b->next == NULL)
+    f->last = b->prev;
+  else
+    b->next->prev = b->prev;
+  b->prev = b->next = NULL;
+}
+
+int irNewVreg(IrFunc *f) { return f->numVregs++; }
+
+static IrInstr *newInstr(IrFunc *f, IrBlock *b, IrOp op) {
+  IrInstr *in = (IrInstr *)arenaCalloc(f->arena, sizeof(IrInstr));
+  in->op = op;
+  in->dst = in->a = in->b = IR_NONE;
+  in->block = b;
+  in->mark = -1;
+  return in;
+}
+
+IrInstr *irAppend(IrFunc *f, IrBlock *b, IrOp op) {
+  IrInstr *in = newInstr(f, b, op);
+  in->prev = b->last;
+  if (b->last == NULL)
+    b->first = in;
+  else
+    b->last->next = in;
+  b->last = in;
+  return in;
+}
+
+IrInstr *irInsertBefore(IrFunc *f, IrInstr *at, IrOp op) {
+  IrInstr *in = newInstr(f, at->block, op);
+  in->prev = at->prev;
+  in->next = at;
+  if (at->prev == NULL)
+    at->block->first = in;
+  else
+    at->prev->next = in;
+  at->prev = in;
+  return in;
+}
+
+IrInstr *irInsertAfter(IrFunc *f, IrInstr *at, IrOp op) {
+  IrInstr *in = newInstr(f, at->block, op);
+  in->prev = at;
+  in->next = at->next;
+  if (at->next == NULL)
+    at->block->last = in;
+  else
+    at->next->prev = in;
+  at->next = in;
+  return in;
+}
+
+IrInstr *irNewPhi(IrFunc *f, IrBlock *b, int var) {
+  IrInstr *in = newInstr(f, b, IR_PHI);
+  int k;
+  in->imm = var;
+  in->numArgs = b->numPreds;
+  in->args = (int *)arenaAlloc(f->arena, (b->numPreds + 1) * sizeof(int));
+  for (k = 0; k < b->numPreds; k++)
+    in->args[k] = IR_NONE;
+  in->next = b->first;
+  if (b->first == NULL)
+    b->last = in;
+  else
+    b->first->prev = in;
+  b->first = in;
+  return in;
+}
+
+void irRemove(IrInstr *in) {
+  IrBlock *b = in->block;
+  if (in->prev == NULL)
+    b->first = in->next;
+  else
+    in->prev->next = in->next;
+  if (in->next == NULL)
+    b->last = in->prev;
+  else
+    in->next->prev = in->prev;
+  in->prev = in->next = NULL;
+}
+
+int irIsTerminator(IrOp op) {
+  return op == IR_RET || op == IR_JUMP || op == IR_BR;
+}
+
+int irNumUses(IrInstr *in) {
+  if (in->op == IR_PHI)
+    return in->numArgs;
+  return (in->a != IR_NONE) + (in->b != IR_NONE);
+}
+
+int *irUse(IrInstr *in, int k) {
+  if (in->op == IR_PHI)
+    return &in->args[k];
+  return k == 0 && in->a != IR_NONE ? &in->a : &in->b;
+}
+
+int irHasEffect(IrInstr *in) {
+  switch (in->op) {
+  case IR_CONST:
+  case IR_MOV:
+  case IR_ADD:
+  case IR_SUB:
+  case IR_MUL:
+  case IR_ADDI:
+  case IR_SET:
+  case IR_PHI:
+    return FALSE;
+  case IR_LOAD: /* a variable of the frame, or a global one */
+    return in->sym == NULL;
+  default:
+    return TRUE;
+  }
+}
+
+int irSuccessors(IrBlock *b, IrBlock *succ[2]) {
+  IrInstr *t = b->last;
+  if (t == NULL || t->op == IR_RET)
+    return 0;
+  succ[0] = t->target;
+  if (t->op == IR_JUMP || t->other == t->target)
+    return 1;
+  succ[1] = t->other;
+  return 2;
+}
+
+void irComputePreds(IrFunc *f) {
+  IrBlock *b, *succ[2];
+  int i, n;
+  for (b = f->first; b != NULL; b = b->next)
+    b->numPreds = 0;
+  for (b = f->first; b != NULL; b = b->next) {
+    n = irSuccessors(b, succ);
+    for (i = 0; i < n; i++)
+      succ[i]->numPreds++;
+  }
+  for (b = f->first; b != NULL; b = b->next) {
+    b->preds = (IrBlock **)arenaAlloc(f->arena,
+                                      (b->numPreds + 1) * sizeof(IrBlock *));
+    b->numPreds = 0;
+  }
+  for (b = f->first; b != NULL; b = b->next) {
+    n = irSuccessors(b, succ);
+    for (i = 0; i < n; i++)
+      succ[i]->preds[succ[i]->numPreds++] = b;
+  }
+}
+
+void irRemovePred(IrBlock *b, IrBlock *pred) {
+  IrInstr *in;
+  int k, j;
+  for (k = 0; k < b->numPreds && b->preds[k] != pred; k++)
+    ;
+  if (k == b->numPreds)
+    return;
+  for (j = k; j + 1 < b->numPreds; j++)
+    b->preds[j] = b->preds[j + 1];
+  b->numPreds--;
+  for (in = b->first; in != NULL && in->op == IR_PHI; in = in->next) {
+    for (j = k; j + 1 < in->numArgs; j++)
+      in->args[j] = in->args[j + 1];
+    in->numArgs--;
+  }
+}
+
+static const char *opNames[] = {"const", "mov",  "add",   "sub", "mul",
+                                "div",   "addi", "set",   "load", "store",
+                                "in",    "out",  "arg",   "call", "ret",
+                                "jump",  "br",   "phi"};
+
+static const char *condNames[] = {"<", "<=", ">", ">=", "==", "!="};
+
+static void dumpReg(FILE *out, int v) {
+  if (v == IR_FP)
+    fprintf(out, "fp");
+  else if (v == IR_GP)
+    fprintf(out, "gp");
+  else
+    fprintf(out, "v%d", v);
+}
+
+static void dumpInstr(FILE *out, IrInstr *in) {
+  int k;
+  fprintf(out, "  ");
+  if (in->dst != IR_NONE) {
+    dumpReg(out, in->dst);
+    fprintf(out, " = ");
+  }
+  fprintf(out, "%s", opNames[in->op]);
+  switch (in->op) {
+  case IR_CONST:
+    fprintf(out, " %d", in->imm);
+    break;
+  case IR_LOAD:
+  case IR_STORE:
+    fprintf(out, " [");
+    dumpReg(out, in->a);
+    fprintf(out, "%+d]", in->imm);
+    if (in->op == IR_STORE) {
+      fprintf(out, ", ");
+      dumpReg(out, in->b);
+    }
+    break;
+  case IR_ADDI:
+    fprintf(out, " ");
+    dumpReg(out, in->a);
+    fprintf(out, ", %d", in->imm);
+    break;
+  case IR_SET:
+  case IR_BR:
+    fprintf(out, " ");
+    dumpReg(out, in->a);
+    fprintf(out, " %s 0", condNames[in->cond]);
+    if (in->op == IR_BR)
+      fprintf(out, ", L%d, L%d", in->target->id, in->other->id);
+    break;
+  case IR_JUMP:
+    fprintf(out, " L%d", in->target->id);
+    break;
+  case IR_ARG:
+    fprintf(out, " %d, ", in->imm);
+    dumpReg(out, in->a);
+    break;
+  case IR_CALL:
+    fprintf(out, " %s/%d", in->sym != NULL ? in->sym->name : "?", in->imm);
+    break;
+  case IR_PHI:
+    for (k = 0; k < in->numArgs; k++) {
+      fprintf(out, "%s[L%d: ", k == 0 ? " " : ", ", in->block->preds[k]->id);
+      dumpReg(out, in->args[k]);
+      fprintf(out, "]");
+    }
+    break;
+  default:
+    if (in->a != IR_NONE) {
+      fprintf(out, " ");
+      dumpReg(out, in->a);
+    }
+    if (in->b != IR_NONE) {
+      fprintf(out, ", ");
+      dumpReg(out, in->b);
+    }
+    break;
+  }
+  if (in->sym != NULL && in->op != IR_CALL)
+    fprintf(out, "\t; %s", in->sym->name);
+  fprintf(out, "\n");
+}
+
+void irDump(FILE *out, IrFunc *f) {
+  IrBlock *b;
+  IrInstr *in;
+  fprintf(out, "function %s: %d blocks, %d registers, %d variables\n",
+          f->name, f->numBlocks, f->numVregs - IR_FIRST, f->sizeOfVars);
+  for (b = f->first; b != NULL; b = b->next) {
+    fprintf(out, "L%d:", b->id);
+    if (b->comment != NULL)
+      fprintf(out, "\t; %s", b->comment);
+    fprintf(out, "\n");
+    for (in = b->first; in != NULL; in = in->next)
+      dumpInstr(out, in);
+  }
+}
+
+/* a pass of the optimizer: IrPasses names it */
+typedef struct {
+  const char *name;
+  void (*run)(IrFunc *f);
+} IrPass;
+
+/* the passes, in the order they run; a pass may come
+ * more than once, to clean up after the others. The
+ * "ssa" ones put f in SSA form and take it out.
+ */
+static IrPass passes[] = {
+    {"simplify", simplifyCfg}, {"ssa", enterSsa},
+    {"fold", foldIr},          {"forward", forwardStores},
+    {"cse", eliminateCommonSubexpressions},
+    {"fold", foldIr},          {"dce", removeDeadCode},
+    {"licm", hoistInvariants}, {"strength", reduceStrength},
+    {"fold", foldIr},          {"dce", removeDeadCode},
+    {"ssa", leaveSsa},         {"simplify", simplifyCfg}};
+
+#define NUM_PASSES ((int)(sizeof(passes) / sizeof(passes[0])))
+
+/* Function passNamed tells whether the comma separated
+ * list names names the pass name
+ */
+static int passNamed(const char *names, const char *name) {
+  const char *p = names;
+  while (*p != '\0') {
+    size_t len = strcspn(p, ",");
+    if ((len == 3 && strncmp(p, "all", 3) == 0) ||
+        (strlen(name) == len && strncmp(p, name, len) == 0))
+      return TRUE;
+    p += len;
+    if (*p == ',')
+      p++;
+  }
+  return FALSE;
+}
+
+/* Procedure checkNames reports the names in IrPasses
+ * that are no pass
+ */
+static void checkNames(void) {
+  const char *p = IrPasses;
+  while (*p != '\0') {
+    size_t len = strcspn(p, ",");
+    int k, found = (len == 3 && strncmp(p, "all", 3) == 0) ||
+                   (len == 4 && strncmp(p, "none", 4) == 0);
+    for (k = 0; k < NUM_PASSES; k++)
+      if (strlen(passes[k].name) == len && strncmp(p, passes[k].name, len) == 0)
+        found = TRUE;
+    if (!found)
+      fprintf(stderr, "unknown pass %.*s\n", (int)len, p);
+    p += len;
+    if (*p == ',')
+      p++;
+  }
+}
+
+void irOptimize(IrFunc *f) {
+  static int checked = FALSE;
+  int k;
+  if (IrPasses != NULL && !checked) {
+    checkNames();
+    checked = TRUE;
+  }
+  for (k = 0; k < NUM_PASSES; k++)
+    if (IrPasses == NULL || passNamed(IrPasses, passes[k].name))
+      passes[k].run(f);
+}
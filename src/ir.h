@@ -0,0 +1,202 @@
+/****************************************************/
+/* File: ir.h                                       */
+/* Three-address intermediate code of a C- function */
+/* between the syntax tree and the TM code          */
+/****************************************************/
+
+#ifndef _IR_H_
+#define _IR_H_
+
+#include "globals.h"
+
+/* virtual registers 0 and 1 stand for the frame
+ * pointer and the global pointer; the others are
+ * numbered from IR_FIRST on
+ */
+#define IR_FP 0
+#define IR_GP 1
+#define IR_FIRST 2
+#define IR_NONE (-1)
+
+/* operations, with dst = d and operands a, b:
+ *  CONST  d = imm
+ *  MOV    d = a
+ *  ADD, SUB, MUL, DIV
+ *         d = a op b, as the TM does on registers
+ *  ADDI   d = a + imm
+ *  SET    d = 1 if a cond 0, else 0
+ *  LOAD   d = mem[a + imm]
+ *  STORE  mem[a + imm] = b
+ *  IN     d = a number read
+ *  OUT    writes a
+ *  ARG    a is argument imm of the IR_CALL that follows
+ *  CALL   d = the value sym returns, imm arguments
+ *  RET    returns a, or nothing if a is IR_NONE
+ *  JUMP   goes to target
+ *  BR     goes to target if a cond 0, else to other
+ *  PHI    d = args[k] coming from block->preds[k], for
+ *         the variable imm (its memloc), in SSA form
+ * JUMP, BR and RET end a block, and only they do; the
+ * PHIs of a block come first.
+ */
+typedef enum {
+  IR_CONST,
+  IR_MOV,
+  IR_ADD,
+  IR_SUB,
+  IR_MUL,
+  IR_DIV,
+  IR_ADDI,
+  IR_SET,
+  IR_LOAD,
+  IR_STORE,
+  IR_IN,
+  IR_OUT,
+  IR_ARG,
+  IR_CALL,
+  IR_RET,
+  IR_JUMP,
+  IR_BR,
+  IR_PHI
+} IrOp;
+
+/* tests of a value against 0 */
+typedef enum { IR_LT, IR_LE, IR_GT, IR_GE, IR_EQ, IR_NE } IrCond;
+
+typedef struct IrInstrRec {
+  IrOp op;
+  IrCond cond;
+  int dst, a, b; /* virtual registers, IR_NONE if unused */
+  int imm;
+  int *args, numArgs; /* of a PHI */
+  /* the scalar variable a LOAD or STORE reads or
+   * writes, the function a CALL calls; NULL if none
+   */
+  BucketList sym;
+  struct IrBlockRec *target, *other;
+  const char *comment; /* for the TM code */
+  struct IrBlockRec *block;
+  struct IrInstrRec *prev, *next;
+  int mark; /* free for the passes */
+} IrInstr;
+
+typedef struct IrBlockRec {
+  int id;
+  const char *comment; /* for the TM code */
+  IrInstr *first, *last; /* last is the terminator */
+  struct IrBlockRec **preds; /* see irComputePreds */
+  int numPreds;
+  struct IrBlockRec *prev, *next; /* in layout order */
+  /* set by computeDominators (dataflow.h) */
+  struct IrBlockRec *idom; /* NULL for the entry */
+  int order; /* in reverse postorder, -1 if unreachable */
+  int mark; /* free for the passes */
+} IrBlock;
+
+/* a function: its blocks in the order the code is
+ * laid out, the first one being the entry. Until it
+ * leaves SSA form (see ssa.h) every virtual register
+ * has one definition, which comes before its uses on
+ * every path from the entry; after, a register may
+ * be set by the copies that replace a PHI.
+ */
+typedef struct {
+  TreeNode *decl;
+  char *name;
+  int isMain;
+  int sizeOfVars; /* of the variables of the frame */
+  IrBlock *first, *last;
+  int numBlocks; /* block ids handed out */
+  int numVregs;  /* virtual registers handed out */
+  int inSsa;     /* PHIs may be there, preds kept up */
+  /* set by allocRegisters (regalloc.h) */
+  int frameSize; /* sizeOfVars plus spill slots */
+  int *reg;      /* TM register of each virtual one */
+  Arena *arena;  /* holds the function */
+} IrFunc;
+
+/* Function irNewFunc starts the function declared by
+ * decl, allocated in arena, with no blocks yet
+ */
+IrFunc *irNewFunc(TreeNode *decl, Arena *arena);
+
+/* Function irNewBlock returns an empty block of f that
+ * is not laid out yet (see irPlaceBlock)
+ */
+IrBlock *irNewBlock(IrFunc *f, const char *comment);
+
+/* Procedure irPlaceBlock lays b out after the last
+ * block of f, irPlaceBlockAfter right after the block
+ * after; irUnplaceBlock takes it out of f
+ */
+void irPlaceBlock(IrFunc *f, IrBlock *b);
+void irPlaceBlockAfter(IrFunc *f, IrBlock *b, IrBlock *after);
+void irUnplaceBlock(IrFunc *f, IrBlock *b);
+
+/* Function irNewVreg returns a new virtual register */
+int irNewVreg(IrFunc *f);
+
+/* Function irAppend adds an instruction op at the end
+ * of b, irInsertBefore and irInsertAfter next to at;
+ * every register field is IR_NONE and the rest 0
+ */
+IrInstr *irAppend(IrFunc *f, IrBlock *b, IrOp op);
+IrInstr *irInsertBefore(IrFunc *f, IrInstr *at, IrOp op);
+IrInstr *irInsertAfter(IrFunc *f, IrInstr *at, IrOp op);
+
+/* Function irNewPhi adds at the start of b a PHI for
+ * the variable var, with an argument per predecessor
+ * of b, all IR_NONE
+ */
+IrInstr *irNewPhi(IrFunc *f, IrBlock *b, int var);
+
+/* Procedure irRemove unlinks in from its block */
+void irRemove(IrInstr *in);
+
+/* Function irIsTerminator tells whether op ends a
+ * block
+ */
+int irIsTerminator(IrOp op);
+
+/* Function irNumUses returns how many registers in
+ * reads, and irUse where the k-th of them is, for a
+ * pass to read or replace it
+ */
+int irNumUses(IrInstr *in);
+int *irUse(IrInstr *in, int k);
+
+/* Function irHasEffect tells whether in must run even
+ * if its result goes unused: it writes memory, does
+ * input or output, calls, ends a block or may stop
+ * the TM (a division by 0, a load out of memory)
+ */
+int irHasEffect(IrInstr *in);
+
+/* Function irSuccessors stores the blocks b may go to
+ * next in succ and returns how many there are
+ */
+int irSuccessors(IrBlock *b, IrBlock *succ[2]);
+
+/* Procedure irComputePreds sets the predecessors of
+ * every block of f
+ */
+void irComputePreds(IrFunc *f);
+
+/* Procedure irRemovePred takes pred out of the
+ * predecessors of b, with the PHI arguments coming
+ * from it
+ */
+void irRemovePred(IrBlock *b, IrBlock *pred);
+
+/* Procedure irDump lists f to out, one instruction
+ * per line, virtual registers as v<n>
+ */
+void irDump(FILE *out, IrFunc *f);
+
+/* Procedure irOptimize runs over f the passes that
+ * IrPasses names, in the order of the pass table
+ * (see ir.c)
+ */
+void irOptimize(IrFunc *f);
+
+#endif
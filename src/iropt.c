@@ -0,0 +1,542 @@
+/****************************************************/
+/* File: iropt.c                                    */
+/* Passes of the optimizer over the intermediate    */
+/* code (ir.h)                                      */
+/****************************************************/
+
+#include "iropt.h"
+#include "dataflow.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Procedure markReachable sets mark on the blocks a
+ * path from the entry reaches, and clears it on the
+ * others
+ */
+static void markReachable(IrFunc *f) {
+  IrBlock *b, *succ[2], **stack;
+  int top = 0, i, n;
+  for (b = f->first; b != NULL; b = b->next)
+    b->mark = FALSE;
+  if (f->first == NULL)
+    return;
+  stack = (IrBlock **)malloc(f->numBlocks * sizeof(IrBlock *));
+  f->first->mark = TRUE;
+  stack[top++] = f->first;
+  while (top > 0) {
+    n = irSuccessors(stack[--top], succ);
+    for (i = 0; i < n; i++)
+      if (!succ[i]->mark) {
+        succ[i]->mark = TRUE;
+        stack[top++] = succ[i];
+      }
+  }
+  free(stack);
+}
+
+/* forward returns where a jump to b ends up, going
+ * through the blocks that only jump on
+ */
+static IrBlock *forward(IrFunc *f, IrBlock *b) {
+  int steps = 0;
+  while (b->first != NULL && b->first->op == IR_JUMP &&
+         b->first->target != b && steps++ < f->numBlocks)
+    b = b->first->target;
+  return b;
+}
+
+int removeUnreachableBlocks(IrFunc *f) {
+  IrBlock *b, *next, *succ[2];
+  int removed = FALSE, i, n;
+  markReachable(f);
+  for (b = f->first; b != NULL; b = next) {
+    next = b->next;
+    if (!b->mark) {
+      n = irSuccessors(b, succ);
+      for (i = 0; i < n; i++)
+        irRemovePred(succ[i], b);
+      irUnplaceBlock(f, b);
+      removed = TRUE;
+    }
+  }
+  return removed;
+}
+
+void simplifyCfg(IrFunc *f) {
+  IrBlock *b, *c;
+  IrInstr *t, *in;
+  int changed;
+  if (f->inSsa) /* the PHIs go by the predecessors */
+    return;
+  do {
+    changed = removeUnreachableBlocks(f);
+    for (b = f->first; b != NULL; b = b->next) {
+      t = b->last;
+      if (t->op != IR_JUMP && t->op != IR_BR)
+        continue;
+      if (forward(f, t->target) != t->target) {
+        t->target = forward(f, t->target);
+        changed = TRUE;
+      }
+      if (t->op == IR_BR) {
+        if (forward(f, t->other) != t->other) {
+          t->other = forward(f, t->other);
+          changed = TRUE;
+        }
+        if (t->target == t->other) {
+          t->op = IR_JUMP;
+          t->a = IR_NONE;
+          t->other = NULL;
+          changed = TRUE;
+        }
+      }
+    }
+    /* merge a block into the only one jumping to it */
+    irComputePreds(f);
+    for (b = f->first; b != NULL;) {
+      IrBlock *succ[2];
+      int i, k, n;
+      t = b->last;
+      c = t->op == IR_JUMP ? t->target : NULL;
+      if (c == NULL || c == b || c == f->first || c->numPreds != 1) {
+        b = b->next;
+        continue;
+      }
+      irRemove(t);
+      for (in = c->first; in != NULL; in = in->next)
+        in->block = b;
+      if (b->last == NULL)
+        b->first = c->first;
+      else
+        b->last->next = c->first;
+      c->first->prev = b->last;
+      b->last = c->last;
+      c->first = c->last = NULL;
+      /* the successors of c now follow b */
+      n = irSuccessors(b, succ);
+      for (i = 0; i < n; i++)
+        for (k = 0; k < succ[i]->numPreds; k++)
+          if (succ[i]->preds[k] == c)
+            succ[i]->preds[k] = b;
+      irUnplaceBlock(f, c);
+      changed = TRUE;
+    }
+  } while (changed);
+}
+
+/* defs[v] is the instruction defining v, NULL if none */
+static IrInstr **defs;
+
+/* phiArg[v] tells whether a PHI reads v */
+static char *phiArg;
+
+/* Function throughAddi tells whether a use of v may
+ * take the operand of the ADDI defining v instead. Not
+ * when a PHI reads v, as the step of a loop: v lives
+ * on anyway, and both would be live at once.
+ */
+static int throughAddi(int v) {
+  return v >= IR_FIRST && defs[v] != NULL && defs[v]->op == IR_ADDI &&
+         !phiArg[v];
+}
+
+static int isConst(int v, int *value) {
+  if (v < IR_FIRST || defs[v] == NULL || defs[v]->op != IR_CONST)
+    return FALSE;
+  *value = defs[v]->imm;
+  return TRUE;
+}
+
+/* holds evaluates the test of a against 0 */
+static int holds(IrCond cond, int a) {
+  switch (cond) {
+  case IR_LT:
+    return a < 0;
+  case IR_LE:
+    return a <= 0;
+  case IR_GT:
+    return a > 0;
+  case IR_GE:
+    return a >= 0;
+  case IR_EQ:
+    return a == 0;
+  default:
+    return a != 0;
+  }
+}
+
+static void makeConst(IrInstr *in, int value) {
+  in->op = IR_CONST;
+  in->imm = value;
+  in->a = in->b = IR_NONE;
+}
+
+static void makeAddi(IrInstr *in, int a, int imm) {
+  in->op = IR_ADDI;
+  in->a = a;
+  in->b = IR_NONE;
+  in->imm = imm;
+}
+
+static void makeMov(IrInstr *in, int a) {
+  in->op = IR_MOV;
+  in->a = a;
+  in->b = IR_NONE;
+}
+
+/* propagate returns what v is a copy of */
+static int propagate(int v) {
+  while (v >= IR_FIRST && defs[v] != NULL && defs[v]->op == IR_MOV)
+    v = defs[v]->a;
+  return v;
+}
+
+/* foldPhi makes a copy of the PHI in when its
+ * arguments other than itself are all one register,
+ * and tells whether it did. The arguments stay
+ * virtual registers, not fp or gp.
+ */
+static int foldPhi(IrFunc *f, IrInstr *in) {
+  IrInstr *at, *mov;
+  int k, v, x = IR_NONE, changed = FALSE;
+  for (k = 0; k < in->numArgs; k++) {
+    v = propagate(in->args[k]);
+    if (v != in->args[k] && v >= IR_FIRST) {
+      in->args[k] = v;
+      changed = TRUE;
+    }
+    if (in->args[k] == in->dst || in->args[k] == x)
+      continue;
+    if (x != IR_NONE)
+      return changed;
+    x = in->args[k];
+  }
+  if (x == IR_NONE)
+    return changed;
+  for (at = in; at->op == IR_PHI; at = at->next)
+    ;
+  mov = irInsertBefore(f, at, IR_MOV);
+  mov->dst = in->dst;
+  mov->a = x;
+  mov->comment = in->comment;
+  defs[in->dst] = mov;
+  irRemove(in);
+  return TRUE;
+}
+
+/* foldInstr simplifies in and tells whether it did */
+static int foldInstr(IrFunc *f, IrInstr *in) {
+  int a = in->a, b = in->b, x = 0, y = 0, ca, cb;
+  unsigned int ux, uy;
+  if (in->op == IR_PHI)
+    return foldPhi(f, in);
+  if (a != IR_NONE)
+    in->a = propagate(a);
+  if (b != IR_NONE)
+    in->b = propagate(b);
+  int changed = in->a != a || in->b != b;
+  a = in->a;
+  b = in->b;
+  ca = a != IR_NONE && isConst(a, &x);
+  cb = b != IR_NONE && isConst(b, &y);
+  ux = (unsigned int)x;
+  uy = (unsigned int)y;
+  switch (in->op) {
+  case IR_MOV:
+    if (!ca)
+      return changed;
+    makeConst(in, x);
+    return TRUE;
+  case IR_ADD:
+    if (ca && cb)
+      makeConst(in, (int)(ux + uy));
+    else if (cb)
+      makeAddi(in, a, y);
+    else if (ca)
+      makeAddi(in, b, x);
+    else
+      return changed;
+    return TRUE;
+  case IR_SUB:
+    if (ca && cb)
+      makeConst(in, (int)(ux - uy));
+    else if (cb)
+      makeAddi(in, a, (int)(0u - uy));
+    else
+      return changed;
+    return TRUE;
+  case IR_MUL:
+    if (ca && cb)
+      makeConst(in, (int)(ux * uy));
+    else if ((ca && x == 0) || (cb && y == 0))
+      makeConst(in, 0);
+    else if (cb && y == 1)
+      makeMov(in, a);
+    else if (ca && x == 1)
+      makeMov(in, b);
+    else
+      return changed;
+    return TRUE;
+  case IR_DIV:
+    if (!cb || y == 0 || (y == -1 && !(ca && x != INT_MIN)))
+      return changed;
+    if (ca)
+      makeConst(in, x / y);
+    else if (y == 1)
+      makeMov(in, a);
+    else
+      return changed;
+    return TRUE;
+  case IR_ADDI:
+    if (ca)
+      makeConst(in, (int)(ux + (unsigned int)in->imm));
+    else if (in->imm == 0)
+      makeMov(in, a);
+    else if (throughAddi(a)) {
+      in->imm = (int)((unsigned int)in->imm + (unsigned int)defs[a]->imm);
+      in->a = defs[a]->a;
+    } else
+      return changed;
+    return TRUE;
+  case IR_SET:
+    if (!ca)
+      return changed;
+    makeConst(in, holds(in->cond, x));
+    return TRUE;
+  case IR_LOAD:
+  case IR_STORE:
+    if (!throughAddi(a))
+      return changed;
+    in->imm = (int)((unsigned int)in->imm + (unsigned int)defs[a]->imm);
+    in->a = defs[a]->a;
+    return TRUE;
+  case IR_BR:
+    if (!ca)
+      return changed;
+    in->op = IR_JUMP;
+    if (!holds(in->cond, x)) {
+      IrBlock *t = in->target;
+      in->target = in->other;
+      in->other = t;
+    }
+    if (in->other != in->target)
+      irRemovePred(in->other, in->block);
+    in->other = NULL;
+    in->a = IR_NONE;
+    return TRUE;
+  default:
+    return changed;
+  }
+}
+
+void foldIr(IrFunc *f) {
+  IrBlock *b;
+  IrInstr *in, *next;
+  int changed, k;
+  defs = (IrInstr **)calloc(f->numVregs, sizeof(IrInstr *));
+  phiArg = (char *)calloc(f->numVregs, 1);
+  for (b = f->first; b != NULL; b = b->next)
+    for (in = b->first; in != NULL; in = in->next) {
+      if (in->dst != IR_NONE)
+        defs[in->dst] = in;
+      for (k = 0; in->op == IR_PHI && k < in->numArgs; k++)
+        if (in->args[k] >= IR_FIRST)
+          phiArg[in->args[k]] = TRUE;
+    }
+  do {
+    changed = FALSE;
+    for (b = f->first; b != NULL; b = b->next)
+      for (in = b->first; in != NULL; in = next) {
+        next = in->next;
+        if (foldInstr(f, in))
+          changed = TRUE;
+      }
+    /* a loop a folded branch cut off would feed on
+     * itself, its PHIs folded
+     */
+    if (changed && f->inSsa)
+      removeUnreachableBlocks(f);
+  } while (changed);
+  free(phiArg);
+  free(defs);
+}
+
+void removeDeadCode(IrFunc *f) {
+  IrBlock *b;
+  IrInstr *in, *next, **work, **defOf;
+  int *used, top = 0, numInstrs = 0, v, k, n;
+  used = (int *)calloc(f->numVregs, sizeof(int));
+  defOf = (IrInstr **)calloc(f->numVregs, sizeof(IrInstr *));
+  /* what has an effect is live, and so is what
+   * defines a register something live reads
+   */
+  for (b = f->first; b != NULL; b = b->next)
+    for (in = b->first; in != NULL; in = in->next) {
+      in->mark = FALSE;
+      numInstrs++;
+      if (in->dst != IR_NONE)
+        defOf[in->dst] = in;
+    }
+  work = (IrInstr **)malloc((numInstrs + 1) * sizeof(IrInstr *));
+  for (b = f->first; b != NULL; b = b->next)
+    for (in = b->first; in != NULL; in = in->next)
+      if (irHasEffect(in)) {
+        in->mark = TRUE;
+        work[top++] = in;
+      }
+  while (top > 0) {
+    in = work[--top];
+    for (k = 0, n = irNumUses(in); k < n; k++) {
+      v = *irUse(in, k);
+      if (used[v])
+        continue;
+      used[v] = TRUE;
+      if (defOf[v] != NULL && !defOf[v]->mark) {
+        defOf[v]->mark = TRUE;
+        work[top++] = defOf[v];
+      }
+    }
+  }
+  for (b = f->first; b != NULL; b = b->next)
+    for (in = b->first; in != NULL; in = next) {
+      next = in->next;
+      if (!in->mark)
+        irRemove(in);
+      else if (in->op == IR_CALL && in->dst != IR_NONE && !used[in->dst])
+        in->dst = IR_NONE; /* the call stays, its value goes */
+    }
+  free(work);
+  free(defOf);
+  free(used);
+}
+
+void forwardStores(IrFunc *f) {
+  ReachingDefs r;
+  IrBlock *b;
+  IrInstr *in, *d;
+  DfWord *set, *mine, w;
+  int v, i, k, value;
+  if (!f->inSsa)
+    irComputePreds(f);
+  reachingDefinitions(&r, f);
+  set = (DfWord *)malloc(r.df.numWords * sizeof(DfWord));
+  for (b = f->first; b != NULL; b = b->next) {
+    memcpy(set, DF_SET(&r.df, r.df.in, b), r.df.numWords * sizeof(DfWord));
+    for (in = b->first; in != NULL; in = in->next) {
+      if (in->op == IR_LOAD && (v = varOf(&r.vars, in)) != -1) {
+        /* the value, if every store reaching in stores it */
+        value = IR_NONE;
+        mine = r.varDefs + (size_t)v * r.df.numWords;
+        for (i = 0; i < r.df.numWords && value != IR_FP; i++)
+          for (w = set[i] & mine[i], k = i * DF_BITS; w != 0; w >>= 1, k++) {
+            if (!(w & 1))
+              continue;
+            d = r.def[k];
+            if (d == NULL || d->op != IR_STORE ||
+                (value != IR_NONE && d->b != value)) {
+              value = IR_FP; /* none is the one */
+              break;
+            }
+            value = d->b;
+          }
+        if (value >= IR_FIRST) {
+          in->op = IR_MOV;
+          in->a = value;
+          in->imm = 0;
+          in->sym = NULL;
+        }
+      }
+      rdStep(&r, set, in);
+    }
+  }
+  free(set);
+  reachingDefsFree(&r);
+}
+
+/* constOf[v] is the CONST defining v, NULL if none:
+ * registers of the same constant are one operand
+ */
+static IrInstr **constOf;
+
+static int sameOperand(int x, int y) {
+  return x == y || (x >= IR_FIRST && y >= IR_FIRST && constOf[x] != NULL &&
+                    constOf[y] != NULL && constOf[x]->imm == constOf[y]->imm);
+}
+
+static unsigned int operandHash(int v) {
+  if (v >= IR_FIRST && constOf[v] != NULL)
+    return (unsigned int)constOf[v]->imm * 2u + 1u;
+  return (unsigned int)v * 2u;
+}
+
+/* sameExpr tells whether x and y compute the same
+ * value from the same operands
+ */
+static int sameExpr(IrInstr *x, IrInstr *y) {
+  if (x->op != y->op || x->imm != y->imm ||
+      (x->op == IR_SET && x->cond != y->cond) ||
+      (x->op == IR_LOAD && (x->sym == NULL) != (y->sym == NULL)))
+    return FALSE;
+  if (sameOperand(x->a, y->a) && sameOperand(x->b, y->b))
+    return TRUE;
+  return (x->op == IR_ADD || x->op == IR_MUL) && sameOperand(x->a, y->b) &&
+         sameOperand(x->b, y->a);
+}
+
+static unsigned int exprHash(IrInstr *in) {
+  unsigned int h = (unsigned int)in->op * 31u + (unsigned int)in->imm;
+  h = h * 31u + operandHash(in->a) + operandHash(in->b); /* either order */
+  return h * 2654435761u;
+}
+
+void eliminateCommonSubexpressions(IrFunc *f) {
+  AvailExprs ae;
+  IrBlock *b;
+  IrInstr *in, *x;
+  DfWord *set;
+  int *heads, *next, size, k;
+  if (!f->inSsa)
+    irComputePreds(f);
+  constOf = (IrInstr **)calloc(f->numVregs, sizeof(IrInstr *));
+  for (b = f->first; b != NULL; b = b->next)
+    for (in = b->first; in != NULL; in = in->next)
+      if (in->op == IR_CONST)
+        constOf[in->dst] = in;
+  availableExpressions(&ae, f);
+  for (size = 16; size < 2 * ae.numExprs; size *= 2)
+    ;
+  heads = (int *)malloc(size * sizeof(int));
+  next = (int *)malloc((ae.numExprs + 1) * sizeof(int));
+  for (k = 0; k < size; k++)
+    heads[k] = -1;
+  for (k = 0; k < ae.numExprs; k++) {
+    next[k] = heads[exprHash(ae.expr[k]) & (unsigned int)(size - 1)];
+    heads[exprHash(ae.expr[k]) & (unsigned int)(size - 1)] = k;
+  }
+  set = (DfWord *)malloc(ae.df.numWords * sizeof(DfWord));
+  for (b = f->first; b != NULL; b = b->next) {
+    memcpy(set, DF_SET(&ae.df, ae.df.in, b), ae.df.numWords * sizeof(DfWord));
+    for (in = b->first; in != NULL; in = in->next) {
+      if (in->mark >= 0)
+        for (k = heads[exprHash(in) & (unsigned int)(size - 1)]; k != -1;
+             k = next[k]) {
+          x = ae.expr[k];
+          if (x != in && dfTest(set, k) && sameExpr(x, in)) {
+            in->op = IR_MOV;
+            in->a = x->dst;
+            in->b = IR_NONE;
+            in->imm = 0;
+            in->sym = NULL;
+            break;
+          }
+        }
+      aeStep(&ae, set, in);
+    }
+  }
+  free(set);
+  free(next);
+  free(heads);
+  free(constOf);
+  availExprsFree(&ae);
+}
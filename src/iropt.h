@@ -0,0 +1,58 @@
+/****************************************************/
+/* File: iropt.h                                    */
+/* Passes of the optimizer over the intermediate    */
+/* code (ir.h)                                      */
+/****************************************************/
+
+#ifndef _IROPT_H_
+#define _IROPT_H_
+
+#include "ir.h"
+
+/* Function removeUnreachableBlocks drops the blocks
+ * no path from the entry reaches, keeping the
+ * predecessors of the others, and tells whether
+ * there were any
+ */
+int removeUnreachableBlocks(IrFunc *f);
+
+/* Procedure simplifyCfg drops the blocks no path from
+ * the entry reaches, sends the jumps to a block that
+ * only jumps on to its target, and merges a block
+ * with the one it jumps to when that has no other
+ * predecessor. It leaves a function in SSA form as
+ * it is.
+ */
+void simplifyCfg(IrFunc *f);
+
+/* Procedure foldIr propagates copies and constants:
+ * an operation on constants becomes a constant (but
+ * for a division the TM would trap on), a constant
+ * operand of + or - becomes an ADDI, an ADDI of the
+ * base of a LOAD or STORE goes into its offset, and
+ * a branch on a constant becomes a jump. A PHI of
+ * one value becomes a copy of it.
+ */
+void foldIr(IrFunc *f);
+
+/* Procedure removeDeadCode removes the instructions
+ * with no effect whose result nothing with an effect
+ * needs, even through a cycle of PHIs
+ */
+void removeDeadCode(IrFunc *f);
+
+/* Procedure forwardStores makes a LOAD of a variable
+ * a copy of the register stored to it, when every
+ * definition reaching the load (dataflow.h) is a
+ * store of that register
+ */
+void forwardStores(IrFunc *f);
+
+/* Procedure eliminateCommonSubexpressions makes an
+ * operation or load a copy of the register of the
+ * same one before it, when that is available there
+ * (dataflow.h)
+ */
+void eliminateCommonSubexpressions(IrFunc *f);
+
+#endif
@@ -0,0 +1,572 @@
+/****************************************************/
+/* File: loops.c                                    */
+/* Loops of the intermediate code (ir.h) and the    */
+/* passes over them                                 */
+/****************************************************/
+
+#include "loops.h"
+#include "dataflow.h"
+#include <stdlib.h>
+#include <string.h>
+
+static IrFunc *f;
+
+static void setPreds(IrBlock *b, IrBlock **preds, int n) {
+  b->preds = (IrBlock **)arenaAlloc(f->arena, (n + 1) * sizeof(IrBlock *));
+  memcpy(b->preds, preds, n * sizeof(IrBlock *));
+  b->numPreds = n;
+}
+
+/* retarget sends the jump or branch ending b to to
+ * where it went to from
+ */
+static void retarget(IrBlock *b, IrBlock *from, IrBlock *to) {
+  IrInstr *t = b->last;
+  if (t->target == from)
+    t->target = to;
+  if (t->op == IR_BR && t->other == from)
+    t->other = to;
+}
+
+/* Procedure collectBody fills the blocks of the loop
+ * with header h, walking back from its back edges
+ */
+static void collectBody(IrLoop *l, IrBlock *h, IrBlock **stack) {
+  IrBlock *b, *p;
+  int top = 0, k;
+  l->header = h;
+  l->preheader = NULL;
+  l->inLoop = (char *)arenaCalloc(f->arena, f->numBlocks);
+  l->blocks = (IrBlock **)arenaAlloc(f->arena, f->numBlocks * sizeof(IrBlock *));
+  l->inLoop[h->id] = TRUE;
+  l->blocks[0] = h;
+  l->numBlocks = 1;
+  for (k = 0; k < h->numPreds; k++)
+    if (dominates(h, h->preds[k]) && !l->inLoop[h->preds[k]->id]) {
+      l->inLoop[h->preds[k]->id] = TRUE;
+      stack[top++] = h->preds[k];
+    }
+  while (top > 0) {
+    b = stack[--top];
+    l->blocks[l->numBlocks++] = b;
+    for (k = 0; k < b->numPreds; k++) {
+      p = b->preds[k];
+      if (p->order >= 0 && !l->inLoop[p->id]) {
+        l->inLoop[p->id] = TRUE;
+        stack[top++] = p;
+      }
+    }
+  }
+}
+
+/* Procedure makePreheader finds the preheader of l, or
+ * makes one: the predecessors from outside now go to
+ * it, and it merges their PHI arguments
+ */
+static void makePreheader(IrLoop *l) {
+  IrBlock *h = l->header, *p, **outside, **preds;
+  IrInstr *phi, *q;
+  int numOutside = 0, numPreds = 1, k, j, *args;
+  outside = (IrBlock **)malloc(h->numPreds * sizeof(IrBlock *));
+  preds = (IrBlock **)malloc((h->numPreds + 1) * sizeof(IrBlock *));
+  for (k = 0; k < h->numPreds; k++)
+    if (!l->inLoop[h->preds[k]->id])
+      outside[numOutside++] = h->preds[k];
+  if (numOutside == 1 && outside[0]->last->op == IR_JUMP)
+    p = outside[0];
+  else {
+    p = irNewBlock(f, "loop: preheader");
+    irPlaceBlockAfter(f, p, h->prev);
+    irAppend(f, p, IR_JUMP)->target = h;
+    for (k = 0; k < numOutside; k++)
+      retarget(outside[k], h, p);
+    setPreds(p, outside, numOutside);
+  }
+  /* p comes first, then the back edges */
+  preds[0] = p;
+  for (k = 0; k < h->numPreds; k++)
+    if (l->inLoop[h->preds[k]->id])
+      preds[numPreds++] = h->preds[k];
+  for (phi = h->first; phi != NULL && phi->op == IR_PHI; phi = phi->next) {
+    args = (int *)arenaAlloc(f->arena, (numPreds + 1) * sizeof(int));
+    args[0] = IR_NONE;
+    for (k = 0, j = 1; k < h->numPreds; k++)
+      if (l->inLoop[h->preds[k]->id])
+        args[j++] = phi->args[k];
+      else if (numOutside == 1)
+        args[0] = phi->args[k];
+    if (numOutside > 1) {
+      q = irNewPhi(f, p, phi->imm);
+      q->dst = irNewVreg(f);
+      q->sym = phi->sym;
+      q->comment = phi->comment;
+      for (k = 0, j = 0; k < h->numPreds; k++)
+        if (!l->inLoop[h->preds[k]->id])
+          q->args[j++] = phi->args[k];
+      args[0] = q->dst;
+    }
+    phi->args = args;
+    phi->numArgs = numPreds;
+  }
+  setPreds(h, preds, numPreds);
+  l->preheader = p;
+  free(preds);
+  free(outside);
+}
+
+static int bySize(const void *x, const void *y) {
+  return ((const IrLoop *)x)->numBlocks - ((const IrLoop *)y)->numBlocks;
+}
+
+IrLoop *findLoops(IrFunc *func, int *numLoops) {
+  IrLoop *loops;
+  IrBlock *b, **stack;
+  int n = 0, round, k;
+  f = func;
+  if (!f->inSsa)
+    irComputePreds(f);
+  loops = (IrLoop *)arenaAlloc(f->arena, (f->numBlocks + 1) * sizeof(IrLoop));
+  stack = (IrBlock **)malloc((f->numBlocks + 1) * sizeof(IrBlock *));
+  /* the preheaders made in the first round belong to
+   * the loops around, found again in the second
+   */
+  for (round = 0; round < 2; round++) {
+    computeDominators(f);
+    n = 0;
+    for (b = f->first; b != NULL; b = b->next) {
+      if (b == f->first)
+        continue;
+      for (k = 0; k < b->numPreds; k++)
+        if (dominates(b, b->preds[k]))
+          break;
+      if (k < b->numPreds)
+        collectBody(&loops[n++], b, stack);
+    }
+    for (k = 0; k < n; k++)
+      makePreheader(&loops[k]);
+  }
+  computeDominators(f);
+  free(stack);
+  qsort(loops, n, sizeof(IrLoop), bySize);
+  *numLoops = n;
+  return loops;
+}
+
+/* where each register is defined, NULL if nowhere */
+static IrBlock **defBlock;
+
+static void findDefs(void) {
+  IrBlock *b;
+  IrInstr *in;
+  defBlock = (IrBlock **)calloc(f->numVregs, sizeof(IrBlock *));
+  for (b = f->first; b != NULL; b = b->next)
+    for (in = b->first; in != NULL; in = in->next)
+      if (in->dst != IR_NONE)
+        defBlock[in->dst] = b;
+}
+
+/* outside tells whether v comes from outside l */
+static int outside(IrLoop *l, int v) {
+  return v < IR_FIRST || (defBlock[v] != NULL && !l->inLoop[defBlock[v]->id]);
+}
+
+/* Function storedIn tells whether a store or, for a
+ * global, a call in l may change what the load in
+ * reads
+ */
+static int storedIn(IrLoop *l, IrInstr *load) {
+  IrInstr *in;
+  int k;
+  for (k = 0; k < l->numBlocks; k++)
+    for (in = l->blocks[k]->first; in != NULL; in = in->next)
+      if ((in->op == IR_STORE && in->sym != NULL && in->a == load->a &&
+           in->imm == load->imm) ||
+          (in->op == IR_CALL && load->a == IR_GP))
+        return TRUE;
+  return FALSE;
+}
+
+static int isInvariant(IrLoop *l, IrInstr *in) {
+  int k, n;
+  switch (in->op) {
+  case IR_CONST:
+  case IR_MOV:
+  case IR_ADD:
+  case IR_SUB:
+  case IR_MUL:
+  case IR_ADDI:
+  case IR_SET:
+    break;
+  case IR_LOAD:
+    if (in->sym == NULL || !outside(l, in->a) || storedIn(l, in))
+      return FALSE;
+    break;
+  default:
+    return FALSE;
+  }
+  for (k = 0, n = irNumUses(in); k < n; k++)
+    if (!outside(l, *irUse(in, k)))
+      return FALSE;
+  return TRUE;
+}
+
+/* Procedure moveTo moves in to the end of b, before
+ * its jump
+ */
+static void moveTo(IrInstr *in, IrBlock *b) {
+  IrInstr *to = irInsertBefore(f, b->last, in->op);
+  to->cond = in->cond;
+  to->dst = in->dst;
+  to->a = in->a;
+  to->b = in->b;
+  to->imm = in->imm;
+  to->sym = in->sym;
+  to->comment = in->comment;
+  if (to->dst != IR_NONE)
+    defBlock[to->dst] = b;
+  irRemove(in);
+}
+
+void hoistInvariants(IrFunc *func) {
+  IrLoop *loops, *l;
+  IrInstr *in, *next;
+  int numLoops, i, k, changed;
+  f = func;
+  if (f->first == NULL)
+    return;
+  loops = findLoops(f, &numLoops);
+  findDefs();
+  for (i = 0; i < numLoops; i++) {
+    l = &loops[i];
+    do {
+      changed = FALSE;
+      for (k = 0; k < l->numBlocks; k++)
+        for (in = l->blocks[k]->first; in != NULL; in = next) {
+          next = in->next;
+          if (isInvariant(l, in)) {
+            moveTo(in, l->preheader);
+            changed = TRUE;
+          }
+        }
+    } while (changed);
+  }
+  free(defBlock);
+}
+
+/* the state of strength reduction, for f */
+static IrInstr **defOf;  /* the instruction defining each */
+static int *useStart;    /* uses[useStart[v]..] read v */
+static IrInstr **uses;
+static char *touched;    /* read by new instructions */
+static int numOld;       /* registers before the pass */
+
+/* Procedure findUses fills defOf and the uses */
+static void findUses(void) {
+  IrBlock *b;
+  IrInstr *in;
+  int *count, k, n, v, total = 0;
+  defOf = (IrInstr **)calloc(f->numVregs, sizeof(IrInstr *));
+  useStart = (int *)calloc(f->numVregs + 1, sizeof(int));
+  count = (int *)calloc(f->numVregs, sizeof(int));
+  for (b = f->first; b != NULL; b = b->next)
+    for (in = b->first; in != NULL; in = in->next) {
+      if (in->dst != IR_NONE)
+        defOf[in->dst] = in;
+      for (k = 0, n = irNumUses(in); k < n; k++)
+        if ((v = *irUse(in, k)) >= IR_FIRST) {
+          count[v]++;
+          total++;
+        }
+    }
+  for (v = 0; v < f->numVregs; v++)
+    useStart[v + 1] = useStart[v] + count[v];
+  uses = (IrInstr **)malloc((total + 1) * sizeof(IrInstr *));
+  memset(count, 0, f->numVregs * sizeof(int));
+  for (b = f->first; b != NULL; b = b->next)
+    for (in = b->first; in != NULL; in = in->next)
+      for (k = 0, n = irNumUses(in); k < n; k++)
+        if ((v = *irUse(in, k)) >= IR_FIRST)
+          uses[useStart[v] + count[v]++] = in;
+  free(count);
+}
+
+/* available tells whether v may be read at the end
+ * of the preheader p
+ */
+static int available(int v, IrBlock *p) {
+  return v < IR_FIRST ||
+         (v < numOld && defOf[v] != NULL && dominates(defOf[v]->block, p));
+}
+
+/* invariantOp computes a op b at the end of p */
+static int invariantOp(IrBlock *p, IrOp op, int a, int b) {
+  IrInstr *in = irInsertBefore(f, p->last, op);
+  in->a = a;
+  in->b = b;
+  in->comment = "loop: strength reduction";
+  touched[a] = touched[b] = TRUE;
+  return in->dst = irNewVreg(f);
+}
+
+/* the forms of a pointer p for i */
+#define PLUS_I 0  /* p = i + base */
+#define MINUS_I 1 /* p = base - i */
+
+/* Function otherOperand returns the operand of the
+ * add or subtract u that is not i, -1 if u is not one
+ * with i once; *minus tells it subtracts i, *from
+ * that it subtracts from i
+ */
+static int otherOperand(IrInstr *u, int i, int *minus, int *from) {
+  *minus = *from = FALSE;
+  if ((u->op != IR_ADD && u->op != IR_SUB) || u->a == u->b)
+    return -1;
+  if (u->op == IR_SUB) {
+    *minus = u->b == i;
+    *from = u->a == i;
+  }
+  return u->a == i ? u->b : u->a;
+}
+
+/* Function weight tells how much an instruction in
+ * the block b counts for l: 2 if b runs on every
+ * iteration, dominating each back edge, else 1
+ */
+static int weight(IrLoop *l, IrBlock *b) {
+  int k;
+  if (!l->inLoop[b->id])
+    return 1;
+  for (k = 1; k < l->header->numPreds; k++)
+    if (!dominates(b, l->header->preds[k]))
+      return 1;
+  return 2;
+}
+
+/* Function getI computes i from ptr before the
+ * instruction at
+ */
+static int getI(IrInstr *at, int ptr, int base, int form) {
+  IrInstr *in = irInsertBefore(f, at, IR_SUB);
+  in->a = form == PLUS_I ? ptr : base;
+  in->b = form == PLUS_I ? base : ptr;
+  in->comment = "loop: induction variable";
+  return in->dst = irNewVreg(f);
+}
+
+/* Function isAddress tells whether the use u of i,
+ * with other operand x, is the address base + i or
+ * base - i of the given form
+ */
+static int isAddress(IrInstr *u, int x, int minus, int base, int form) {
+  return x == base && (form == PLUS_I ? u->op == IR_ADD : minus);
+}
+
+/* Function isOffset tells whether the use u of v is
+ * v + k, as the copies of an unrolled body have, whose
+ * uses are reduced with it
+ */
+static int isOffset(IrInstr *u, int v) {
+  return u->op == IR_ADDI && u->a == v && u->dst >= IR_FIRST &&
+         u->dst < numOld && !touched[u->dst];
+}
+
+/* the induction variable being reduced */
+static IrLoop *loop;
+static int base, form;
+
+/* Function useGain weighs the uses of v but skip: an
+ * address saved counts for it, a use that must get v
+ * back against it
+ */
+static int useGain(int v, IrInstr *skip) {
+  IrInstr *u;
+  int k, j, x, minus, from, gain = 0;
+  for (k = useStart[v]; k < useStart[v + 1]; k++) {
+    u = uses[k];
+    if (u == skip)
+      continue;
+    if (u->op == IR_PHI) {
+      for (j = 0; j < u->numArgs; j++)
+        if (u->args[j] == v)
+          gain -= weight(loop, u->block->preds[j]);
+      continue;
+    }
+    if (isOffset(u, v)) {
+      gain += useGain(u->dst, NULL);
+      continue;
+    }
+    x = otherOperand(u, v, &minus, &from);
+    if (x != -1 && isAddress(u, x, minus, base, form))
+      gain += weight(loop, u->block);
+    else if (x == -1 || !available(x, loop->preheader))
+      gain -= weight(loop, u->block);
+  }
+  return gain;
+}
+
+/* Procedure rewriteUses rewrites the uses of v but
+ * skip on the pointer ptr that goes with it
+ */
+static void rewriteUses(int v, IrInstr *skip, int ptr) {
+  IrBlock *p = loop->preheader;
+  IrInstr *u;
+  int k, j, n, x, minus, from, kv;
+  for (k = useStart[v]; k < useStart[v + 1]; k++) {
+    u = uses[k];
+    if (u == skip)
+      continue;
+    if (u->op == IR_PHI) {
+      for (j = 0; j < u->numArgs; j++)
+        if (u->args[j] == v)
+          u->args[j] = getI(u->block->preds[j]->last, ptr, base, form);
+      continue;
+    }
+    if (isOffset(u, v)) {
+      /* i + k becomes a pointer itself: ptr + k, or ptr - k */
+      u->a = ptr;
+      if (form == MINUS_I)
+        u->imm = (int)(0u - (unsigned int)u->imm);
+      touched[u->dst] = TRUE;
+      rewriteUses(u->dst, NULL, u->dst);
+      continue;
+    }
+    x = otherOperand(u, v, &minus, &from);
+    if (x != -1 && isAddress(u, x, minus, base, form)) {
+      u->op = IR_MOV;
+      u->a = ptr;
+      u->b = IR_NONE;
+    } else if (x == -1 || !available(x, p)) {
+      kv = getI(u, ptr, base, form);
+      for (j = 0, n = irNumUses(u); j < n; j++)
+        if (*irUse(u, j) == v)
+          *irUse(u, j) = kv;
+    } else if (form == PLUS_I) {
+      /* x + i = ptr + (x - base); x - i = (x + base) - ptr;
+       * i - x = ptr - (x + base)
+       */
+      if (u->op == IR_ADD) {
+        kv = invariantOp(p, IR_SUB, x, base);
+        u->a = ptr;
+        u->b = kv;
+      } else {
+        kv = invariantOp(p, IR_ADD, x, base);
+        u->a = minus ? kv : ptr;
+        u->b = minus ? ptr : kv;
+      }
+    } else {
+      /* x + i = (x + base) - ptr; x - i = ptr - (base - x);
+       * i - x = (base - x) - ptr
+       */
+      u->op = IR_SUB;
+      if (minus) {
+        kv = invariantOp(p, IR_SUB, base, x);
+        u->a = ptr;
+        u->b = kv;
+      } else {
+        kv = invariantOp(p, from ? IR_SUB : IR_ADD, base, x);
+        u->a = kv;
+        u->b = ptr;
+      }
+    }
+  }
+}
+
+/* Function findBase sets base and form from the first
+ * address among the uses of v, and tells whether
+ * there is one
+ */
+static int findBase(int v) {
+  IrInstr *u;
+  int k, x, minus, from;
+  for (k = useStart[v]; k < useStart[v + 1]; k++) {
+    u = uses[k];
+    x = otherOperand(u, v, &minus, &from);
+    if (x == -1 || !available(x, loop->preheader))
+      continue;
+    if (u->op == IR_ADD &&
+        (x == IR_GP || (x >= IR_FIRST && defOf[x]->op == IR_LOAD))) {
+      base = x;
+      form = PLUS_I;
+      return TRUE;
+    }
+    if (minus && x == IR_FP) {
+      base = x;
+      form = MINUS_I;
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+/* Function reduceIv tries the PHI phi of the loop l as
+ * an induction variable i, stepping to next. Their
+ * addresses become the pointer, adds and subtracts
+ * with an invariant are rewritten on it, and the other
+ * uses get i back from it; this is done when the
+ * addresses saved outweigh the uses that get i back.
+ */
+static int reduceIv(IrLoop *l, IrInstr *phi) {
+  IrBlock *p = l->preheader;
+  IrInstr *step, *q;
+  int i = phi->dst, next, init, k, ptr, ptrNext;
+  if (i >= numOld || phi->numArgs < 2 || touched[i])
+    return FALSE;
+  init = phi->args[0];
+  next = phi->args[1];
+  if (init < 0 || init >= numOld || next < IR_FIRST || next >= numOld)
+    return FALSE;
+  for (k = 2; k < phi->numArgs; k++)
+    if (phi->args[k] != next)
+      return FALSE;
+  step = defOf[next];
+  if (step == NULL || step->op != IR_ADDI || step->a != i ||
+      !l->inLoop[step->block->id] || touched[next])
+    return FALSE;
+  loop = l;
+  if (!findBase(i) && !findBase(next))
+    return FALSE;
+  if (useGain(i, step) + useGain(next, phi) <= 0)
+    return FALSE;
+  /* p = init + base, or base - init, then steps */
+  ptr = irNewVreg(f);
+  ptrNext = irNewVreg(f);
+  q = irNewPhi(f, l->header, -1);
+  q->dst = ptr;
+  q->comment = "loop: pointer";
+  q->args[0] = form == PLUS_I ? invariantOp(p, IR_ADD, init, base)
+                              : invariantOp(p, IR_SUB, base, init);
+  for (k = 1; k < q->numArgs; k++)
+    q->args[k] = ptrNext;
+  q = irInsertAfter(f, step, IR_ADDI);
+  q->dst = ptrNext;
+  q->a = ptr;
+  q->imm = form == PLUS_I ? step->imm : (int)(0u - (unsigned int)step->imm);
+  q->comment = "loop: pointer step";
+  rewriteUses(i, step, ptr);
+  rewriteUses(next, phi, ptrNext);
+  touched[i] = touched[next] = touched[init] = touched[base] = TRUE;
+  return TRUE;
+}
+
+void reduceStrength(IrFunc *func) {
+  IrLoop *loops;
+  IrInstr *phi;
+  int numLoops, i;
+  f = func;
+  if (!f->inSsa || f->first == NULL)
+    return;
+  loops = findLoops(f, &numLoops);
+  if (numLoops == 0)
+    return;
+  findUses();
+  numOld = f->numVregs;
+  touched = (char *)calloc(f->numVregs, 1);
+  for (i = 0; i < numLoops; i++)
+    for (phi = loops[i].header->first; phi != NULL && phi->op == IR_PHI;
+         phi = phi->next)
+      reduceIv(&loops[i], phi);
+  free(touched);
+  free(uses);
+  free(useStart);
+  free(defOf);
+}
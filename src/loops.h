@@ -0,0 +1,59 @@
+/****************************************************/
+/* File: loops.h                                    */
+/* Loops of the intermediate code (ir.h) and the    */
+/* passes over them                                 */
+/****************************************************/
+
+#ifndef _LOOPS_H_
+#define _LOOPS_H_
+
+#include "ir.h"
+
+/* a natural loop: the blocks a back edge into its
+ * header (one the header dominates) comes around
+ * from, without passing the header; the back edges
+ * into one header make one loop. The preheader is
+ * the only predecessor from outside, and the header
+ * its only successor; it is preds[0] of the header.
+ */
+typedef struct {
+  IrBlock *header, *preheader;
+  IrBlock **blocks; /* header first */
+  int numBlocks;
+  char *inLoop; /* by block id */
+} IrLoop;
+
+/* Function findLoops returns the loops of f, inner
+ * ones before the loops around them, and sets
+ * *numLoops. It gives a loop with no preheader a new
+ * one, laid out just before the header, keeping the
+ * predecessors and the PHIs (in SSA form) up, and
+ * sets the dominators. All of it lives in the arena
+ * of f.
+ */
+IrLoop *findLoops(IrFunc *f, int *numLoops);
+
+/* Procedure hoistInvariants moves to the preheader of
+ * each loop the instructions that compute the same
+ * value on every iteration: the pure ones (not a
+ * division, which may trap) whose operands come from
+ * outside the loop or from moved ones, and the loads
+ * of a scalar variable the loop does not store to,
+ * nor calls into for a global.
+ */
+void hoistInvariants(IrFunc *f);
+
+/* Procedure reduceStrength replaces, in SSA form, an
+ * induction variable i of a loop (a PHI in the header
+ * that each iteration adds a constant to) used for
+ * addressing, as in base + i or fp - i, by a pointer
+ * p that takes the same steps: the address becomes p,
+ * an add or subtract of i with a value from outside
+ * the loop is rewritten on p, and the other uses get
+ * i back from p. It does so where the addresses saved
+ * outweigh the uses that get i back; i then goes as
+ * dead code.
+ */
+void reduceStrength(IrFunc *f);
+
+#endif
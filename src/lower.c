@@ -0,0 +1,449 @@
+/****************************************************/
+/* File: lower.c                                    */
+/* Lowering of the C- syntax tree to the            */
+/* intermediate code (ir.h)                         */
+/****************************************************/
+
+#include "lower.h"
+#include "ast.h"
+#include "cgen.h"
+#include "unroll.h"
+#include <string.h>
+
+/* the function being lowered, and the block its code
+ * goes to
+ */
+static IrFunc *fn;
+static IrBlock *cur;
+
+static IrInstr *emit(IrOp op, const char *comment) {
+  IrInstr *in = irAppend(fn, cur, op);
+  in->comment = comment;
+  return in;
+}
+
+/* value emits op on a, b and imm into a new register
+ * and returns the register
+ */
+static int value(IrOp op, int a, int b, int imm, const char *comment) {
+  IrInstr *in = emit(op, comment);
+  in->a = a;
+  in->b = b;
+  in->imm = imm;
+  return in->dst = irNewVreg(fn);
+}
+
+/* startBlock lays b out and sends the code there */
+static void startBlock(IrBlock *b) {
+  irPlaceBlock(fn, b);
+  cur = b;
+}
+
+static void jumpTo(IrBlock *b, const char *comment) {
+  emit(IR_JUMP, comment)->target = b;
+}
+
+static int isConstant(TreeNode *t) {
+  return t != NULL && t->nodekind == ExpK && t->kind.exp == ConstK;
+}
+
+static int isZero(TreeNode *t) {
+  return isConstant(t) && t->attr.val == 0;
+}
+
+static int isComparison(TreeNode *t) {
+  if (t->nodekind != ExpK || t->kind.exp != OpK || t->child[1] == NULL)
+    return FALSE;
+  switch (t->attr.op) {
+  case LT:
+  case LTE:
+  case GT:
+  case GTE:
+  case EQQ:
+  case NEQ:
+    return TRUE;
+  default:
+    return FALSE;
+  }
+}
+
+/* varLoad loads the scalar variable s */
+static int varLoad(BucketList s, const char *comment) {
+  IrInstr *in = emit(IR_LOAD, comment);
+  in->a = s->scopeId == GLOBAL_SCOPE ? IR_GP : IR_FP;
+  in->imm = s->scopeId == GLOBAL_SCOPE ? s->memloc : initFO - s->memloc;
+  in->sym = s;
+  return in->dst = irNewVreg(fn);
+}
+
+static void varStore(BucketList s, int v, const char *comment) {
+  IrInstr *in = emit(IR_STORE, comment);
+  in->a = s->scopeId == GLOBAL_SCOPE ? IR_GP : IR_FP;
+  in->imm = s->scopeId == GLOBAL_SCOPE ? s->memloc : initFO - s->memloc;
+  in->b = v;
+  in->sym = s;
+}
+
+/* elementAddress returns the register that, plus
+ * *offset, addresses element index of the array s
+ */
+static int elementAddress(BucketList s, int index, int *offset) {
+  if (s->scopeId == GLOBAL_SCOPE) {
+    *offset = s->memloc;
+    return value(IR_ADD, index, IR_GP, 0, "ac = index + gp");
+  }
+  if (strcmp(s->type, "param-array") == 0) {
+    int base = varLoad(s, "ac1 = mem[reg(fp) + initFO - loc]");
+    *offset = 0;
+    return value(IR_ADD, base, index, 0, "ac = (base_addr + index)");
+  }
+  *offset = initFO - s->memloc;
+  return value(IR_SUB, IR_FP, index, 0, "ac = fp - index");
+}
+
+static int lowerExp(TreeNode *t);
+
+/* diffCond gives the test on right - left deciding
+ * left op right, as the TM compares
+ */
+static IrCond diffCond(TokenType op) {
+  switch (op) {
+  case LT:
+    return IR_GT;
+  case LTE:
+    return IR_GE;
+  case GT:
+    return IR_LT;
+  case GTE:
+    return IR_LE;
+  case EQQ:
+    return IR_EQ;
+  default: /* NEQ */
+    return IR_NE;
+  }
+}
+
+/* swapCond gives the test on -v that v passes */
+static IrCond swapCond(IrCond cond) {
+  switch (cond) {
+  case IR_LT:
+    return IR_GT;
+  case IR_LE:
+    return IR_GE;
+  case IR_GT:
+    return IR_LT;
+  case IR_GE:
+    return IR_LE;
+  default: /* IR_EQ, IR_NE */
+    return cond;
+  }
+}
+
+/* lowerCompare lowers the comparison t to the value
+ * whose test against 0, in *cond, decides it: right
+ * - left, or the other operand alone when one of
+ * them is the constant 0
+ */
+static int lowerCompare(TreeNode *t, IrCond *cond) {
+  TreeNode *l = t->child[0], *r = t->child[1];
+  int left, right;
+  *cond = diffCond(t->attr.op);
+  if (isZero(l))
+    return lowerExp(r);
+  if (isZero(r)) {
+    *cond = swapCond(*cond);
+    return lowerExp(l);
+  }
+  left = lowerExp(l);
+  right = lowerExp(r);
+  return value(IR_SUB, right, left, 0, "compare: right - left");
+}
+
+/* lowerCondition ends the current block with a branch
+ * to ifTrue when t holds, to ifFalse when it does not
+ */
+static void lowerCondition(TreeNode *t, IrBlock *ifTrue, IrBlock *ifFalse,
+                           const char *comment) {
+  IrCond cond = IR_NE;
+  int v = isComparison(t) ? lowerCompare(t, &cond) : lowerExp(t);
+  IrInstr *br = emit(IR_BR, comment);
+  br->a = v;
+  br->cond = cond;
+  br->target = ifTrue;
+  br->other = ifFalse;
+}
+
+/* lowerCall lowers a call of a function of the
+ * program: the arguments, left to right, then the
+ * call. An array global is passed by address, any
+ * other argument by value.
+ */
+static int lowerCall(TreeNode *t) {
+  TreeNode *arg;
+  int n = 0, i, *args;
+  IrInstr *call;
+  for (arg = t->child[0]; arg != NULL; arg = arg->sibling)
+    n++;
+  args = (int *)arenaAlloc(fn->arena, (n + 1) * sizeof(int));
+  for (arg = t->child[0], i = 0; arg != NULL; arg = arg->sibling, i++) {
+    BucketList s = arg->symbol;
+    if (arg->nodekind == ExpK && arg->kind.exp == VarK && !arg->isArray &&
+        s->scopeId == GLOBAL_SCOPE &&
+        (strcmp(s->type, "array") == 0 || strcmp(s->type, "param-array") == 0))
+      args[i] = value(IR_ADDI, IR_GP, IR_NONE, s->memloc,
+                      "load global id address");
+    else
+      args[i] = lowerExp(arg);
+  }
+  for (i = 0; i < n; i++) {
+    IrInstr *in = emit(IR_ARG, "Storing current argument on stack");
+    in->a = args[i];
+    in->imm = i;
+  }
+  call = emit(IR_CALL, "jump to function");
+  call->sym = t->symbol;
+  call->imm = n;
+  return call->dst = irNewVreg(fn);
+}
+
+static int lowerExp(TreeNode *t) {
+  TreeNode *l = t->child[0], *r = t->child[1];
+  int left, right, v, offset;
+  IrCond cond;
+  switch (t->kind.exp) {
+  case ConstK:
+    return value(IR_CONST, IR_NONE, IR_NONE, t->attr.val, "load const");
+
+  case IdK:
+    return value(IR_LOAD, t->symbol->scopeId == GLOBAL_SCOPE ? IR_GP : IR_FP,
+                 IR_NONE, t->symbol->memloc, "load id");
+
+  case VarK:
+    if (!t->isArray && strcmp(t->symbol->type, "array") == 0) {
+      /* its first element, read as an element is: the
+       * array stores change it, not a scalar store
+       */
+      v = t->symbol->scopeId == GLOBAL_SCOPE;
+      return value(IR_LOAD, v ? IR_GP : IR_FP, IR_NONE,
+                   v ? t->symbol->memloc : initFO - t->symbol->memloc,
+                   "load local id value");
+    }
+    if (!t->isArray)
+      return varLoad(t->symbol, t->symbol->scopeId == GLOBAL_SCOPE
+                                    ? "load id value"
+                                    : "load local id value");
+    v = elementAddress(t->symbol, lowerExp(l), &offset);
+    return value(IR_LOAD, v, IR_NONE, offset, "ac = mem[ac]");
+
+  case OpK:
+    if (r == NULL) { /* unary minus */
+      v = value(IR_CONST, IR_NONE, IR_NONE, 0, "load zero");
+      return value(IR_SUB, v, lowerExp(l), 0, "op -");
+    }
+    if (isComparison(t)) {
+      v = lowerCompare(t, &cond);
+      emit(IR_SET, "op: 1 if true, else 0");
+      cur->last->a = v;
+      cur->last->cond = cond;
+      return cur->last->dst = irNewVreg(fn);
+    }
+    left = lowerExp(l);
+    right = lowerExp(r);
+    switch (t->attr.op) {
+    case PLUS:
+      return value(IR_ADD, left, right, 0, "op +");
+    case MINUS:
+      return value(IR_SUB, left, right, 0, "op -");
+    case TIMES:
+      return value(IR_MUL, left, right, 0, "op *");
+    default: /* OVER */
+      return value(IR_DIV, left, right, 0, "op /");
+    }
+
+  case AssignK:
+    if (r == NULL) { /* no array on the left side */
+      v = lowerExp(l);
+      varStore(t->symbol, v,
+               t->symbol->scopeId == GLOBAL_SCOPE
+                   ? "assign: store to global variable"
+                   : "assign: store to local variable");
+      return v;
+    }
+    /* the value first, then the index */
+    v = lowerExp(r);
+    left = elementAddress(t->symbol, lowerExp(l), &offset);
+    emit(IR_STORE, "assign: store to array");
+    cur->last->a = left;
+    cur->last->b = v;
+    cur->last->imm = offset;
+    return v;
+
+  case CallK:
+    if (strcmp(t->attr.name, "input") == 0)
+      return value(IR_IN, IR_NONE, IR_NONE, 0, "input");
+    if (strcmp(t->attr.name, "output") == 0) {
+      v = lowerExp(l);
+      emit(IR_OUT, "output")->a = v;
+      return v;
+    }
+    return lowerCall(t);
+
+  default:
+    return value(IR_CONST, IR_NONE, IR_NONE, 0, NULL);
+  }
+}
+
+static void lowerStmts(TreeNode *t);
+
+/* the statement before the one being lowered, NULL
+ * if none
+ */
+static TreeNode *prevStmt;
+
+/* lowerTest ends the current block with a branch to
+ * ifTrue when the test t of the loop planned by u
+ * holds for copies iterations, its counter stepping
+ * by 1, to ifFalse when it does not
+ */
+static void lowerTest(TreeNode *t, Unrolling *u, int copies, IrBlock *ifTrue,
+                      IrBlock *ifFalse, const char *comment) {
+  int left, right, v;
+  IrInstr *br;
+  if (isConstant(t)) { /* never left */
+    jumpTo(ifTrue, comment);
+    return;
+  }
+  if (copies == 1) {
+    lowerCondition(t, ifTrue, ifFalse, comment);
+    return;
+  }
+  /* right - left, moved as copies - 1 steps would */
+  left = lowerExp(t->child[0]);
+  right = lowerExp(t->child[1]);
+  v = value(IR_SUB, right, left, 0, "compare: right - left");
+  v = value(IR_ADDI, v, IR_NONE, u->varOnLeft ? 1 - copies : copies - 1,
+            "unroll: room for the copies");
+  br = emit(IR_BR, comment);
+  br->a = v;
+  br->cond = diffCond(t->attr.op);
+  br->target = ifTrue;
+  br->other = ifFalse;
+}
+
+/* lowerLoop lowers a while loop with test t running
+ * copies of body per test, going on to out when the
+ * test fails. It is rotated: the test runs once on
+ * the way in, then at the bottom, so an iteration
+ * takes one branch.
+ */
+static void lowerLoop(TreeNode *t, TreeNode *body, Unrolling *u, int copies,
+                      IrBlock *out) {
+  IrBlock *top = irNewBlock(fn, "while: body");
+  IrBlock *test = irNewBlock(fn, "while: test");
+  int k;
+  lowerTest(t, u, copies, top, out, "while: exit");
+  startBlock(top);
+  for (k = 0; k < copies; k++)
+    lowerStmts(body);
+  jumpTo(test, NULL);
+  startBlock(test);
+  lowerTest(t, u, copies, top, out, "while: jump begin");
+}
+
+static void lowerStmt(TreeNode *t) {
+  TreeNode *p1 = t->child[0], *p2 = t->child[1], *p3 = t->child[2];
+  IrBlock *body, *other, *end;
+  Unrolling u;
+  int k;
+  switch (t->kind.stmt) {
+  case IfK:
+    if (isConstant(p1)) { /* folded: only one branch runs */
+      lowerStmts(p1->attr.val != 0 ? p2 : p3);
+      break;
+    }
+    body = irNewBlock(fn, "if: then");
+    other = p3 != NULL ? irNewBlock(fn, "if: else") : NULL;
+    end = irNewBlock(fn, "if: end");
+    lowerCondition(p1, body, other != NULL ? other : end, "if: jmp else");
+    startBlock(body);
+    lowerStmts(p2);
+    jumpTo(end, "jmp end if");
+    if (other != NULL) {
+      startBlock(other);
+      lowerStmts(p3);
+      jumpTo(end, "jmp end if");
+    }
+    startBlock(end);
+    break;
+
+  case WhileK:
+    if (isConstant(p1) && p1->attr.val == 0) /* folded: never entered */
+      break;
+    planUnrolling(t, prevStmt, &u);
+    if (u.full) {
+      for (k = 0; k < u.copies; k++)
+        lowerStmts(p2);
+      break;
+    }
+    end = irNewBlock(fn, "while: end");
+    if (u.copies == 1)
+      lowerLoop(p1, p2, &u, 1, end);
+    else {
+      /* the iterations left over: rest copies, or a
+       * loop of one
+       */
+      other = irNewBlock(fn, "while: rest");
+      lowerLoop(p1, p2, &u, u.copies, other);
+      startBlock(other);
+      if (u.rest >= 0) {
+        for (k = 0; k < u.rest; k++)
+          lowerStmts(p2);
+        jumpTo(end, NULL);
+      } else
+        lowerLoop(p1, p2, &u, 1, end);
+    }
+    startBlock(end);
+    break;
+
+  case CompoundK:
+    lowerStmts(p2);
+    break;
+
+  case ReturnK:
+    /* a return without a value goes on, as it always did */
+    if (p1 != NULL) {
+      int v = lowerExp(p1);
+      emit(IR_RET, "returning")->a = v;
+      startBlock(irNewBlock(fn, NULL));
+    }
+    break;
+
+  default:
+    break;
+  }
+}
+
+/* lowerStmts lowers the chain of statements starting
+ * at t, walking it through the compact AST
+ */
+static void lowerStmts(TreeNode *t) {
+  uint32_t i = t != NULL ? t->id : AST_NIL;
+  TreeNode *prev = NULL;
+  for (; i != AST_NIL; i = astNextInChain(&compactAst, i)) {
+    t = compactAst.tree[i];
+    prevStmt = prev;
+    if (t->nodekind == StmtK)
+      lowerStmt(t);
+    else if (t->nodekind == ExpK)
+      lowerExp(t);
+    prev = t;
+  }
+}
+
+IrFunc *lowerFunction(TreeNode *t, Arena *arena) {
+  fn = irNewFunc(t, arena);
+  startBlock(irNewBlock(fn, NULL));
+  lowerStmts(t->child[1]);
+  emit(IR_RET, NULL);
+  return fn;
+}
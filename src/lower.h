@@ -0,0 +1,24 @@
+/****************************************************/
+/* File: lower.h                                    */
+/* Lowering of the C- syntax tree to the            */
+/* intermediate code (ir.h)                         */
+/****************************************************/
+
+#ifndef _LOWER_H_
+#define _LOWER_H_
+
+#include "ir.h"
+
+/* Function lowerFunction lowers the analyzed function
+ * declaration t to a function of the intermediate
+ * code, allocated in arena. Variables stay in memory,
+ * where the TM code keeps them: a local or parameter
+ * at initFO - memloc from fp, a global at memloc from
+ * gp, the elements of a local array downwards from
+ * there, of a global array upwards, and those of an
+ * array parameter upwards from the address the
+ * parameter holds.
+ */
+IrFunc *lowerFunction(TreeNode *t, Arena *arena);
+
+#endif
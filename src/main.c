@@ -22,20 +22,28 @@
 #include "scan.h"
 #else
 #include "parse.h"
+#include "astio.h"
+#include "pparse.h"
+#include "rdparse.h"
 #if !NO_ANALYZE
 #include "analyze.h"
+#include "ast.h"
+#include "panalyze.h"
 #if !NO_CODE
+#include "callgraph.h"
 #include "cgen.h"
+#include "fold.h"
+#include "stream.h"
 #endif
 #endif
 #endif
 
 /* allocate global variables */
-int lineno = 0;
+_Thread_local int lineno = 0;
 FILE *source;
 FILE *listing;
 FILE *code;
-FILE *redundant_source;
+_Thread_local FILE *redundant_source;
 
 /* allocate and set tracing flags */
 int EchoSource = TRUE;
@@ -46,32 +54,105 @@ int TraceCode = TRUE;
 
 int Error = FALSE;
 
-int FirstLine = TRUE;
+_Thread_local int FirstLine = TRUE;
+
+/* allocate command-line options */
+char *DumpAstFile = NULL;
+char *LoadAstFile = NULL;
+int ParseThreads = 1;
+int HandParser = FALSE;
+int SymtabStats = FALSE;
+int TwoPassAnalysis = FALSE;
+int SemanticThreads = 1;
+int StreamCompile = FALSE;
+int KeepUnusedFunctions = FALSE;
+int PrintCallGraph = FALSE;
+char *PeepholeRules = NULL;
+int DumpIr = FALSE;
+char *IrPasses = NULL;
+int UnrollFactor = 4;
+
+static void usage(char *prog) {
+  fprintf(stderr,
+          "usage: %s [-callgraph] [-dumpast <astfile>] [-dumpir] [-keepunused] "
+          "[-loadast <astfile>] [-parsethreads <n>] [-passes <list>] "
+          "[-peephole <rules>] [-rdparse] "
+          "[-semthreads <n>] [-stream] [-symstats] [-twopass] [-unroll <n>] "
+          "<filename> [<detailpath>]\n",
+          prog);
+  exit(1);
+}
 
 int main(int argc, char *argv[]) {
   TreeNode *syntaxTree;
 
+  //// parsing options ////
+  char *args[2]; /* <filename> [<detailpath>] */
+  int nargs = 0, i;
+  for (i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-callgraph") == 0)
+      PrintCallGraph = TRUE;
+    else if (strcmp(argv[i], "-dumpast") == 0 && i + 1 < argc)
+      DumpAstFile = argv[++i];
+    else if (strcmp(argv[i], "-dumpir") == 0)
+      DumpIr = TRUE;
+    else if (strcmp(argv[i], "-keepunused") == 0)
+      KeepUnusedFunctions = TRUE;
+    else if (strcmp(argv[i], "-loadast") == 0 && i + 1 < argc)
+      LoadAstFile = argv[++i];
+    else if (strcmp(argv[i], "-parsethreads") == 0 && i + 1 < argc) {
+      ParseThreads = atoi(argv[++i]);
+      if (ParseThreads < 1)
+        usage(argv[0]);
+    } else if (strcmp(argv[i], "-passes") == 0 && i + 1 < argc)
+      IrPasses = argv[++i];
+    else if (strcmp(argv[i], "-peephole") == 0 && i + 1 < argc)
+      PeepholeRules = argv[++i];
+    else if (strcmp(argv[i], "-rdparse") == 0)
+      HandParser = TRUE;
+    else if (strcmp(argv[i], "-semthreads") == 0 && i + 1 < argc) {
+      SemanticThreads = atoi(argv[++i]);
+      if (SemanticThreads < 1)
+        usage(argv[0]);
+    } else if (strcmp(argv[i], "-stream") == 0)
+      StreamCompile = TRUE;
+    else if (strcmp(argv[i], "-symstats") == 0)
+      SymtabStats = TRUE;
+    else if (strcmp(argv[i], "-twopass") == 0)
+      TwoPassAnalysis = TRUE;
+    else if (strcmp(argv[i], "-unroll") == 0 && i + 1 < argc) {
+      UnrollFactor = atoi(argv[++i]);
+      if (UnrollFactor < 1)
+        usage(argv[0]);
+    }
+    else if (argv[i][0] == '-' || nargs == 2)
+      usage(argv[0]);
+    else
+      args[nargs++] = argv[i];
+  }
+  if (nargs < 1)
+    usage(argv[0]);
+
   //// opening sources ////
   char pgm[120]; /* source code file name */
-  if ((argc < 2) || (argc > 3)) {
-    fprintf(stderr, "usage: %s <filename> [<detailpath>]\n", argv[0]);
-    exit(1);
-  }
-  strcpy(pgm, argv[1]);
+  strcpy(pgm, args[0]);
   if (strchr(pgm, '.') == NULL)
     strcat(pgm, ".cm"); // if no extension is given, append .cm (c minus) to the
                         // filename
-  source = fopen(pgm, "r");
-  redundant_source = fopen(pgm, "r");
-  //<- use redundant_source to print whole lines in lex output
-  if (source == NULL || redundant_source == NULL) {
-    fprintf(stderr, "File %s not found\n", pgm);
-    exit(1);
+  /* a loaded tree replaces the source; pgm only names the outputs */
+  if (LoadAstFile == NULL) {
+    source = fopen(pgm, "r");
+    redundant_source = fopen(pgm, "r");
+    //<- use redundant_source to print whole lines in lex output
+    if (source == NULL || redundant_source == NULL) {
+      fprintf(stderr, "File %s not found\n", pgm);
+      exit(1);
+    }
   }
 
   char detailpath[200];
-  if (3 == argc) {
-    strcpy(detailpath, argv[2]);
+  if (2 == nargs) {
+    strcpy(detailpath, args[1]);
   } else
     strcpy(detailpath,
            "/tmp/"); // default detailpath is /tmp. Check there if you called by
@@ -83,12 +164,33 @@ int main(int argc, char *argv[]) {
   // for the lexical analysis, you might change LOGALL to LER, to generate only
   // lex and err outputs.
 
+  arenaInit(&compileArena, ARENA_BLOCK_SIZE);
+  arenaInit(&scratchArena, ARENA_BLOCK_SIZE);
+
   fprintf(listing, "\nTINY COMPILATION: %s\n", pgm);
 #if NO_PARSE
   while (getToken() != ENDFILE)
     ;
 #else
-  syntaxTree = parse();
+#if !NO_ANALYZE && !NO_CODE
+  if (StreamCompile && LoadAstFile == NULL) {
+    compileStream();
+    fclose(source);
+    arenaFree(&scratchArena);
+    arenaFree(&compileArena);
+    return 0;
+  }
+#endif
+  if (LoadAstFile != NULL) {
+    syntaxTree = astLoad(LoadAstFile);
+    if (syntaxTree == NULL)
+      exit(1);
+  } else if (ParseThreads > 1)
+    syntaxTree = parseParallel(ParseThreads);
+  else if (HandParser)
+    syntaxTree = parseRD();
+  else
+    syntaxTree = parse();
   doneLEXstartSYN();
   if (TraceParse) {
     fprintf(listing, "\nSyntax tree:\n");
@@ -97,13 +199,31 @@ int main(int argc, char *argv[]) {
 #if !NO_ANALYZE
   doneSYNstartTAB();
   if (!Error) {
+    /* analysis and code generation walk the compact layout */
+    astBuild(&compactAst, syntaxTree);
+    if (DumpAstFile != NULL && !astSave(DumpAstFile, syntaxTree)) {
+      fprintf(stderr, "Unable to write %s\n", DumpAstFile);
+      exit(1);
+    }
     if (TraceAnalyze)
       fprintf(listing, "\nBuilding Symbol Table...\n");
-    buildSymtab(syntaxTree);
+    if (TwoPassAnalysis)
+      buildSymtab(syntaxTree);
+    else if (SemanticThreads > 1)
+      analyzeParallel(syntaxTree, SemanticThreads);
+    else
+      analyze(syntaxTree);
+    arenaReset(&scratchArena);
+    if (SymtabStats)
+      st_dump_stats(stderr);
     if (TraceAnalyze) {
       fprintf(listing, "\nChecking Types...\n");
       mainError();
-      typeCheck(syntaxTree);
+      if (TwoPassAnalysis)
+        typeCheck(syntaxTree);
+      else
+        reportTypeErrors();
+      arenaReset(&scratchArena);
       fprintf(listing, "\nType Checking Finished\n");
     }
   }
@@ -120,12 +240,21 @@ int main(int argc, char *argv[]) {
       printf("Unable to open %s\n", codefile);
       exit(1);
     }
+    foldConstants(syntaxTree);
+    buildCallGraph();
+    if (PrintCallGraph)
+      printCallGraph(stderr);
     codeGen(syntaxTree, code);
+    arenaReset(&scratchArena);
     fclose(code);
   }
 #endif
 #endif
 #endif
-  fclose(source);
+  if (source != NULL)
+    fclose(source);
+  /* AST, strings and symbol table go away in one step */
+  arenaFree(&scratchArena);
+  arenaFree(&compileArena);
   return 0;
 }
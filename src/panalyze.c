@@ -0,0 +1,198 @@
+/****************************************************/
+/* File: panalyze.c                                 */
+/* Semantic analysis of the functions of a C-       */
+/* program on several threads                       */
+/****************************************************/
+
+#include "panalyze.h"
+#include "analyze.h"
+#include "ast.h"
+#include "util.h"
+#include <pthread.h>
+
+/* a top-level declaration of the program */
+typedef struct {
+  TreeNode *decl;
+  int seq;            /* number of the record of a function */
+  int end;            /* memory location after its variables */
+  Symtab table;       /* private table of a function */
+  LogCapture log;     /* listing of its analysis */
+  LogCapture typeLog; /* its type errors */
+} Item;
+
+/* the functions left to analyze */
+typedef struct {
+  Item **functions;
+  int count;
+  int next;
+  pthread_mutex_t lock;
+} Queue;
+
+/* a thread and the memory it allocates from */
+typedef struct {
+  Queue *queue;
+  Arena arena;   /* private tables of its functions */
+  Arena scratch; /* scope frames */
+} Worker;
+
+static int byName(const void *a, const void *b) {
+  return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+/* Function separable tells whether the functions can
+ * be analyzed apart: names (the functions and the
+ * built-in ones, sorted here) are all different, and
+ * no variable is called like one of them, so that a
+ * function sees only global records, and only those
+ * declared before it
+ */
+static int separable(char **names, int n) {
+  uint32_t i;
+  int k;
+  qsort(names, n, sizeof(char *), byName);
+  for (k = 1; k < n; k++)
+    if (strcmp(names[k - 1], names[k]) == 0)
+      return FALSE;
+  for (i = 0; i < compactAst.count; i++) {
+    AstNode *a = &compactAst.nodes[i];
+    if (a->nodekind == DeclK && a->kind == VarDeclK &&
+        bsearch(&compactAst.tree[i]->attr.name, names, n, sizeof(char *),
+                byName) != NULL)
+      return FALSE;
+  }
+  return TRUE;
+}
+
+/* analyzeFunctions is the body of a thread: it takes
+ * functions from the queue until none is left
+ */
+static void *analyzeFunctions(void *arg) {
+  Worker *w = (Worker *)arg;
+  Queue *q = w->queue;
+  for (;;) {
+    Item *item = NULL;
+    pthread_mutex_lock(&q->lock);
+    if (q->next < q->count)
+      item = q->functions[q->next++];
+    pthread_mutex_unlock(&q->lock);
+    if (item == NULL)
+      break;
+    item->table = st_private(item->seq, &w->arena);
+    st_use(item->table);
+    logCaptureBegin(&item->log);
+    item->end = analyzeDecl(item->decl, 0, &item->typeLog, &w->scratch);
+    logCaptureEnd();
+    st_use(NULL);
+    arenaReset(&w->scratch);
+  }
+  return NULL;
+}
+
+void analyzeParallel(TreeNode *syntaxTree, int numThreads) {
+  Item *items;
+  Item **functions;
+  char **names;
+  Worker *workers;
+  pthread_t *threads;
+  Queue queue;
+  TreeNode *t;
+  int numItems = 0, numFunctions = 0, i, n, loc, seq;
+
+  for (t = syntaxTree; t != NULL; t = t->sibling) {
+    numItems++;
+    if (t->nodekind == DeclK && t->kind.decl == FunDeclK)
+      numFunctions++;
+  }
+  names = (char **)malloc((numFunctions + 2) * sizeof(char *));
+  n = 0;
+  names[n++] = "input";
+  names[n++] = "output";
+  for (t = syntaxTree; t != NULL; t = t->sibling)
+    if (t->nodekind == DeclK && t->kind.decl == FunDeclK)
+      names[n++] = t->attr.name;
+  if (numFunctions < 2 || !separable(names, n)) {
+    free(names);
+    analyze(syntaxTree);
+    return;
+  }
+  free(names);
+
+  /* the global scope: every function gets a record, the
+   * variables are placed once the functions are done
+   */
+  items = (Item *)calloc(numItems, sizeof(Item));
+  functions = (Item **)malloc(numFunctions * sizeof(Item *));
+  st_insert("input", 0, "fun", "int", GLOBAL_SCOPE, 0);
+  st_insert("output", 0, "fun", "void", GLOBAL_SCOPE, 0);
+  numFunctions = 0;
+  for (t = syntaxTree, i = 0; t != NULL; t = t->sibling, i++) {
+    items[i].decl = t;
+    if (t->nodekind == DeclK && t->kind.decl == FunDeclK) {
+      t->symbol = st_insert(t->attr.name, t->lineno, "fun",
+                            typeName(t->typeReturn), GLOBAL_SCOPE, 0);
+      items[i].seq = t->symbol->seq;
+      functions[numFunctions++] = &items[i];
+    } else {
+      logCaptureBegin(&items[i].log);
+      items[i].end = analyzeDecl(t, 0, &items[i].typeLog, &scratchArena);
+      logCaptureEnd();
+    }
+  }
+
+  n = numThreads < numFunctions ? numThreads : numFunctions;
+  workers = (Worker *)calloc(n, sizeof(Worker));
+  threads = (pthread_t *)malloc(n * sizeof(pthread_t));
+  queue.functions = functions;
+  queue.count = numFunctions;
+  queue.next = 0;
+  pthread_mutex_init(&queue.lock, NULL);
+  for (i = 0; i < n; i++) {
+    workers[i].queue = &queue;
+    arenaInit(&workers[i].arena, ARENA_BLOCK_SIZE);
+    arenaInit(&workers[i].scratch, ARENA_BLOCK_SIZE);
+    if (pthread_create(&threads[i], NULL, analyzeFunctions, &workers[i]) !=
+        0) {
+      pce("Unable to start an analysis thread\n");
+      exit(1);
+    }
+  }
+  for (i = 0; i < n; i++)
+    pthread_join(threads[i], NULL);
+  pthread_mutex_destroy(&queue.lock);
+
+  /* merge in source order, numbering the records and
+   * placing the global variables as analyze does
+   */
+  seq = 2; /* after input and output */
+  loc = 0;
+  for (i = 0; i < numItems; i++) {
+    Item *item = &items[i];
+    t = item->decl;
+    logReplay(&item->log);
+    deferTypeErrors(&item->typeLog);
+    if (item->table != NULL) {
+      t->symbol->seq = seq++;
+      seq = st_merge(item->table, seq);
+      loc = item->end;
+    } else if (t->symbol != NULL) {
+      t->symbol->seq = seq++;
+      t->symbol->memloc = loc;
+      loc += item->end;
+    }
+    logCaptureFree(&item->log);
+    logCaptureFree(&item->typeLog);
+  }
+  for (i = 0; i < n; i++) {
+    arenaAdopt(&compileArena, &workers[i].arena);
+    arenaFree(&workers[i].scratch);
+  }
+  free(threads);
+  free(workers);
+  free(functions);
+  free(items);
+
+  if (TraceAnalyze) {
+    pc("\nSymbol table:\n\n");
+    printSymTab();
+  }
+}
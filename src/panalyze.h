@@ -0,0 +1,24 @@
+/****************************************************/
+/* File: panalyze.h                                 */
+/* Semantic analysis of the functions of a C-       */
+/* program on several threads                       */
+/****************************************************/
+
+#ifndef _PANALYZE_H_
+#define _PANALYZE_H_
+
+#include "globals.h"
+
+/* Procedure analyzeParallel does the work of analyze:
+ * the global declarations go into the symbol table
+ * first, then each function body is analyzed on one
+ * of numThreads threads into a private table, and the
+ * tables and listings are merged in source order, so
+ * the output is that of analyze. A program where a
+ * function could see the records of another (a name
+ * declared both as a function and as a variable, or
+ * a function declared twice) is analyzed sequentially.
+ */
+void analyzeParallel(TreeNode *syntaxTree, int numThreads);
+
+#endif
@@ -16,4 +16,19 @@
  */
 TreeNode *parse(void);
 
+/* Function parseEach parses the source as parse
+ * does, but hands every top-level declaration to
+ * handle as soon as it is reduced, without keeping
+ * the list of them; returns TRUE on a syntax error
+ */
+int parseEach(void (*handle)(TreeNode *));
+
+/* Function parseText parses, on the calling thread,
+ * the len bytes at text as a whole program whose
+ * first line is firstLine (see scanText); *failed is
+ * set if a syntax error was reported
+ */
+TreeNode *parseText(const char *text, int len, int firstLine, int isEnd,
+                    int *failed);
+
 #endif
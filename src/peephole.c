@@ -0,0 +1,242 @@
+/****************************************************/
+/* File: peephole.c                                 */
+/* Peephole optimization of the emitted TM code     */
+/****************************************************/
+
+#include "peephole.h"
+#include "code.h"
+#include <string.h>
+
+/* the instructions and how many there are */
+static TmInstr *instrs;
+static int size;
+
+/* label[loc] is TRUE if a jump or a return address
+ * may lead to loc
+ */
+static char *label;
+
+/* a rule tries to rewrite the code at loc and tells
+ * whether it did
+ */
+typedef struct {
+  const char *name;
+  int (*apply)(int loc);
+} Rule;
+
+static int live(int loc) { return !(instrs[loc].flags & TM_DEAD); }
+
+/* nextLive returns the first location after loc that
+ * is kept, size if there is none
+ */
+static int nextLive(int loc) {
+  do
+    loc++;
+  while (loc < size && !live(loc));
+  return loc;
+}
+
+/* resolve returns where a jump to loc really goes */
+static int resolve(int loc) {
+  if (loc < 0)
+    return loc;
+  return loc < size && live(loc) ? loc : nextLive(loc);
+}
+
+/* kill removes loc and tells that the code changed */
+static int kill(int loc) {
+  instrs[loc].flags |= TM_DEAD;
+  return TRUE;
+}
+
+static int isLDA(TmInstr *in, int r, int s) {
+  return in->op == opLDA && in->r == r && in->s == s;
+}
+
+/* writes returns the register in sets, -1 if none */
+static int writes(TmInstr *in) {
+  switch (in->op) {
+  case opIN:
+  case opADD:
+  case opSUB:
+  case opMUL:
+  case opDIV:
+  case opLD:
+  case opLDA:
+  case opLDC:
+    return in->r;
+  default:
+    return -1;
+  }
+}
+
+/* reads tells whether in may read register reg */
+static int reads(TmInstr *in, int reg) {
+  switch (in->op) {
+  case opHALT:
+  case opIN:
+  case opLDC:
+    return FALSE;
+  case opOUT:
+    return in->r == reg;
+  case opADD:
+  case opSUB:
+  case opMUL:
+  case opDIV:
+    return in->s == reg || in->t == reg;
+  case opLD:
+  case opLDA:
+    return in->s == reg;
+  case opSKIP:
+    return TRUE;
+  default: /* ST and the conditional jumps */
+    return in->r == reg || in->s == reg;
+  }
+}
+
+static int nop(int loc) {
+  TmInstr *in = &instrs[loc];
+  return in->r != PC && isLDA(in, in->r, in->r) && in->d == 0 && kill(loc);
+}
+
+static int jumpNext(int loc) {
+  int target = jumpTarget(loc);
+  return target != -1 && resolve(target) == nextLive(loc) && kill(loc);
+}
+
+static int chain(int loc) {
+  int target = jumpTarget(loc), hop, next;
+  if (target == -1)
+    return FALSE;
+  hop = resolve(target);
+  if (hop >= size || hop == loc || !isLDA(&instrs[hop], PC, PC))
+    return FALSE;
+  next = jumpTarget(hop);
+  if (next == target || resolve(next) == hop)
+    return FALSE; /* a loop of jumps stays as it is */
+  instrs[loc].d = next - (loc + 1);
+  if (next >= 0 && next < size)
+    label[next] = TRUE;
+  return TRUE;
+}
+
+static int merge(int loc) {
+  TmInstr *in = &instrs[loc];
+  int next = nextLive(loc);
+  if (in->r == PC || !isLDA(in, in->r, in->r) || next >= size ||
+      label[next] || !isLDA(&instrs[next], in->r, in->r))
+    return FALSE;
+  in->d += instrs[next].d;
+  return kill(next);
+}
+
+static int reload(int loc) {
+  TmInstr *in = &instrs[loc], *n;
+  int next = nextLive(loc);
+  if (in->op != opST || in->r == PC || next >= size || label[next])
+    return FALSE;
+  n = &instrs[next];
+  return n->op == opLD && n->r == in->r && n->s == in->s && n->d == in->d &&
+         kill(next);
+}
+
+static int move(int loc) {
+  TmInstr *in = &instrs[loc], *copy;
+  int a = writes(in), next = nextLive(loc), after;
+  if (a == -1 || a == PC || next >= size || label[next])
+    return FALSE;
+  copy = &instrs[next];
+  if (!isLDA(copy, copy->r, a) || copy->d != 0 || copy->r == a ||
+      copy->r == PC)
+    return FALSE;
+  /* a must be set anew before anything reads it */
+  after = nextLive(next);
+  if (after >= size || writes(&instrs[after]) != a || reads(&instrs[after], a))
+    return FALSE;
+  in->r = copy->r;
+  return kill(next);
+}
+
+static int dead(int loc) {
+  TmInstr *in = &instrs[loc];
+  int next, changed = FALSE;
+  if (in->op != opHALT && !((in->op == opLD || in->op == opLDA) && in->r == PC))
+    return FALSE;
+  for (next = nextLive(loc); next < size && !label[next] &&
+                             instrs[next].op != opSKIP;
+       next = nextLive(next))
+    changed = kill(next);
+  return changed;
+}
+
+static Rule rules[] = {{"nop", nop},       {"jump", jumpNext},
+                       {"chain", chain},   {"merge", merge},
+                       {"reload", reload}, {"move", move},
+                       {"dead", dead}};
+
+#define NUM_RULES ((int)(sizeof(rules) / sizeof(rules[0])))
+
+/* selectRules sets enabled[k] for each rule the comma
+ * separated list names, all of them for "all"
+ */
+static void selectRules(const char *names, char *enabled) {
+  const char *p = names;
+  int k;
+  while (*p != '\0') {
+    size_t len = strcspn(p, ",");
+    int found = len == 3 && strncmp(p, "all", 3) == 0;
+    for (k = 0; k < NUM_RULES; k++)
+      if (found || (strlen(rules[k].name) == len &&
+                    strncmp(p, rules[k].name, len) == 0)) {
+        enabled[k] = TRUE;
+        found = TRUE;
+      }
+    if (!found && !(len == 4 && strncmp(p, "none", 4) == 0))
+      fprintf(stderr, "unknown peephole rule %.*s\n", (int)len, p);
+    p += len;
+    if (*p == ',')
+      p++;
+  }
+}
+
+/* Procedure findLabels marks the targets of the jumps
+ * and return addresses kept
+ */
+static void findLabels(void) {
+  int loc;
+  memset(label, FALSE, size + 1);
+  for (loc = 0; loc < size; loc++) {
+    int target;
+    if (!live(loc))
+      continue;
+    target = jumpTarget(loc);
+    if (target == -1 && (instrs[loc].flags & TM_ADDR))
+      target = instrs[loc].d;
+    if (target >= 0 && target <= size)
+      label[resolve(target)] = TRUE;
+  }
+}
+
+void peephole(void) {
+  char enabled[NUM_RULES];
+  int loc, k, changed, rewritten = FALSE;
+
+  memset(enabled, PeepholeRules == NULL, sizeof(enabled));
+  if (PeepholeRules != NULL)
+    selectRules(PeepholeRules, enabled);
+  instrs = codeBuffer.instrs;
+  size = codeBuffer.size;
+  label = (char *)malloc(size + 1);
+  do {
+    changed = FALSE;
+    findLabels();
+    for (loc = 0; loc < size; loc++)
+      for (k = 0; k < NUM_RULES && live(loc); k++)
+        if (enabled[k] && instrs[loc].op != opSKIP && rules[k].apply(loc))
+          changed = TRUE;
+    rewritten |= changed;
+  } while (changed);
+  free(label);
+  if (rewritten)
+    emitCompact();
+}
@@ -0,0 +1,30 @@
+/****************************************************/
+/* File: peephole.h                                 */
+/* Peephole optimization of the emitted TM code     */
+/****************************************************/
+
+#ifndef _PEEPHOLE_H_
+#define _PEEPHOLE_H_
+
+#include "globals.h"
+
+/* Procedure peephole rewrites codeBuffer before it is
+ * written out, applying the rules PeepholeRules names
+ * until none applies:
+ *  nop      LDA r,0(r) is removed
+ *  jump     a jump to the next instruction is removed
+ *  chain    a jump to an unconditional jump goes
+ *           straight to its target
+ *  merge    LDA r,a(r) then LDA r,b(r) is LDA r,a+b(r)
+ *  reload   LD r,d(s) right after ST r,d(s) is removed
+ *  move     X a,... then LDA b,0(a), when the next
+ *           instruction sets a anew, is X b,...
+ *  dead     code no jump reaches after an unconditional
+ *           jump or HALT is removed
+ * A rule that would join two instructions never applies
+ * across a jump target. Removed instructions give way
+ * to the next one kept (see emitCompact).
+ */
+void peephole(void);
+
+#endif
@@ -0,0 +1,157 @@
+/****************************************************/
+/* File: pparse.c                                   */
+/* Parallel scanning and parsing of the top-level   */
+/* declarations of a C- program                     */
+/****************************************************/
+
+#include "pparse.h"
+#include "parse.h"
+#include <limits.h>
+#include <pthread.h>
+
+/* a piece of the source parsed by one thread */
+typedef struct {
+  const char *text;
+  int len;
+  int firstLine; /* line of the source text starts at */
+  int isEnd;     /* text runs to the end of the source */
+  TreeNode *tree;
+  int failed;
+  Arena arena;    /* nodes and names of the piece */
+  LogCapture log; /* listing of the piece */
+} Chunk;
+
+/* findBoundaries fills cut[1..n-1] with offsets where
+ * a new top-level declaration may start, about len/n
+ * bytes apart: just after a newline, at brace depth
+ * 0, outside comments, with ';' or '}' as the last
+ * character seen. cut[0] = 0 and cut[n] = len. Comments
+ * end exactly as in cminus.l. Returns the number of
+ * pieces found, which may be less than n.
+ */
+static int findBoundaries(const char *text, int len, int n, int *cut) {
+  int depth = 0, pieces = 1, i = 0;
+  char last = ';';
+  cut[0] = 0;
+  while (i < len && pieces < n) {
+    char c = text[i++];
+    if (c == '/' && i < len && text[i] == '*') {
+      i++;
+      do {
+        if (i >= len || (c = text[i++]) == (char)EOF)
+          break;
+      } while (c != '*' || (i < len ? text[i++] : '\0') != '/');
+    } else if (c == '{')
+      depth++, last = c;
+    else if (c == '}') {
+      if (--depth < 0)
+        break; /* unbalanced: leave the rest to one piece */
+      last = c;
+    } else if (c == '\n') {
+      if (depth == 0 && (last == ';' || last == '}') &&
+          i >= (long)len * pieces / n && i < len)
+        cut[pieces++] = i;
+    } else if (c != ' ' && c != '\t' && c != '\r')
+      last = c;
+  }
+  cut[pieces] = len;
+  return pieces;
+}
+
+static int lineCount(const char *text, int len) {
+  int lines = 0;
+  const char *p = text, *end = text + len;
+  while ((p = memchr(p, '\n', end - p)) != NULL)
+    lines++, p++;
+  return lines;
+}
+
+static void *parseChunk(void *arg) {
+  Chunk *c = (Chunk *)arg;
+  arenaInit(&c->arena, ARENA_BLOCK_SIZE);
+  syntaxArena = &c->arena;
+  logCaptureBegin(&c->log);
+  c->tree = parseText(c->text, c->len, c->firstLine, c->isEnd, &c->failed);
+  logCaptureEnd();
+  return NULL;
+}
+
+/* readSource reads the whole source file */
+static char *readSource(int *len) {
+  size_t size = 0, cap = 1 << 16, n;
+  char *text = (char *)malloc(cap);
+  while (text != NULL && (n = fread(text + size, 1, cap - size, source)) > 0)
+    if ((size += n) == cap)
+      text = (char *)realloc(text, cap *= 2);
+  if (text == NULL || size > INT_MAX) {
+    pce("Out of memory error reading the source\n");
+    exit(1);
+  }
+  *len = (int)size;
+  return text;
+}
+
+TreeNode *parseParallel(int numThreads) {
+  TreeNode *root = NULL, *t;
+  Chunk *chunks;
+  pthread_t *threads;
+  int *cut, len, n, i, line, failed = FALSE;
+  char *text = readSource(&len);
+
+  cut = (int *)malloc((numThreads + 1) * sizeof(int));
+  n = findBoundaries(text, len, numThreads, cut);
+  if (n < 2) {
+    free(cut);
+    free(text);
+    rewind(source);
+    return parse();
+  }
+  chunks = (Chunk *)calloc(n, sizeof(Chunk));
+  threads = (pthread_t *)malloc(n * sizeof(pthread_t));
+  line = 1;
+  for (i = 0; i < n; i++) {
+    chunks[i].text = text + cut[i];
+    chunks[i].len = cut[i + 1] - cut[i];
+    chunks[i].firstLine = line;
+    chunks[i].isEnd = i == n - 1;
+    line += lineCount(chunks[i].text, chunks[i].len);
+  }
+  for (i = 0; i < n; i++)
+    if (pthread_create(&threads[i], NULL, parseChunk, &chunks[i]) != 0) {
+      pce("Unable to start a parsing thread\n");
+      exit(1);
+    }
+  for (i = 0; i < n; i++)
+    pthread_join(threads[i], NULL);
+
+  for (i = 0; i < n; i++)
+    failed = failed || chunks[i].failed || chunks[i].tree == NULL;
+  if (!failed) {
+    /* stitch the list_decl chains in source order */
+    t = NULL;
+    for (i = 0; i < n; i++) {
+      if (t == NULL)
+        root = chunks[i].tree;
+      else
+        t->sibling = chunks[i].tree;
+      for (t = chunks[i].tree; t->sibling != NULL; t = t->sibling)
+        ;
+      logReplay(&chunks[i].log);
+      arenaAdopt(&compileArena, &chunks[i].arena);
+    }
+  }
+  for (i = 0; i < n; i++) {
+    logCaptureFree(&chunks[i].log);
+    if (failed)
+      arenaFree(&chunks[i].arena);
+  }
+  free(threads);
+  free(chunks);
+  free(cut);
+  free(text);
+  if (failed) {
+    rewind(source);
+    return parse();
+  }
+  return root;
+}
@@ -0,0 +1,21 @@
+/****************************************************/
+/* File: pparse.h                                   */
+/* Parallel scanning and parsing of the top-level   */
+/* declarations of a C- program                     */
+/****************************************************/
+
+#ifndef _PPARSE_H_
+#define _PPARSE_H_
+
+#include "globals.h"
+
+/* Function parseParallel splits the source file at
+ * top-level declaration boundaries into up to
+ * numThreads pieces, parses them concurrently and
+ * returns the same tree (and listing) as parse().
+ * On a syntax error the source is parsed again
+ * sequentially, so diagnostics are those of parse().
+ */
+TreeNode *parseParallel(int numThreads);
+
+#endif
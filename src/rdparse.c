@@ -0,0 +1,445 @@
+/****************************************************/
+/* File: rdparse.c                                  */
+/* Hand-written recursive-descent parser for C-     */
+/* with Pratt parsing of expressions                */
+/****************************************************/
+
+/* The tree, line numbers included, is the one cminus.y
+ * builds. Bison sets a node's lineno when it reduces
+ * the rule, which is before reading the next token
+ * when the rule ends in a state without choices and
+ * after it otherwise; so tokens here are only read on
+ * demand (peek), and a node is made where bison would
+ * reduce it: after the peek that ends an open-ended
+ * construct (var, sum, relation, if without else),
+ * right after the closing token otherwise.
+ */
+
+#include "rdparse.h"
+#include "../build/parser.h"
+#include "scan.h"
+#include "util.h"
+#include <setjmp.h>
+
+static _Thread_local TokenType token; /* lookahead, if haveToken */
+static _Thread_local int haveToken;
+static _Thread_local jmp_buf bail; /* taken on a syntax error */
+
+static TokenType peek(void) {
+  if (!haveToken) {
+    token = getToken();
+    haveToken = TRUE;
+  }
+  return token;
+}
+
+/* advance consumes the lookahead; its lexeme is left
+ * in tokenString until the next peek
+ */
+static void advance(void) {
+  peek();
+  haveToken = FALSE;
+}
+
+/* same report as yyerror in cminus.y */
+static void reportError(void) {
+  pce("Syntax error at line %d: %s\n", lineno, "syntax error");
+  pce("Current token: ");
+  printToken(peek(), tokenString);
+  Error = TRUE;
+}
+
+static void syntaxError(void) {
+  reportError();
+  longjmp(bail, 1);
+}
+
+static void match(TokenType expected) {
+  if (peek() != expected)
+    syntaxError();
+  advance();
+}
+
+/* append adds t (possibly NULL) at the end of the
+ * sibling list head, as the list rules of cminus.y do
+ */
+static TreeNode *append(TreeNode *head, TreeNode *t) {
+  TreeNode *last = head;
+  if (head == NULL)
+    return t;
+  while (last->sibling != NULL)
+    last = last->sibling;
+  last->sibling = t;
+  return head;
+}
+
+static TreeNode *expression(void);
+static TreeNode *statement(void);
+static TreeNode *compound(void);
+
+/**************************************************/
+/***********   Declarations            ************/
+/**************************************************/
+
+static ExpType typeSpec(void) {
+  switch (peek()) {
+  case INT:
+    advance();
+    return Integer;
+  case VOID:
+    advance();
+    return Void;
+  default:
+    syntaxError();
+    return Void;
+  }
+}
+
+/* param: type_spec ID | type_spec ID [ ] */
+static TreeNode *param(ExpType type) {
+  TreeNode *t;
+  char *name;
+  match(ID);
+  name = copyString(tokenString);
+  if (peek() == LBRACKET) {
+    advance();
+    match(RBRACKET);
+    t = newDeclNode(ParamK);
+    t->isArray = 1;
+  } else {
+    t = newDeclNode(ParamK);
+    t->isArray = 0;
+  }
+  t->type = type;
+  t->attr.name = name;
+  return t;
+}
+
+/* params: list_params | VOID */
+static TreeNode *params(void) {
+  TreeNode *list;
+  ExpType type;
+  if (peek() == VOID) {
+    advance();
+    if (peek() == RPAREN)
+      return NULL;
+    type = Void;
+  } else
+    type = typeSpec();
+  list = param(type);
+  while (peek() == COMMA) {
+    advance();
+    type = typeSpec();
+    list = append(list, param(type));
+  }
+  return list;
+}
+
+/* decl: var_decl | fun_decl; a block's leading local
+ * declarations (allowFun = FALSE) are var_decls only
+ */
+static TreeNode *declaration(int allowFun) {
+  TreeNode *t, *body, *plist;
+  ExpType type = typeSpec();
+  char *name;
+  int line, size;
+  match(ID);
+  name = copyString(tokenString);
+  switch (peek()) {
+  case SEMI:
+    advance();
+    t = newDeclNode(VarDeclK);
+    t->isArray = 0;
+    break;
+  case LBRACKET:
+    advance();
+    match(NUM);
+    size = atoi(tokenString);
+    match(RBRACKET);
+    match(SEMI);
+    t = newDeclNode(VarDeclK);
+    t->isArray = 1;
+    t->child[0] = newExpNode(ConstK);
+    t->child[0]->attr.val = size;
+    break;
+  case LPAREN:
+    if (!allowFun)
+      syntaxError();
+    line = lineno;
+    advance();
+    plist = params();
+    match(RPAREN);
+    body = compound();
+    t = newDeclNode(FunDeclK);
+    t->lineno = line;
+    t->typeReturn = type;
+    t->child[0] = plist;
+    t->child[1] = body;
+    break;
+  default:
+    syntaxError();
+    return NULL;
+  }
+  t->type = type;
+  t->attr.name = name;
+  return t;
+}
+
+/**************************************************/
+/***********   Statements              ************/
+/**************************************************/
+
+/* decl_compo: { local_decl list_stmt } */
+static TreeNode *compound(void) {
+  TreeNode *t, *decls = NULL, *stmts = NULL;
+  match(LBRACE);
+  while (peek() == INT || peek() == VOID)
+    decls = append(decls, declaration(FALSE));
+  while (peek() != RBRACE)
+    stmts = append(stmts, statement());
+  advance();
+  t = newStmtNode(CompoundK);
+  t->child[0] = decls;
+  t->child[1] = stmts;
+  return t;
+}
+
+static TreeNode *statement(void) {
+  TreeNode *t, *e, *s;
+  switch (peek()) {
+  case IF:
+    advance();
+    match(LPAREN);
+    e = expression();
+    match(RPAREN);
+    s = statement();
+    if (peek() == ELSE) {
+      TreeNode *other;
+      advance();
+      other = statement();
+      t = newStmtNode(IfK);
+      t->child[2] = other;
+    } else
+      t = newStmtNode(IfK);
+    t->child[0] = e;
+    t->child[1] = s;
+    return t;
+  case WHILE:
+    advance();
+    match(LPAREN);
+    e = expression();
+    match(RPAREN);
+    s = statement();
+    t = newStmtNode(WhileK);
+    t->child[0] = e;
+    t->child[1] = s;
+    return t;
+  case RETURN:
+    advance();
+    if (peek() == SEMI) {
+      advance();
+      t = newStmtNode(ReturnK);
+      t->type = Void;
+    } else {
+      e = expression();
+      match(SEMI);
+      t = newStmtNode(ReturnK);
+      t->child[0] = e;
+      t->type = e->type;
+    }
+    return t;
+  case LBRACE:
+    return compound();
+  case SEMI:
+    advance();
+    return NULL;
+  case INT:
+  case VOID:
+    return declaration(TRUE);
+  default:
+    e = expression();
+    match(SEMI);
+    return e;
+  }
+}
+
+/**************************************************/
+/***********   Expressions             ************/
+/**************************************************/
+
+/* binding powers of the binary operators; relations
+ * do not chain and unary minus may only start a sum
+ */
+#define REL_POWER 1
+#define ADD_POWER 2
+#define MUL_POWER 3
+
+static int infixPower(TokenType op) {
+  switch (op) {
+  case LT:
+  case LTE:
+  case GT:
+  case GTE:
+  case EQQ:
+  case NEQ:
+    return REL_POWER;
+  case PLUS:
+  case MINUS:
+    return ADD_POWER;
+  case TIMES:
+  case OVER:
+    return MUL_POWER;
+  default:
+    return 0;
+  }
+}
+
+/* var: ID | ID [ exp ]   ativ: ID ( args ) */
+static TreeNode *variableOrCall(void) {
+  TreeNode *t, *e, *args = NULL;
+  char *name;
+  match(ID);
+  name = copyString(tokenString);
+  switch (peek()) {
+  case LBRACKET:
+    advance();
+    e = expression();
+    match(RBRACKET);
+    t = newExpNode(VarK);
+    t->isArray = 1;
+    t->child[0] = e;
+    break;
+  case LPAREN:
+    advance();
+    if (peek() != RPAREN) {
+      args = expression();
+      while (peek() == COMMA) {
+        advance();
+        args = append(args, expression());
+      }
+    }
+    match(RPAREN);
+    t = newExpNode(CallK);
+    t->child[0] = args;
+    break;
+  default:
+    t = newExpNode(VarK);
+    t->isArray = 0;
+    break;
+  }
+  t->attr.name = name;
+  return t;
+}
+
+/* factor: ( exp ) | var | ativ | NUM */
+static TreeNode *factor(void) {
+  TreeNode *t;
+  switch (peek()) {
+  case LPAREN:
+    advance();
+    t = expression();
+    match(RPAREN);
+    return t;
+  case NUM:
+    advance();
+    t = newExpNode(ConstK);
+    t->attr.val = atoi(tokenString);
+    t->type = Integer;
+    return t;
+  case ID:
+    return variableOrCall();
+  default:
+    syntaxError();
+    return NULL;
+  }
+}
+
+static TreeNode *binary(int minPower, TreeNode *left);
+
+/* prefix: - term at the start of a sum, else factor */
+static TreeNode *prefix(int minPower) {
+  TreeNode *t, *operand;
+  if (peek() == MINUS && minPower <= REL_POWER) {
+    advance();
+    operand = binary(ADD_POWER, NULL);
+    t = newExpNode(OpK);
+    t->child[0] = operand;
+    t->attr.op = MINUS;
+    return t;
+  }
+  return factor();
+}
+
+/* binary parses operators binding tighter than
+ * minPower, after the operand left (parsed here if
+ * NULL)
+ */
+static TreeNode *binary(int minPower, TreeNode *left) {
+  if (left == NULL)
+    left = prefix(minPower);
+  for (;;) {
+    TokenType op = peek();
+    int power = infixPower(op);
+    TreeNode *t, *right;
+    if (power <= minPower)
+      return left;
+    advance();
+    /* nothing binds tighter than a product: its right
+     * operand ends without looking at the next token
+     */
+    right = power == MUL_POWER ? factor() : binary(power, NULL);
+    t = newExpNode(OpK);
+    t->child[0] = left;
+    t->child[1] = right;
+    t->attr.op = op;
+    left = t;
+    if (power == REL_POWER)
+      minPower = REL_POWER;
+  }
+}
+
+/* exp: var = exp | simple_exp */
+static TreeNode *expression(void) {
+  TreeNode *left = NULL;
+  if (peek() == ID) {
+    left = variableOrCall();
+    if (left->kind.exp == VarK && peek() == EQ) {
+      TreeNode *t, *value;
+      advance();
+      value = expression();
+      t = newExpNode(AssignK);
+      if (left->isArray) {
+        t->child[0] = left->child[0];
+        t->child[1] = value;
+      } else
+        t->child[0] = value;
+      t->isArray = left->isArray;
+      t->attr.name = left->attr.name;
+      return t;
+    }
+  }
+  return binary(0, left);
+}
+
+/**************************************************/
+/***********   Program                 ************/
+/**************************************************/
+
+TreeNode *parseRD(void) {
+  TreeNode *list;
+  haveToken = FALSE;
+  if (setjmp(bail) != 0)
+    return NULL;
+  list = declaration(TRUE);
+  while (peek() != 0) {
+    if (peek() != INT && peek() != VOID) {
+      /* bison reduces the program before it sees the
+       * error, so the declarations so far are kept
+       */
+      reportError();
+      return list;
+    }
+    list = append(list, declaration(TRUE));
+  }
+  return list;
+}
@@ -0,0 +1,18 @@
+/****************************************************/
+/* File: rdparse.h                                  */
+/* Hand-written recursive-descent parser for C-     */
+/* (an alternative to the bison parser)             */
+/****************************************************/
+
+#ifndef _RDPARSE_H_
+#define _RDPARSE_H_
+
+#include "globals.h"
+
+/* Function parseRD returns the syntax tree of the
+ * source, built exactly as parse() builds it, with
+ * the same listing and syntax errors
+ */
+TreeNode *parseRD(void);
+
+#endif
@@ -0,0 +1,326 @@
+/****************************************************/
+/* File: regalloc.c                                 */
+/* Register allocation for the intermediate code    */
+/****************************************************/
+
+#include "regalloc.h"
+#include "cgen.h"
+#include "code.h"
+#include "dataflow.h"
+#include <limits.h>
+#include <stdlib.h>
+
+/* the TM registers handed out, ac first: a call
+ * returns its value there
+ */
+static const int tmRegs[] = {ac, ac1, ac2, mp};
+#define NUM_REGS 4
+
+/* state of one round of allocation, for f */
+static IrFunc *f;
+static Dataflow live;          /* of the registers */
+static int *start, *end;       /* live range of each register */
+static int *hint;              /* register wanted, or -1 */
+static int *numRefs;           /* uses and definitions */
+static int firstReload;        /* spill code from here on */
+static char *spilled;          /* to spill this round */
+static int numSpilled;
+static int *calls, numCalls; /* positions of the calls */
+
+static void extend(int v, int pos) {
+  if (pos < start[v])
+    start[v] = pos;
+  if (pos > end[v])
+    end[v] = pos;
+}
+
+/* Procedure buildRanges numbers the instructions in
+ * layout order, two positions each (the uses, then the
+ * definition), and sets the range from the first to
+ * the last position each register is live at
+ */
+static void buildRanges(void) {
+  IrBlock *b;
+  IrInstr *in;
+  int pos = 0, v, n, k, u;
+  for (v = 0; v < f->numVregs; v++) {
+    start[v] = INT_MAX;
+    end[v] = -1;
+    hint[v] = -1;
+    numRefs[v] = 0;
+  }
+  numCalls = 0;
+  for (b = f->first; b != NULL; b = b->next) {
+    int first = pos, last;
+    for (in = b->first; in != NULL; in = in->next)
+      pos += 2;
+    last = pos - 1;
+    for (v = IR_FIRST; v < f->numVregs; v++) {
+      if (dfTest(DF_SET(&live, live.in, b), v))
+        extend(v, first);
+      if (dfTest(DF_SET(&live, live.out, b), v))
+        extend(v, last);
+    }
+    for (in = b->first, pos = first; in != NULL; in = in->next, pos += 2) {
+      n = irNumUses(in);
+      for (k = 0; k < n; k++)
+        if ((u = *irUse(in, k)) >= IR_FIRST) {
+          extend(u, pos);
+          numRefs[u]++;
+        }
+      if (in->dst != IR_NONE) {
+        extend(in->dst, pos + 1);
+        numRefs[in->dst]++;
+      }
+      if (in->op == IR_CALL) {
+        calls[numCalls++] = pos;
+        if (in->dst != IR_NONE)
+          hint[in->dst] = ac;
+      }
+      if (in->op == IR_RET && in->a >= IR_FIRST)
+        hint[in->a] = ac;
+    }
+  }
+}
+
+static int canSpill(int v) { return v < firstReload; }
+
+/* cheaper tells whether spilling x costs less than
+ * spilling y, for the room it makes: fewer uses and
+ * definitions over a longer range
+ */
+static int cheaper(int x, int y) {
+  long long lx = end[x] - start[x] + 1, ly = end[y] - start[y] + 1;
+  return (long long)numRefs[x] * ly < (long long)numRefs[y] * lx;
+}
+
+static void spill(int v) {
+  if (!spilled[v]) {
+    spilled[v] = TRUE;
+    numSpilled++;
+  }
+}
+
+/* Procedure spillAcrossCalls spills the registers live
+ * across a call, which clobbers every register
+ */
+static void spillAcrossCalls(void) {
+  int v, lo, hi, mid;
+  for (v = IR_FIRST; v < f->numVregs; v++) {
+    if (start[v] == INT_MAX)
+      continue;
+    /* the first call at or after start[v] */
+    lo = 0;
+    hi = numCalls;
+    while (lo < hi) {
+      mid = (lo + hi) / 2;
+      if (calls[mid] < start[v])
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    if (lo < numCalls && calls[lo] + 1 < end[v])
+      spill(v);
+  }
+}
+
+static int byStart(const void *x, const void *y) {
+  int a = *(const int *)x, b = *(const int *)y;
+  return start[a] != start[b] ? (start[a] < start[b] ? -1 : 1) : a - b;
+}
+
+/* Procedure linearScan gives the registers out in the
+ * order their ranges start, spilling the cheapest
+ * when none is free
+ */
+static void linearScan(void) {
+  int *order, numOrder = 0, active[NUM_REGS], numActive = 0;
+  int v, i, k, r, victim, busy;
+  order = (int *)malloc(f->numVregs * sizeof(int));
+  for (v = IR_FIRST; v < f->numVregs; v++)
+    if (start[v] != INT_MAX)
+      order[numOrder++] = v;
+  qsort(order, numOrder, sizeof(int), byStart);
+  for (i = 0; i < numOrder; i++) {
+    v = order[i];
+    for (k = 0; k < numActive;)
+      if (end[active[k]] < start[v])
+        active[k] = active[--numActive];
+      else
+        k++;
+    if (numActive == NUM_REGS) {
+      victim = canSpill(v) ? v : -1;
+      for (k = 0; k < numActive; k++)
+        if (canSpill(active[k]) && (victim == -1 || cheaper(active[k], victim)))
+          victim = active[k];
+      if (victim == -1) /* never: reloads need 2 at most */
+        victim = v;
+      spill(victim);
+      if (victim == v)
+        continue;
+      for (k = 0; active[k] != victim; k++)
+        ;
+      f->reg[v] = f->reg[victim];
+      active[k] = v;
+      continue;
+    }
+    busy = 0;
+    for (k = 0; k < numActive; k++)
+      busy |= 1 << f->reg[active[k]];
+    r = -1;
+    if (hint[v] != -1 && !(busy & (1 << hint[v])))
+      r = hint[v];
+    for (k = 0; r == -1 && k < NUM_REGS; k++)
+      if (!(busy & (1 << tmRegs[k])))
+        r = tmRegs[k];
+    f->reg[v] = r;
+    active[numActive++] = v;
+  }
+  free(order);
+}
+
+/* reload loads v from its slot just before in, into
+ * a register of its own, or computes it again there
+ * if remat is how
+ */
+static int reload(IrInstr *in, int slot, IrInstr *remat) {
+  IrInstr *load = irInsertBefore(f, in, remat != NULL ? remat->op : IR_LOAD);
+  if (remat != NULL) {
+    load->a = remat->a;
+    load->imm = remat->imm;
+    load->sym = remat->sym;
+    load->comment = remat->comment;
+  } else {
+    load->a = IR_FP;
+    load->imm = slot;
+    load->comment = "spill: reload";
+  }
+  return load->dst = irNewVreg(f);
+}
+
+/* Procedure findRemats sets remat[v] for the registers
+ * defined once, by a constant or a load of a frame
+ * variable nothing stores to: a spill of one computes
+ * it again instead
+ */
+static void findRemats(IrInstr **remat) {
+  IrBlock *b;
+  IrInstr *in;
+  char *stored = (char *)calloc(f->frameSize + 1, 1), *many;
+  int v;
+  many = (char *)calloc(f->numVregs, 1);
+  for (v = 0; v < f->numVregs; v++)
+    remat[v] = NULL;
+  for (b = f->first; b != NULL; b = b->next)
+    for (in = b->first; in != NULL; in = in->next) {
+      if (in->op == IR_STORE && in->a == IR_FP && initFO - in->imm >= 0 &&
+          initFO - in->imm < f->frameSize)
+        stored[initFO - in->imm] = TRUE;
+      if (in->dst == IR_NONE)
+        continue;
+      if (remat[in->dst] != NULL)
+        many[in->dst] = TRUE;
+      remat[in->dst] = in;
+    }
+  for (v = IR_FIRST; v < f->numVregs; v++) {
+    in = remat[v];
+    if (in == NULL)
+      continue;
+    if (many[v] ||
+        (in->op != IR_CONST &&
+         (in->op != IR_LOAD || in->sym == NULL || in->a != IR_FP ||
+          initFO - in->imm < 0 || initFO - in->imm >= f->frameSize ||
+          stored[initFO - in->imm])))
+      remat[v] = NULL;
+  }
+  free(many);
+  free(stored);
+}
+
+/* Procedure rewriteSpills stores every spilled
+ * register to a slot of the frame after each of its
+ * definitions, and loads it back before each use;
+ * the registers in between are new ones, with
+ * ranges too short to spill
+ */
+static void rewriteSpills(void) {
+  IrBlock *b;
+  IrInstr *in, *next, *store, **remat;
+  int v, w, numVregs = f->numVregs;
+  int *slot = (int *)malloc(numVregs * sizeof(int));
+  remat = (IrInstr **)malloc(numVregs * sizeof(IrInstr *));
+  findRemats(remat);
+  for (v = IR_FIRST; v < numVregs; v++)
+    if (spilled[v] && remat[v] == NULL)
+      slot[v] = initFO - f->frameSize++;
+  for (b = f->first; b != NULL; b = b->next)
+    for (in = b->first; in != NULL; in = next) {
+      next = in->next;
+      if (in->a >= IR_FIRST && in->a < numVregs && spilled[in->a]) {
+        w = reload(in, slot[in->a], remat[in->a]);
+        if (in->b == in->a)
+          in->b = w;
+        in->a = w;
+      }
+      if (in->b >= IR_FIRST && in->b < numVregs && spilled[in->b])
+        in->b = reload(in, slot[in->b], remat[in->b]);
+      if (in->dst < IR_FIRST || in->dst >= numVregs || !spilled[in->dst])
+        continue;
+      if (remat[in->dst] != NULL) {
+        irRemove(in); /* computed again where it is used */
+        continue;
+      }
+      store = irInsertAfter(f, in, IR_STORE);
+      store->a = IR_FP;
+      store->b = irNewVreg(f);
+      store->imm = slot[in->dst];
+      store->comment = "spill: store";
+      in->dst = store->b;
+      next = store->next;
+    }
+  free(remat);
+  free(slot);
+}
+
+void allocRegisters(IrFunc *func) {
+  IrBlock *b;
+  IrInstr *in;
+  int v, numInstrs = 0;
+  f = func;
+  for (b = f->first; b != NULL; b = b->next)
+    for (in = b->first; in != NULL; in = in->next)
+      numInstrs++;
+  f->frameSize = f->sizeOfVars;
+  firstReload = f->numVregs;
+  irComputePreds(f);
+  for (;;) {
+    start = (int *)malloc(f->numVregs * sizeof(int));
+    end = (int *)malloc(f->numVregs * sizeof(int));
+    hint = (int *)malloc(f->numVregs * sizeof(int));
+    numRefs = (int *)malloc(f->numVregs * sizeof(int));
+    spilled = (char *)calloc(f->numVregs, 1);
+    calls = (int *)malloc((numInstrs + 1) * sizeof(int));
+    f->reg = (int *)arenaAlloc(f->arena, f->numVregs * sizeof(int));
+    for (v = 0; v < f->numVregs; v++)
+      f->reg[v] = ac;
+    f->reg[IR_FP] = fp;
+    f->reg[IR_GP] = gp;
+    numSpilled = 0;
+    liveRegisters(&live, f);
+    buildRanges();
+    spillAcrossCalls();
+    if (numSpilled == 0)
+      linearScan();
+    if (numSpilled > 0)
+      rewriteSpills();
+    dfFree(&live);
+    free(start);
+    free(end);
+    free(hint);
+    free(numRefs);
+    free(spilled);
+    free(calls);
+    if (numSpilled == 0)
+      break;
+  }
+}
@@ -0,0 +1,24 @@
+/****************************************************/
+/* File: regalloc.h                                 */
+/* Register allocation for the intermediate code    */
+/****************************************************/
+
+#ifndef _REGALLOC_H_
+#define _REGALLOC_H_
+
+#include "ir.h"
+
+/* Procedure allocRegisters gives every virtual
+ * register of f one of the TM registers ac, ac1, ac2
+ * and mp (fp and gp for IR_FP and IR_GP) in f->reg,
+ * by a linear scan over the live range of each. A
+ * value live across a call, or one no register is
+ * left for, is spilled: stored to a slot of the frame
+ * below the variables, and loaded back before every
+ * use; a constant, or a variable nothing stores to,
+ * is computed again instead. f->frameSize counts the
+ * slots.
+ */
+void allocRegisters(IrFunc *f);
+
+#endif
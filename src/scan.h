@@ -12,12 +12,25 @@
 #define MAXTOKENLEN 40
 
 /* tokenString array stores the lexeme of each token */
-extern char tokenString[MAXTOKENLEN + 1];
+extern _Thread_local char tokenString[MAXTOKENLEN + 1];
 
-extern char prevTokenString[MAXTOKENLEN + 1];
+extern _Thread_local char prevTokenString[MAXTOKENLEN + 1];
 /* function getToken returns the
  * next token in source file
  */
 TokenType getToken(void);
 
+/* Procedure scanText makes the calling thread's
+ * getToken read the len bytes at text, which start
+ * at line firstLine of the source, instead of the
+ * source file; isEnd tells whether they run to the
+ * end of the source (only then is EOF traced)
+ */
+void scanText(const char *text, int len, int firstLine, int isEnd);
+
+/* Procedure scanTextDone releases the scanner set
+ * up by scanText
+ */
+void scanTextDone(void);
+
 #endif
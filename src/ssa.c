@@ -0,0 +1,465 @@
+/****************************************************/
+/* File: ssa.c                                      */
+/* SSA form of the intermediate code (ir.h)         */
+/****************************************************/
+
+#include "ssa.h"
+#include "cgen.h"
+#include "dataflow.h"
+#include "iropt.h"
+#include <stdlib.h>
+#include <string.h>
+
+static IrFunc *f;
+static BucketList *syms; /* of each variable */
+static int *top;         /* value of each variable here */
+static int *undefined;   /* value of one never set */
+static int *logVar, *logOld, logTop; /* to undo top */
+static IrBlock **child, **sibling;   /* dominator tree */
+
+/* varOfSlot returns the variable in loads or stores,
+ * -1 if it is none: its memloc, as only the frame
+ * variables with a sym are scalars
+ */
+static int varOfSlot(IrInstr *in) {
+  int loc;
+  if ((in->op != IR_LOAD && in->op != IR_STORE) || in->sym == NULL ||
+      in->a != IR_FP)
+    return -1;
+  loc = initFO - in->imm;
+  return loc >= 0 && loc < f->sizeOfVars ? loc : -1;
+}
+
+static void push(int v, int value) {
+  logVar[logTop] = v;
+  logOld[logTop++] = top[v];
+  top[v] = value;
+}
+
+/* valueOf returns the value of v here: 0 if no path
+ * sets it, as no path from the entry reads it then
+ */
+static int valueOf(int v) {
+  IrInstr *in;
+  if (top[v] != IR_NONE)
+    return top[v];
+  if (undefined[v] == IR_NONE) {
+    in = f->first->first != NULL ? irInsertBefore(f, f->first->first, IR_CONST)
+                                 : irAppend(f, f->first, IR_CONST);
+    in->dst = undefined[v] = irNewVreg(f);
+  }
+  return undefined[v];
+}
+
+/* renameVars walks the dominator tree from b, making
+ * each load of a variable a copy of its value there
+ */
+static void renameVars(IrBlock *b) {
+  IrInstr *in, *next;
+  IrBlock *succ[2], *c;
+  int mark = logTop, v, i, j, n;
+  for (in = b->first; in != NULL; in = next) {
+    next = in->next;
+    if (in->op == IR_PHI) {
+      push(in->imm, in->dst);
+      continue;
+    }
+    v = varOfSlot(in);
+    if (v == -1)
+      continue;
+    if (in->op == IR_LOAD) {
+      in->op = IR_MOV;
+      in->a = valueOf(v);
+      in->imm = 0;
+      in->sym = NULL;
+    } else {
+      push(v, in->b);
+      irRemove(in);
+    }
+  }
+  n = irSuccessors(b, succ);
+  for (i = 0; i < n; i++) {
+    for (j = 0; succ[i]->preds[j] != b; j++)
+      ;
+    for (in = succ[i]->first; in != NULL && in->op == IR_PHI; in = in->next)
+      in->args[j] = valueOf(in->imm);
+  }
+  for (c = child[b->id]; c != NULL; c = sibling[c->id])
+    renameVars(c);
+  while (logTop > mark) {
+    logTop--;
+    top[logVar[logTop]] = logOld[logTop];
+  }
+}
+
+void enterSsa(IrFunc *func) {
+  IrBlock *b, ***frontier, **work;
+  IrInstr *in, *phi;
+  Dataflow live;
+  int numVars, numWork, numLog = 1, v, k;
+  int *hasPhi, *queued, *entryValue;
+  f = func;
+  if (f->inSsa || f->first == NULL)
+    return;
+  removeUnreachableBlocks(f);
+  irComputePreds(f);
+  computeDominators(f);
+  frontier = dominanceFrontiers(f);
+  numVars = f->sizeOfVars;
+  syms = (BucketList *)calloc(numVars + 1, sizeof(BucketList));
+  /* which variables are live where: a load before any
+   * store in the block uses one, a store sets it
+   */
+  dfInit(&live, f, FALSE, FALSE, numVars);
+  for (b = f->first; b != NULL; b = b->next)
+    for (in = b->first; in != NULL; in = in->next) {
+      if ((v = varOfSlot(in)) == -1)
+        continue;
+      syms[v] = in->sym;
+      numLog++;
+      if (in->op == IR_STORE)
+        dfSet(DF_SET(&live, live.kill, b), v);
+      else if (!dfTest(DF_SET(&live, live.kill, b), v))
+        dfSet(DF_SET(&live, live.gen, b), v);
+    }
+  dfSolve(&live, f);
+  /* the PHIs, where the variable is live */
+  hasPhi = (int *)malloc(f->numBlocks * sizeof(int));
+  queued = (int *)malloc(f->numBlocks * sizeof(int));
+  work = (IrBlock **)malloc((f->numBlocks + 1) * sizeof(IrBlock *));
+  for (k = 0; k < f->numBlocks; k++)
+    hasPhi[k] = queued[k] = -1;
+  for (v = 0; v < numVars; v++) {
+    if (syms[v] == NULL)
+      continue;
+    numWork = 0;
+    for (b = f->first; b != NULL; b = b->next)
+      if (dfTest(DF_SET(&live, live.kill, b), v)) {
+        queued[b->id] = v;
+        work[numWork++] = b;
+      }
+    while (numWork > 0) {
+      IrBlock **y;
+      b = work[--numWork];
+      for (y = frontier[b->id]; *y != NULL; y++) {
+        if (hasPhi[(*y)->id] == v ||
+            !dfTest(DF_SET(&live, live.in, *y), v))
+          continue;
+        hasPhi[(*y)->id] = v;
+        phi = irNewPhi(f, *y, v);
+        phi->dst = irNewVreg(f);
+        phi->sym = syms[v];
+        phi->comment = "ssa: phi";
+        numLog++;
+        if (queued[(*y)->id] != v) {
+          queued[(*y)->id] = v;
+          work[numWork++] = *y;
+        }
+      }
+    }
+  }
+  /* rename, from the values on entry */
+  top = (int *)malloc((numVars + 1) * sizeof(int));
+  undefined = (int *)malloc((numVars + 1) * sizeof(int));
+  entryValue = (int *)malloc((numVars + 1) * sizeof(int));
+  for (v = 0; v < numVars; v++) {
+    undefined[v] = IR_NONE;
+    entryValue[v] = syms[v] != NULL &&
+                            dfTest(DF_SET(&live, live.in, f->first), v)
+                        ? irNewVreg(f)
+                        : IR_NONE;
+    top[v] = entryValue[v];
+  }
+  logVar = (int *)malloc(numLog * sizeof(int));
+  logOld = (int *)malloc(numLog * sizeof(int));
+  logTop = 0;
+  child = (IrBlock **)calloc(f->numBlocks, sizeof(IrBlock *));
+  sibling = (IrBlock **)calloc(f->numBlocks, sizeof(IrBlock *));
+  for (b = f->first; b != NULL; b = b->next)
+    if (b->idom != NULL) {
+      sibling[b->id] = child[b->idom->id];
+      child[b->idom->id] = b;
+    }
+  renameVars(f->first);
+  for (v = numVars - 1; v >= 0; v--)
+    if (entryValue[v] != IR_NONE) {
+      in = f->first->first != NULL ? irInsertBefore(f, f->first->first, IR_LOAD)
+                                   : irAppend(f, f->first, IR_LOAD);
+      in->dst = entryValue[v];
+      in->a = IR_FP;
+      in->imm = initFO - v;
+      in->sym = syms[v];
+      in->comment = "ssa: value on entry";
+    }
+  f->inSsa = TRUE;
+  free(sibling);
+  free(child);
+  free(logOld);
+  free(logVar);
+  free(entryValue);
+  free(undefined);
+  free(top);
+  free(work);
+  free(queued);
+  free(hasPhi);
+  free(syms);
+  dfFree(&live);
+}
+
+/* the registers of the PHIs, numbered from 0 for
+ * coalescing: joinIndex of each register, -1 if it is
+ * none; leader, a union-find of them; interfere, the
+ * ones each class interferes with
+ */
+static int *joinIndex, *joined, numJoined;
+static int *leader;
+static DfWord *interfere;
+static int rowWords;
+
+static int findLeader(int i) {
+  while (leader[i] != i)
+    i = leader[i] = leader[leader[i]];
+  return i;
+}
+
+static void join(int v) {
+  if (v >= IR_FIRST && joinIndex[v] == -1) {
+    joined[numJoined] = v;
+    joinIndex[v] = numJoined++;
+  }
+}
+
+/* Procedure conflict notes that the register indices
+ * x and y interfere
+ */
+static void conflict(int x, int y) {
+  if (x == y)
+    return;
+  dfSet(interfere + (size_t)x * rowWords, y);
+  dfSet(interfere + (size_t)y * rowWords, x);
+}
+
+/* Procedure phiArgsOut adds to live the registers the
+ * PHIs after p read coming from it
+ */
+static void phiArgsOut(IrBlock *p, DfWord *live) {
+  IrBlock *succ[2];
+  IrInstr *in;
+  int i, j, n = irSuccessors(p, succ);
+  for (i = 0; i < n; i++) {
+    for (j = 0; succ[i]->preds[j] != p; j++)
+      ;
+    for (in = succ[i]->first; in != NULL && in->op == IR_PHI; in = in->next)
+      if (joinIndex[in->args[j]] != -1)
+        dfSet(live, joinIndex[in->args[j]]);
+  }
+}
+
+/* Procedure coalesce gives a PHI and its arguments one
+ * register, where none of them interferes with
+ * another: is live where another is defined. The
+ * copies for the PHI are then no copies at all.
+ */
+static void coalesce(void) {
+  IrBlock *b;
+  IrInstr *in, *phi;
+  Dataflow lv;
+  DfWord *live, *row;
+  int v, i, k, n, x, y, ok;
+  joinIndex = (int *)malloc(f->numVregs * sizeof(int));
+  joined = (int *)malloc((f->numVregs + 1) * sizeof(int));
+  for (v = 0; v < f->numVregs; v++)
+    joinIndex[v] = -1;
+  numJoined = 0;
+  for (b = f->first; b != NULL; b = b->next)
+    for (in = b->first; in != NULL && in->op == IR_PHI; in = in->next) {
+      join(in->dst);
+      for (k = 0; k < in->numArgs; k++)
+        join(in->args[k]);
+    }
+  if (numJoined == 0) {
+    free(joined);
+    free(joinIndex);
+    return;
+  }
+  /* where they are live: a PHI reads at the end of
+   * the predecessor its argument comes from
+   */
+  dfInit(&lv, f, FALSE, FALSE, numJoined);
+  for (b = f->first; b != NULL; b = b->next) {
+    DfWord *gen = DF_SET(&lv, lv.gen, b), *kill = DF_SET(&lv, lv.kill, b);
+    for (in = b->first; in != NULL; in = in->next) {
+      if (in->op != IR_PHI)
+        for (k = 0, n = irNumUses(in); k < n; k++) {
+          v = *irUse(in, k);
+          if (v >= IR_FIRST && joinIndex[v] != -1 &&
+              !dfTest(kill, joinIndex[v]))
+            dfSet(gen, joinIndex[v]);
+        }
+      if (in->dst != IR_NONE && joinIndex[in->dst] != -1)
+        dfSet(kill, joinIndex[in->dst]);
+    }
+  }
+  live = (DfWord *)malloc(lv.numWords * sizeof(DfWord));
+  for (b = f->first; b != NULL; b = b->next) {
+    memset(live, 0, lv.numWords * sizeof(DfWord));
+    phiArgsOut(b, live);
+    for (i = 0; i < lv.numWords; i++)
+      DF_SET(&lv, lv.gen, b)[i] |= live[i] & ~DF_SET(&lv, lv.kill, b)[i];
+  }
+  dfSolve(&lv, f);
+  /* which interfere, walking each block backwards */
+  rowWords = lv.numWords;
+  interfere = (DfWord *)calloc((size_t)numJoined * rowWords, sizeof(DfWord));
+  for (b = f->first; b != NULL; b = b->next) {
+    memcpy(live, DF_SET(&lv, lv.out, b), lv.numWords * sizeof(DfWord));
+    phiArgsOut(b, live);
+    for (in = b->last; in != NULL && in->op != IR_PHI; in = in->prev) {
+      if (in->dst != IR_NONE && (x = joinIndex[in->dst]) != -1) {
+        for (y = 0; y < numJoined; y++)
+          if (dfTest(live, y))
+            conflict(x, y);
+        dfClear(live, x);
+      }
+      for (k = 0, n = irNumUses(in); k < n; k++) {
+        v = *irUse(in, k);
+        if (v >= IR_FIRST && joinIndex[v] != -1)
+          dfSet(live, joinIndex[v]);
+      }
+    }
+    /* the PHIs all define at once */
+    for (phi = b->first; phi != NULL && phi->op == IR_PHI; phi = phi->next)
+      for (y = 0; y < numJoined; y++)
+        if (dfTest(live, y))
+          conflict(joinIndex[phi->dst], y);
+  }
+  /* join the classes that do not interfere */
+  leader = (int *)malloc(numJoined * sizeof(int));
+  for (i = 0; i < numJoined; i++)
+    leader[i] = i;
+  for (b = f->first; b != NULL; b = b->next)
+    for (phi = b->first; phi != NULL && phi->op == IR_PHI; phi = phi->next)
+      for (k = 0; k < phi->numArgs; k++) {
+        x = findLeader(joinIndex[phi->dst]);
+        y = findLeader(joinIndex[phi->args[k]]);
+        if (x == y)
+          continue;
+        row = interfere + (size_t)x * rowWords;
+        ok = TRUE;
+        for (i = 0; i < numJoined && ok; i++)
+          if (dfTest(row, i) && findLeader(i) == y)
+            ok = FALSE;
+        if (!ok)
+          continue;
+        leader[y] = x;
+        for (i = 0; i < rowWords; i++)
+          row[i] |= interfere[(size_t)y * rowWords + i];
+      }
+  for (b = f->first; b != NULL; b = b->next)
+    for (in = b->first; in != NULL; in = in->next) {
+      if (in->dst != IR_NONE && joinIndex[in->dst] != -1)
+        in->dst = joined[findLeader(joinIndex[in->dst])];
+      for (k = 0, n = irNumUses(in); k < n; k++) {
+        int *u = irUse(in, k);
+        if (*u >= IR_FIRST && joinIndex[*u] != -1)
+          *u = joined[findLeader(joinIndex[*u])];
+      }
+    }
+  free(leader);
+  free(interfere);
+  free(live);
+  dfFree(&lv);
+  free(joined);
+  free(joinIndex);
+}
+
+/* copy emits dst = src before at */
+static void copy(IrInstr *at, int dst, int src) {
+  IrInstr *in = irInsertBefore(f, at, IR_MOV);
+  in->dst = dst;
+  in->a = src;
+  in->comment = "ssa: copy";
+}
+
+/* Procedure copyAll emits before at the copies dst[i]
+ * = src[i] as if at once: a copy goes only when no
+ * other still reads its destination, and a cycle is
+ * broken through a new register
+ */
+static void copyAll(IrInstr *at, int *dst, int *src, int n) {
+  int i, j, t, free;
+  for (i = 0; i < n;)
+    if (dst[i] == src[i]) {
+      dst[i] = dst[--n];
+      src[i] = src[n];
+    } else
+      i++;
+  while (n > 0) {
+    for (i = 0; i < n; i++) {
+      free = TRUE;
+      for (j = 0; j < n && free; j++)
+        if (j != i && src[j] == dst[i])
+          free = FALSE;
+      if (free)
+        break;
+    }
+    if (i < n) {
+      copy(at, dst[i], src[i]);
+      dst[i] = dst[--n];
+      src[i] = src[n];
+      continue;
+    }
+    t = irNewVreg(f);
+    copy(at, t, dst[0]);
+    for (j = 0; j < n; j++)
+      if (src[j] == dst[0])
+        src[j] = t;
+  }
+}
+
+void leaveSsa(IrFunc *func) {
+  IrBlock *b, *p, *edge;
+  IrInstr *in, *next, *t;
+  int *dst, *src, numPhis, j, n;
+  f = func;
+  if (!f->inSsa)
+    return;
+  coalesce();
+  for (b = f->first; b != NULL; b = b->next) {
+    numPhis = 0;
+    for (in = b->first; in != NULL && in->op == IR_PHI; in = in->next)
+      numPhis++;
+    if (numPhis == 0)
+      continue;
+    dst = (int *)malloc(numPhis * sizeof(int));
+    src = (int *)malloc(numPhis * sizeof(int));
+    for (j = 0; j < b->numPreds; j++) {
+      p = b->preds[j];
+      t = p->last;
+      if (t->op == IR_BR && t->target != t->other) {
+        edge = irNewBlock(f, NULL);
+        irPlaceBlockAfter(f, edge, p);
+        irAppend(f, edge, IR_JUMP)->target = b;
+        if (t->target == b)
+          t->target = edge;
+        else
+          t->other = edge;
+        t = edge->last;
+      }
+      n = 0;
+      for (in = b->first; in != NULL && in->op == IR_PHI; in = in->next) {
+        dst[n] = in->dst;
+        src[n++] = in->args[j];
+      }
+      copyAll(t, dst, src, n);
+    }
+    for (in = b->first; in != NULL && in->op == IR_PHI; in = next) {
+      next = in->next;
+      irRemove(in);
+    }
+    free(src);
+    free(dst);
+  }
+  f->inSsa = FALSE;
+  irComputePreds(f);
+}
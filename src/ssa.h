@@ -0,0 +1,32 @@
+/****************************************************/
+/* File: ssa.h                                      */
+/* SSA form of the intermediate code (ir.h)         */
+/****************************************************/
+
+#ifndef _SSA_H_
+#define _SSA_H_
+
+#include "ir.h"
+
+/* Procedure enterSsa puts f in SSA form. The local
+ * scalars and parameters, which f loads and stores at
+ * initFO - memloc from fp, become virtual registers:
+ * a load takes the value stored last on the way, and
+ * a PHI joins the values where paths meet, at the
+ * dominance frontiers of the stores where the variable
+ * is live. A variable live on entry is loaded from its
+ * slot there once. Arrays and globals stay in memory,
+ * and the frame keeps a slot for every variable.
+ */
+void enterSsa(IrFunc *f);
+
+/* Procedure leaveSsa replaces the PHIs of f by copies
+ * at the end of the predecessors, on a block of its
+ * own for an edge out of a branch into a block with
+ * more than one predecessor. The copies on an edge
+ * happen at once: each reads the values from before
+ * any of them.
+ */
+void leaveSsa(IrFunc *f);
+
+#endif
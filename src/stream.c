@@ -0,0 +1,110 @@
+/****************************************************/
+/* File: stream.c                                   */
+/* Function-at-a-time compilation of a C- program   */
+/****************************************************/
+
+#include "stream.h"
+#include "analyze.h"
+#include "ast.h"
+#include "cgen.h"
+#include "fold.h"
+#include "parse.h"
+#include "util.h"
+#include <limits.h>
+
+/* the nodes and layout of the declaration being
+ * compiled, and the private table of its locals
+ */
+static Arena declArena, localArena;
+
+/* memory location after the last variable placed */
+static int memloc = 0;
+
+/* type errors, listed at the end as analyze does */
+static LogCapture typeErrors;
+
+/* compileDecl takes the top-level declaration t
+ * through all the phases and frees it
+ */
+static void compileDecl(TreeNode *t) {
+  FileDestination stage = logStage(SYN);
+  Symtab table = NULL;
+  /* the global scope keeps the name */
+  t->attr.name = arenaStrdup(&compileArena, t->attr.name);
+  if (TraceParse)
+    printTree(t);
+
+  logStage(TAB);
+  astBuild(&compactAst, t);
+  if (t->kind.decl == FunDeclK) {
+    int start = memloc;
+    if (st_lookup_bucket(t->attr.name, GLOBAL_SCOPE) == NULL) {
+      st_insert(t->attr.name, t->lineno, "fun", typeName(t->typeReturn),
+                GLOBAL_SCOPE, 0);
+      start = 0;
+    }
+    /* the locals go to a table of their own */
+    table = st_private(INT_MAX, &localArena);
+    st_use(table);
+    memloc = analyzeDecl(t, start, &typeErrors, &scratchArena);
+  } else
+    memloc = analyzeDecl(t, memloc, &typeErrors, &scratchArena);
+
+  /* code generation finds the scopes of t in table */
+  if (!Error) {
+    foldConstants(t);
+    logStage(GEN);
+    codeGenDecl(t);
+  }
+  if (table != NULL) {
+    if (TraceAnalyze) {
+      logStage(TAB);
+      pc("\nSymbol table of %s:\n\n", t->attr.name);
+      printSymTab();
+    }
+    st_use(NULL);
+    st_discard(table);
+  }
+  arenaReset(&scratchArena);
+  arenaReset(&localArena);
+  arenaReset(&declArena);
+  logStage(stage);
+}
+
+void compileStream(void) {
+  int syntaxFailed;
+  arenaInit(&declArena, ARENA_BLOCK_SIZE);
+  arenaInit(&localArena, ARENA_BLOCK_SIZE);
+  st_insert("input", 0, "fun", "int", GLOBAL_SCOPE, 0);
+  st_insert("output", 0, "fun", "void", GLOBAL_SCOPE, 0);
+  logStage(GEN);
+  codeGenBegin();
+  logStage(LEX);
+
+  syntaxArena = &declArena;
+  syntaxFailed = parseEach(compileDecl);
+  syntaxArena = &compileArena;
+
+  doneLEXstartSYN();
+  doneSYNstartTAB();
+  /* as in the whole-program passes, a syntax error
+   * leaves out the rest of the analysis
+   */
+  if (TraceAnalyze && !syntaxFailed) {
+    pc("\nSymbol table:\n\n");
+    printSymTab();
+    fprintf(listing, "\nChecking Types...\n");
+    mainError();
+    logReplay(&typeErrors);
+    fprintf(listing, "\nType Checking Finished\n");
+  }
+  logCaptureFree(&typeErrors);
+  doneTABstartGEN();
+  /* as in the whole-program path, an error leaves the
+   * code file empty
+   */
+  if (!Error)
+    codeGenEnd();
+  arenaFree(&localArena);
+  arenaFree(&declArena);
+}
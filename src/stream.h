@@ -0,0 +1,26 @@
+/****************************************************/
+/* File: stream.h                                   */
+/* Function-at-a-time compilation of a C- program   */
+/****************************************************/
+
+#ifndef _STREAM_H_
+#define _STREAM_H_
+
+#include "globals.h"
+
+/* Procedure compileStream compiles the source one
+ * top-level declaration at a time: as soon as the
+ * parser reduces a declaration it is listed, analyzed
+ * and code generated, and then its subtree and local
+ * symbols are freed. Only the global records, the
+ * function entry points and the emitted code (held
+ * until the end, see code.h) stay.
+ *
+ * The listings come per declaration: each function's
+ * locals are printed after it, the global scope at the
+ * end. Code generation stops at the first error, and
+ * then nothing is written to the code file.
+ */
+void compileStream(void);
+
+#endif
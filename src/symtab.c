@@ -2,25 +2,41 @@
 /* File: symtab.c                                   */
 /* Symbol table implementation for the TINY compiler*/
 /* (allows only one symbol table)                   */
-/* Symbol table is implemented as a chained         */
-/* hash table                                       */
+/* Symbol table is implemented as growable          */
+/* open-addressing hash tables over a scope tree    */
 /* Compiler Construction: Principles and Practice   */
 /* Kenneth C. Louden                                */
 /****************************************************/
 
 #include "symtab.h"
+#include "arena.h"
 #include <stdlib.h>
 #include <string.h>
 
-/* SIZE is the size of the hash table */
-#define SIZE 211
+/* INITIAL_CAPACITY is the number of slots of a table
+ * before its first rehash; always a power of two
+ */
+#define INITIAL_CAPACITY 256
+
+/* a table is grown (doubled) before the insert that
+ * would make it more than LOAD_NUM/LOAD_DEN full
+ */
+#define LOAD_NUM 3
+#define LOAD_DEN 4
+
+/* probe lengths above MAX_PROBE_BIN share the last bin
+ * of the histogram printed by st_dump_stats
+ */
+#define MAX_PROBE_BIN 16
 
-/* SHIFT is the power of two used as multiplier
-   in hash function  */
+/* SIZE and SHIFT define the bucket of the former fixed
+ * 211-way chained table; printSymTab still lists the
+ * records in that order, so the listings do not change
+ */
+#define SIZE 211
 #define SHIFT 4
 
-/* the hash function */
-static int hash(char *key) {
+static int legacyBucket(char *key) {
   int temp = 0;
   int i = 0;
   while (key[i] != '\0') {
@@ -30,45 +46,380 @@ static int hash(char *key) {
   return temp;
 }
 
-/* the list of line numbers of the source
- * code in which a variable is referenced
+/* the hash function: FNV-1a over the name, mixed so
+ * that the low bits used as slot index are well spread
  */
-// typedef struct LineListRec {
-//   int lineno;
-//   struct LineListRec *next;
-// } *LineList;
-
-/* The record in the bucket lists for
- * each variable, including name,
- * assigned memory location, and
- * the list of line numbers in which
- * it appears in the source code
+static unsigned hash(char *name) {
+  unsigned h = 2166136261u;
+  char *p;
+  for (p = name; *p != '\0'; p++)
+    h = (h ^ (unsigned char)*p) * 16777619u;
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  return h;
+}
+
+/* pairHash hashes an (atom, scope) key */
+static unsigned pairHash(int atom, ScopeId scope) {
+  unsigned h = (unsigned)atom * 0x9e3779b1u ^ (unsigned)scope * 0x85ebca77u;
+  h ^= h >> 15;
+  h *= 0x2c1b3c6du;
+  h ^= h >> 12;
+  return h;
+}
+
+/* An atom is the number of an interned identifier;
+ * symbols and scopes are keyed by atoms, so that only
+ * interning compares strings
+ */
+typedef struct {
+  char *name;
+  BucketList newest; /* newest record of the name, in any scope */
+} AtomRec;
+
+typedef struct {
+  ScopeId parent;
+  int depth;
+  char *name; /* path from the global scope */
+  char *leaf; /* name within the parent */
+} ScopeRec;
+
+/* A slot caches the full hash of its key, so that
+ * rehashing never recomputes it and probing only
+ * compares names on a probable match
  */
-// typedef struct BucketListRec {
-//   char *name;
-//   char *type;
-//   char *dataType;
-//   char *scope;
-//   LineList lines;
-//   int memloc; /* memory location for variable */
-//   struct BucketListRec *next;
-// } *BucketList;
-
-/* the hash table */
-static BucketList hashTable[SIZE];
-
-void st_just_add_lines(char *name, int lineno, char *scope) {
-  int h = hash(name);
-  BucketList l = hashTable[h];
-  while ((l != NULL) &&
-         !((strcmp(name, l->name) == 0) && (strcmp(scope, l->scope) == 0)))
-    l = l->next;
-  LineList t = l->lines;
-  while (t->next != NULL)
-    t = t->next;
-  t->next = (LineList)malloc(sizeof(struct LineListRec));
-  t->next->lineno = lineno;
-  t->next->next = NULL;
+typedef struct {
+  unsigned hash;
+  int atom;
+  ScopeId scope;
+  int value; /* -1 if the slot is empty */
+} Slot;
+
+typedef struct {
+  Slot *slots;
+  unsigned capacity; /* 0 or a power of two */
+  unsigned count;    /* occupied slots */
+  const char *label; /* for st_dump_stats */
+} Table;
+
+/* a line number recorded in a record of the shared
+ * table by a private one, added to it by st_merge
+ */
+typedef struct {
+  BucketList rec;
+  int lineno;
+  int once; /* only if the record does not list it yet */
+} PendingLine;
+
+/* The state of one symbol table. names maps
+ * identifiers to atoms; symbols maps (atom, scope) to
+ * an index in records; children maps (atom, parent
+ * scope) to the scope of that name.
+ */
+struct SymtabRec {
+  Table names, symbols, children;
+  AtomRec *atoms;
+  int numAtoms, maxAtoms;
+  BucketList *records; /* in insertion order */
+  int numRecords, maxRecords;
+  ScopeRec *scopes;
+  int numScopes, maxScopes;
+  Arena *arena; /* where the table allocates */
+  /* a private table (st_private) sees the global scope
+   * of shared, as far as the record numbered visible
+   */
+  Symtab shared;
+  int visible;
+  PendingLine *pending;
+  int numPending, maxPending;
+};
+
+static ScopeRec globalScope = {NO_SCOPE, 0, "", ""};
+
+static struct SymtabRec mainTable = {
+    {NULL, 0, 0, "names"}, {NULL, 0, 0, "symbols"}, {NULL, 0, 0, "scopes"},
+    NULL, 0, 0, NULL, 0, 0, &globalScope, 1, 1, &compileArena, NULL, 0,
+    NULL, 0, 0};
+
+/* the table the calling thread works on */
+static _Thread_local Symtab tab = &mainTable;
+
+/* FIRST_LINES is the room for line numbers a record
+ * gets with its first line; most names are used only
+ * a few times
+ */
+#define FIRST_LINES 4
+
+/* Function grow returns array, or a copy of it twice
+ * as large (first elements if empty), so that it has
+ * room for element n
+ */
+static void *grow(void *array, int n, int *capacity, size_t size, int first) {
+  void *bigger;
+  if (n < *capacity)
+    return array;
+  *capacity = *capacity == 0 ? first : 2 * *capacity;
+  bigger = arenaAlloc(tab->arena, *capacity * size);
+  if (n > 0)
+    memcpy(bigger, array, n * size);
+  return bigger;
+}
+
+/* Procedure reserve makes room for one more key,
+ * rehashing into a table twice the size if needed;
+ * the old slot array is left to the arena
+ */
+static void reserve(Table *t) {
+  Slot *old = t->slots;
+  unsigned oldCapacity = t->capacity, i;
+  if ((t->count + 1) * LOAD_DEN <= t->capacity * LOAD_NUM)
+    return;
+  t->capacity = oldCapacity == 0 ? INITIAL_CAPACITY : 2 * oldCapacity;
+  t->slots = (Slot *)arenaAlloc(tab->arena, t->capacity * sizeof(Slot));
+  for (i = 0; i < t->capacity; i++)
+    t->slots[i].value = -1;
+  for (i = 0; i < oldCapacity; i++) {
+    if (old[i].value >= 0) {
+      unsigned j = old[i].hash & (t->capacity - 1);
+      while (t->slots[j].value >= 0)
+        j = (j + 1) & (t->capacity - 1);
+      t->slots[j] = old[i];
+    }
+  }
+}
+
+/* Functions findName and findPair return the slot of
+ * a key, or the empty slot where it would go; NULL if
+ * the table has no slots yet
+ */
+static Slot *findName(Table *t, unsigned h, char *name) {
+  unsigned mask = t->capacity - 1, i;
+  if (t->capacity == 0)
+    return NULL;
+  for (i = h & mask; t->slots[i].value >= 0; i = (i + 1) & mask) {
+    Slot *s = &t->slots[i];
+    if (s->hash == h && strcmp(name, tab->atoms[s->value].name) == 0)
+      return s;
+  }
+  return &t->slots[i];
+}
+
+static Slot *findPair(Table *t, int atom, ScopeId scope) {
+  unsigned mask = t->capacity - 1, i;
+  if (t->capacity == 0)
+    return NULL;
+  for (i = pairHash(atom, scope) & mask; t->slots[i].value >= 0;
+       i = (i + 1) & mask) {
+    Slot *s = &t->slots[i];
+    if (s->atom == atom && s->scope == scope)
+      return s;
+  }
+  return &t->slots[i];
+}
+
+/* Procedure fill stores a key and its value in the
+ * empty slot s of table t
+ */
+static void fill(Table *t, Slot *s, unsigned h, int atom, ScopeId scope,
+                 int value) {
+  s->hash = h;
+  s->atom = atom;
+  s->scope = scope;
+  s->value = value;
+  t->count++;
+}
+
+/* Function atomOf returns the atom of name; a new one
+ * if create is set, otherwise -1 for an unknown name
+ */
+static int atomOf(char *name, int create) {
+  unsigned h = hash(name);
+  Slot *s;
+  if (create)
+    reserve(&tab->names);
+  s = findName(&tab->names, h, name);
+  if (s != NULL && s->value >= 0)
+    return s->value;
+  if (!create)
+    return -1;
+  tab->atoms = (AtomRec *)grow(tab->atoms, tab->numAtoms, &tab->maxAtoms,
+                               sizeof(AtomRec), 64);
+  tab->atoms[tab->numAtoms].name = name;
+  tab->atoms[tab->numAtoms].newest = NULL;
+  fill(&tab->names, s, h, tab->numAtoms, NO_SCOPE, tab->numAtoms);
+  return tab->numAtoms++;
+}
+
+/* Function findRecord returns the record of atom in
+ * scope, or NULL if there is none
+ */
+static BucketList findRecord(int atom, ScopeId scope) {
+  Slot *s = findPair(&tab->symbols, atom, scope);
+  if (s == NULL || s->value < 0)
+    return NULL;
+  return tab->records[s->value];
+}
+
+/* Function lookup returns the record of name in scope,
+ * or NULL if there is none
+ */
+static BucketList lookup(char *name, ScopeId scope);
+
+/* Function sharedLookup returns the record of name in
+ * the global scope of the table a private one shares,
+ * or NULL if there is none or it is not visible yet
+ */
+static BucketList sharedLookup(char *name) {
+  Symtab own = tab;
+  BucketList l;
+  tab = own->shared;
+  l = lookup(name, GLOBAL_SCOPE);
+  tab = own;
+  return l != NULL && l->seq <= own->visible ? l : NULL;
+}
+
+static BucketList lookup(char *name, ScopeId scope) {
+  int atom;
+  if (scope == GLOBAL_SCOPE && tab->shared != NULL)
+    return sharedLookup(name);
+  atom = atomOf(name, 0);
+  return atom < 0 ? NULL : findRecord(atom, scope);
+}
+
+/* Function lookupName returns the newest record of
+ * name in any scope, or NULL if there is none
+ */
+static BucketList lookupName(char *name) {
+  int atom = atomOf(name, 0);
+  return atom < 0 ? NULL : tab->atoms[atom].newest;
+}
+
+ScopeId st_scope(ScopeId parent, char *name) {
+  int atom = atomOf(name, 1);
+  Slot *s;
+  reserve(&tab->children);
+  s = findPair(&tab->children, atom, parent);
+  if (s->value < 0) {
+    ScopeRec *r;
+    tab->scopes = (ScopeRec *)grow(tab->scopes, tab->numScopes,
+                                   &tab->maxScopes, sizeof(ScopeRec), 64);
+    r = &tab->scopes[tab->numScopes];
+    r->parent = parent;
+    r->leaf = name;
+    r->depth = tab->scopes[parent].depth + 1;
+    if (parent == GLOBAL_SCOPE)
+      r->name = name;
+    else {
+      size_t len = strlen(tab->scopes[parent].name);
+      r->name = (char *)arenaAlloc(tab->arena, len + strlen(name) + 2);
+      memcpy(r->name, tab->scopes[parent].name, len);
+      r->name[len] = '-';
+      strcpy(r->name + len + 1, name);
+    }
+    fill(&tab->children, s, pairHash(atom, parent), atom, parent,
+         tab->numScopes++);
+  }
+  return s->value;
+}
+
+ScopeId st_scope_parent(ScopeId scope) {
+  return scope == NO_SCOPE ? NO_SCOPE : tab->scopes[scope].parent;
+}
+
+int st_scope_depth(ScopeId scope) {
+  return scope == NO_SCOPE ? -1 : tab->scopes[scope].depth;
+}
+
+char *st_scope_name(ScopeId scope) {
+  return scope == NO_SCOPE ? NULL : tab->scopes[scope].name;
+}
+
+BucketList st_resolve(char *name, ScopeId scope) {
+  int atom = atomOf(name, 0);
+  BucketList l;
+  for (; scope != NO_SCOPE; scope = tab->scopes[scope].parent) {
+    if (scope == GLOBAL_SCOPE && tab->shared != NULL)
+      return sharedLookup(name);
+    if (atom >= 0 && (l = findRecord(atom, scope)) != NULL)
+      return l;
+  }
+  return NULL;
+}
+
+/* Procedure addLine appends a line number to l */
+static void addLine(BucketList l, int lineno) {
+  l->lines = (int *)grow(l->lines, l->numLines, &l->maxLines, sizeof(int),
+                         FIRST_LINES);
+  l->lines[l->numLines++] = lineno;
+  if (l->numLines == 1 || lineno > l->maxLine)
+    l->maxLine = lineno;
+}
+
+/* Function hasLine tells whether lineno is already
+ * listed in l; constant time unless lineno is below
+ * the last line recorded
+ */
+static int hasLine(BucketList l, int lineno) {
+  int i;
+  if (l->numLines == 0 || lineno > l->maxLine)
+    return 0;
+  if (l->lines[l->numLines - 1] == lineno)
+    return 1;
+  /* lines are recorded in source order save for a
+   * statement spanning lines, so this is rare
+   */
+  for (i = l->numLines - 2; i >= 0; i--)
+    if (l->lines[i] == lineno)
+      return 1;
+  return 0;
+}
+
+/* Procedure addPending queues a line for the record l
+ * of the shared table, which a private one must not
+ * change
+ */
+static void addPending(BucketList l, int lineno, int once) {
+  PendingLine *p;
+  tab->pending = (PendingLine *)grow(tab->pending, tab->numPending,
+                                     &tab->maxPending, sizeof(PendingLine),
+                                     64);
+  p = &tab->pending[tab->numPending++];
+  p->rec = l;
+  p->lineno = lineno;
+  p->once = once;
+}
+
+/* only the global records a private table sees are
+ * not its own
+ */
+#define IS_SHARED(l) (tab->shared != NULL && (l)->scopeId == GLOBAL_SCOPE)
+
+void st_add_line(BucketList l, int lineno) {
+  if (IS_SHARED(l))
+    addPending(l, lineno, 0);
+  else
+    addLine(l, lineno);
+}
+
+void st_add_line_once(BucketList l, int lineno) {
+  if (IS_SHARED(l))
+    addPending(l, lineno, 1);
+  else if (!hasLine(l, lineno))
+    addLine(l, lineno);
+}
+
+/* Procedure addRecord lists the new record l of atom
+ * in scope
+ */
+static void addRecord(BucketList l, int atom, ScopeId scope) {
+  tab->atoms[atom].newest = l;
+  tab->records = (BucketList *)grow(tab->records, tab->numRecords,
+                                    &tab->maxRecords, sizeof(BucketList), 64);
+  tab->records[tab->numRecords] = l;
+  reserve(&tab->symbols);
+  fill(&tab->symbols, findPair(&tab->symbols, atom, scope),
+       pairHash(atom, scope), atom, scope, tab->numRecords++);
 }
 
 /* Procedure st_insert inserts line numbers and
@@ -76,192 +427,225 @@ void st_just_add_lines(char *name, int lineno, char *scope) {
  * loc = memory location is inserted only the
  * first time, otherwise ignored
  */
-void st_insert(char *name, int lineno, char *type, char *dataType, char *scope,
-               int depth, int memLoc) {
-  int h = hash(name);
-  BucketList l = hashTable[h];
-  while ((l != NULL) &&
-         !((strcmp(name, l->name) == 0) && (strcmp(scope, l->scope) == 0)))
-    l = l->next;
+BucketList st_insert(char *name, int lineno, char *type, char *dataType,
+                     ScopeId scope, int memLoc) {
+  int atom = atomOf(name, 1);
+  BucketList l = findRecord(atom, scope);
   if (l == NULL) /* variable not yet in table */
   {
-    l = (BucketList)malloc(sizeof(struct BucketListRec));
+    l = (BucketList)arenaCalloc(tab->arena, sizeof(struct BucketListRec));
     l->name = name;
-    l->lines = (LineList)malloc(sizeof(struct LineListRec));
-    l->lines->lineno = lineno;
     l->type = type;
     l->dataType = dataType;
-    l->scope = scope;
-    l->depth = depth;
+    l->expType = strcmp(dataType, "void") == 0 ? Void : Integer;
+    l->isVar = strcmp(type, "var") == 0 || strcmp(type, "param-var") == 0;
+    l->scope = st_scope_name(scope);
+    l->scopeId = scope;
+    l->depth = st_scope_depth(scope);
     l->memloc = memLoc;
-    l->lines->next = NULL;
-    l->next = hashTable[h];
-    hashTable[h] = l;
+    addLine(l, lineno);
+    l->seq = tab->numRecords;
+    addRecord(l, atom, scope);
   } else /* found in table, so just add line number */
-  {
-    LineList t = l->lines;
-    while (t->next != NULL)
-      t = t->next;
-    t->next = (LineList)malloc(sizeof(struct LineListRec));
-    t->next->lineno = lineno;
-    t->next->next = NULL;
-  }
+    st_add_line(l, lineno);
+  return l;
 } /* st_insert */
 
 /* Function st_lookup returns the memory
  * location of a variable or -1 if not found
  */
-int st_lookup(char *name, char *scope) {
-  int h = hash(name);
-  BucketList l = hashTable[h];
-  while ((l != NULL) &&
-         !((strcmp(name, l->name) == 0) && (strcmp(scope, l->scope) == 0)))
-    l = l->next;
+int st_lookup(char *name, ScopeId scope) {
+  BucketList l = lookup(name, scope);
   if (l == NULL)
     return -1;
   else
     return l->memloc;
 }
 
+/* LINE_WIDTH bounds the characters printSymTab writes
+ * for one line number
+ */
+#define LINE_WIDTH 12
+
+/* records of the table with their print position */
+typedef struct {
+  int bucket;
+  BucketList rec;
+} PrintRec;
+
+/* listing order of the former chained table: by bucket,
+ * newest record first within a bucket
+ */
+static int printOrder(const void *a, const void *b) {
+  const PrintRec *x = a, *y = b;
+  if (x->bucket != y->bucket)
+    return x->bucket - y->bucket;
+  return y->rec->seq - x->rec->seq;
+}
+
 /* Procedure printSymTab prints a formatted
  * list of the symbol table contents
  */
 void printSymTab() {
-  int i;
+  PrintRec *recs;
+  char *row = NULL;
+  size_t rowSize = 0;
+  int k;
   pc("Variable Name  Scope     ID Type  Data Type  Line Numbers\n");
   pc("-------------  --------  -------  ---------  "
      "-------------------------\n");
   // pc("Variable Name  Scope     ID Type  Data Type  Memloc  SizeOfVars  Line Numbers\n");
   // pc("-------------  --------  -------  ---------  ------  ----------  -------------------------\n");
 
-  for (i = 0; i < SIZE; ++i) {
-    if (hashTable[i] != NULL) {
-      BucketList l = hashTable[i];
-      while (l != NULL) {
-        LineList t = l->lines;
-        pc("%-14s ", l->name);
-        pc("%-8s  ", l->scope);
-        pc("%-7s  ", l->type);
-        pc("%-9s  ", l->dataType);
-        // pc("%-6d  ", l->memloc);
-        // pc("%-10d  ", l->sizeOfVars);
-
-        while (t != NULL) {
-          if (t->lineno != 0) {
-            pc("%2d ", t->lineno);
-          }
-          t = t->next;
-        }
-        pc("\n");
-        l = l->next;
-      }
+  recs = (PrintRec *)arenaAlloc(&scratchArena,
+                                (tab->numRecords + 1) * sizeof(PrintRec));
+  for (k = 0; k < tab->numRecords; k++) {
+    recs[k].rec = tab->records[k];
+    recs[k].bucket = legacyBucket(tab->records[k]->name);
+  }
+  qsort(recs, tab->numRecords, sizeof(PrintRec), printOrder);
+
+  /* each row is formatted into row and written at once */
+  for (k = 0; k < tab->numRecords; k++) {
+    BucketList l = recs[k].rec;
+    size_t need = strlen(l->name) + (l->scope ? strlen(l->scope) : 6) +
+                  strlen(l->type) + strlen(l->dataType) + 64 +
+                  (size_t)l->numLines * LINE_WIDTH;
+    size_t used;
+    int i;
+    if (need > rowSize) {
+      rowSize = 2 * need;
+      row = (char *)arenaAlloc(&scratchArena, rowSize);
     }
+    used = sprintf(row, "%-14s %-8s  %-7s  %-9s  ", l->name, l->scope, l->type,
+                   l->dataType);
+    // used += sprintf(row + used, "%-6d  %-10d  ", l->memloc, l->sizeOfVars);
+    for (i = 0; i < l->numLines; i++)
+      if (l->lines[i] != 0)
+        used += sprintf(row + used, "%2d ", l->lines[i]);
+    strcpy(row + used, "\n");
+    pcs(row);
   }
 } /* printSymTab */
 
-char *getDataType(char *name) {
-  int h = hash(name);
-  BucketList l = hashTable[h];
-  while ((l != NULL) && (strcmp(name, l->name) != 0))
-    l = l->next;
-  if (l == NULL)
-    return NULL;
-  else
-    return l->dataType;
+/* Procedure dumpTable prints the size of table t and
+ * a histogram of the probes needed to find each key
+ */
+static void dumpTable(FILE *out, Table *t) {
+  long bins[MAX_PROBE_BIN + 1] = {0};
+  long total = 0;
+  unsigned i, longest = 0;
+  for (i = 0; i < t->capacity; i++) {
+    if (t->slots[i].value >= 0) {
+      unsigned probes = ((i - t->slots[i].hash) & (t->capacity - 1)) + 1;
+      bins[probes > MAX_PROBE_BIN ? MAX_PROBE_BIN : probes]++;
+      total += probes;
+      if (probes > longest)
+        longest = probes;
+    }
+  }
+  fprintf(out, "symtab %s: %u keys, %u slots (load %.2f), "
+          "mean probes %.2f, longest %u\n",
+          t->label, t->count, t->capacity,
+          t->capacity ? (double)t->count / t->capacity : 0.0,
+          t->count ? (double)total / t->count : 0.0, longest);
+  for (i = 1; i <= MAX_PROBE_BIN; i++)
+    if (bins[i] != 0)
+      fprintf(out, "  %2u%s probes: %ld\n", i,
+              i == MAX_PROBE_BIN ? "+" : " ", bins[i]);
 }
 
-char *getIdType(char *name) {
-  int h = hash(name);
-  BucketList l = hashTable[h];
-  while ((l != NULL) && (strcmp(name, l->name) != 0))
-    l = l->next;
-  if (l == NULL)
-    return NULL;
-  else
-    return l->type;
+void st_dump_stats(FILE *out) {
+  dumpTable(out, &tab->names);
+  dumpTable(out, &tab->symbols);
+  dumpTable(out, &tab->children);
 }
 
-char *getIdTypeScope(char *name, char *scope ) {
-  int h = hash(name);
-  BucketList l = hashTable[h];
-  while ((l != NULL) &&
-         !((strcmp(name, l->name) == 0) && (strcmp(scope, l->scope) == 0)))
-    l = l->next;
-  if (l == NULL)
-    return NULL;
-  else
-    return l->type;
+void st_reset(void) {
+  Table *tables[] = {&tab->names, &tab->symbols, &tab->children};
+  int i;
+  for (i = 0; i < 3; i++) {
+    tables[i]->slots = NULL;
+    tables[i]->capacity = tables[i]->count = 0;
+  }
+  tab->atoms = NULL;
+  tab->numAtoms = tab->maxAtoms = 0;
+  tab->records = NULL;
+  tab->numRecords = tab->maxRecords = 0;
+  tab->scopes = &globalScope;
+  tab->numScopes = tab->maxScopes = 1;
+  tab->pending = NULL;
+  tab->numPending = tab->maxPending = 0;
 }
 
 int isThereFunction(char *name) {
-  int h = hash(name);
-  BucketList l = hashTable[h];
-  while ((l != NULL) && (strcmp(name, l->name) != 0))
-    l = l->next;
+  BucketList l = lookupName(name);
+  if (l == NULL && tab->shared != NULL)
+    l = sharedLookup(name);
   if (l == NULL || strcmp(l->type, "fun") != 0)
     return 0;
   else
     return 1;
 }
 
-int isThereVariableAtSameLine(char *name, int lineno, char *scope) {
-  int h = hash(name);
-  BucketList l = hashTable[h];
-  while ((l != NULL) &&
-         !((strcmp(name, l->name) == 0) && (strcmp(scope, l->scope) == 0)))
-    l = l->next;
-  if (l == NULL)
-    return 0;
-  else {
-    LineList t = l->lines;
-    while (t != NULL) {
-      if (t->lineno == lineno)
-        return 1;
-      t = t->next;
-    }
-    return 0;
-  }
+BucketList st_lookup_bucket(char *name, ScopeId scope) {
+  return lookup(name, scope);
 }
 
-/* Add this to symtab.c */
-BucketList st_lookup_bucket(char *name, char *scope) {
-  int h = hash(name);
-  BucketList l = hashTable[h];
-  while ((l != NULL) &&
-         !((strcmp(name, l->name) == 0) && (strcmp(scope, l->scope) == 0)))
-    l = l->next;
-  return l;
+Symtab st_private(int visible, Arena *arena) {
+  Symtab t = (Symtab)arenaCalloc(arena, sizeof(struct SymtabRec));
+  t->names.label = "names";
+  t->symbols.label = "symbols";
+  t->children.label = "scopes";
+  t->scopes = (ScopeRec *)arenaAlloc(arena, sizeof(ScopeRec));
+  t->scopes[GLOBAL_SCOPE] = globalScope;
+  t->numScopes = t->maxScopes = 1;
+  t->arena = arena;
+  t->shared = tab;
+  t->visible = visible;
+  return t;
 }
 
-int isGlobalVariable(char *name, int depth) {
-  int h = hash(name);
-  BucketList l = hashTable[h];
-  while ((l != NULL) && !((strcmp(name, l->name) == 0) && (l->depth == depth)))
-    l = l->next;
-  if (l == NULL)
-    return 0;
-  else
-    return 1;
+void st_use(Symtab t) { tab = t != NULL ? t : &mainTable; }
+
+/* Procedure addPendingLines adds the lines the
+ * private table t held back to the current table
+ */
+static void addPendingLines(Symtab t) {
+  int i;
+  for (i = 0; i < t->numPending; i++) {
+    PendingLine *p = &t->pending[i];
+    if (!p->once || !hasLine(p->rec, p->lineno))
+      addLine(p->rec, p->lineno);
+  }
 }
 
-void addSizeOfVars(char *name, int sizeOfVars) {
-  int h = hash(name);
-  BucketList l = hashTable[h];
-  while ((l != NULL) && (strcmp(name, l->name) != 0))
-    l = l->next;
-  if (l == NULL)
-    return;
-  else
-    l->sizeOfVars += sizeOfVars;
+int st_merge(Symtab t, int seq) {
+  ScopeId *map =
+      (ScopeId *)arenaAlloc(&scratchArena, t->numScopes * sizeof(ScopeId));
+  int i, k;
+  /* a scope is created after its parent */
+  map[GLOBAL_SCOPE] = GLOBAL_SCOPE;
+  for (i = 1; i < t->numScopes; i++)
+    map[i] = st_scope(map[t->scopes[i].parent], t->scopes[i].leaf);
+  for (i = 0; i < t->numRecords; i++) {
+    BucketList l = t->records[i], m;
+    ScopeId scope = l->scopeId == NO_SCOPE ? NO_SCOPE : map[l->scopeId];
+    int atom = atomOf(l->name, 1);
+    if ((m = findRecord(atom, scope)) != NULL) {
+      /* undeclared in an earlier function as well */
+      for (k = 0; k < l->numLines; k++)
+        if (!hasLine(m, l->lines[k]))
+          addLine(m, l->lines[k]);
+      continue;
+    }
+    l->scopeId = scope;
+    l->scope = st_scope_name(scope);
+    l->seq = seq++;
+    addRecord(l, atom, scope);
+  }
+  addPendingLines(t);
+  return seq;
 }
 
-int getSizeOfVars(char *name) {
-  int h = hash(name);
-  BucketList l = hashTable[h];
-  while ((l != NULL) && (strcmp(name, l->name) != 0))
-    l = l->next;
-  if (l == NULL)
-    return 0;
-  else
-    return l->sizeOfVars;
-}
\ No newline at end of file
+void st_discard(Symtab t) { addPendingLines(t); }
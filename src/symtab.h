@@ -10,60 +10,143 @@
 #define _SYMTAB_H_
 
 #include "../lib/log.h"
+#include "arena.h"
+#include <stdio.h>
+
+/* Scopes form a tree whose root is the global scope:
+ * each function is a child of it, and a block nested
+ * in a function body is a child of the enclosing scope,
+ * named after the if, while or block that opens it.
+ * Blocks of the same kind in the same parent share one
+ * scope. Scopes are numbered from GLOBAL_SCOPE up.
+ */
+typedef int ScopeId;
+
+#define GLOBAL_SCOPE 0
+#define NO_SCOPE (-1) /* parent of the global scope; unresolved names */
 
-typedef struct LineListRec {
-  int lineno;
-  struct LineListRec *next;
-} *LineList;
+/* ExpType is used for type checking */
+typedef enum { Void, Integer, Boolean } ExpType;
 
 typedef struct BucketListRec {
   char *name;
   char *type;
   char *dataType;
-  char *scope;
-  LineList lines;
+  ExpType expType; /* dataType, set once by st_insert */
+  int isVar; /* type is "var" or "param-var": a scalar */
+  char *scope; /* st_scope_name(scopeId) */
+  ScopeId scopeId;
+  int *lines; /* line numbers, in the order recorded */
+  int numLines, maxLines;
+  int maxLine; /* largest of lines */
   int depth;
   int memloc; /* memory location for variable */
   int size; /* size of the variable if it is an array */
   int sizeOfVars; /* size of the variables if it is a function */
-  struct BucketListRec *next;
+  int seq; /* insertion order */
+  struct CallNodeRec *call; /* call graph node of a function (callgraph.h) */
 } *BucketList;
 
-/* Procedure st_insert inserts line numbers and
- * memory locations into the symbol table
+/* Function st_insert inserts line numbers and
+ * memory locations into the symbol table and
+ * returns the record of name in scope
  * loc = memory location is inserted only the
  * first time, otherwise ignored
  */
-void st_insert( char * name, int lineno, char * type, char * dataType, char * scope , int depth, int memLoc);
+BucketList st_insert( char * name, int lineno, char * type, char * dataType, ScopeId scope, int memLoc);
 
 /* Function st_lookup returns the memory 
  * location of a variable or -1 if not found
  */
-int st_lookup ( char * name, char * scope );
+int st_lookup ( char * name, ScopeId scope );
 
 /* Procedure printSymTab prints a formatted 
  * list of the symbol table contents 
  */
 void printSymTab();
 
-/* Procedure st_just_add_lines adds a line number to the symbol table */
-void st_just_add_lines(char *name, int lineno, char *scope);
+/* Procedure st_add_line appends a line number to
+ * the record l in constant (amortized) time
+ */
+void st_add_line(BucketList l, int lineno);
 
-char *getDataType(char *name);
+/* Procedure st_add_line_once appends a line number
+ * to the record l unless it is listed there already
+ */
+void st_add_line_once(BucketList l, int lineno);
 
 int isThereFunction(char *name);
 
-int isThereVariableAtSameLine(char *name, int lineno, char *scope);
-
 /* Add this to symtab.h */
-BucketList st_lookup_bucket(char * name, char * scope);
+BucketList st_lookup_bucket(char * name, ScopeId scope);
 
-void addSizeOfVars(char *name, int sizeOfVars);
+/* Function st_scope returns the child of parent called
+ * name, creating it the first time it is asked for
+ */
+ScopeId st_scope(ScopeId parent, char *name);
 
-int getSizeOfVars(char *name);
+/* Function st_scope_parent returns the enclosing scope,
+ * NO_SCOPE for the global one
+ */
+ScopeId st_scope_parent(ScopeId scope);
 
-char *getIdType(char *name);
+/* Function st_scope_depth returns 0 for the global
+ * scope, 1 for a function, and so on
+ */
+int st_scope_depth(ScopeId scope);
+
+/* Function st_scope_name returns the listing name of a
+ * scope: its path from the global scope, as in
+ * "main-while-if" ("" for the global scope)
+ */
+char *st_scope_name(ScopeId scope);
 
-char *getIdTypeScope(char *name, char *scope);
+/* Function st_resolve returns the record of name in
+ * the innermost scope, from scope outwards, that
+ * declares it, or NULL
+ */
+BucketList st_resolve(char *name, ScopeId scope);
+
+/* Procedure st_dump_stats prints the size, load and
+ * probe-length histogram of the hash tables to out
+ */
+void st_dump_stats(FILE *out);
+
+/* Procedure st_reset empties the symbol table; its
+ * storage belongs to compileArena and is not freed
+ */
+void st_reset(void);
+
+/* A private table holds the records of one function
+ * analyzed on a worker thread (panalyze.c). Its global
+ * scope is that of the table it was made from, read
+ * only: records numbered (seq) up to visible are seen,
+ * and lines added to them wait for st_merge.
+ */
+typedef struct SymtabRec *Symtab;
+
+/* Function st_private returns an empty private table
+ * over the current one, allocated in arena
+ */
+Symtab st_private(int visible, Arena *arena);
+
+/* Procedure st_use makes the calling thread work on
+ * table t; NULL is the table of the program
+ */
+void st_use(Symtab t);
+
+/* Function st_merge moves the records and scopes of
+ * the private table t into the current one, numbering
+ * the new records from seq, and adds the lines t held
+ * back; returns the next number. Private tables are
+ * merged in source order.
+ */
+int st_merge(Symtab t, int seq);
+
+/* Procedure st_discard adds the lines the private
+ * table t held back to the current table and drops
+ * its records; the storage is left to its arena
+ */
+void st_discard(Symtab t);
 
 #endif
@@ -0,0 +1,208 @@
+/****************************************************/
+/* File: tmgen.c                                    */
+/* TM code for the intermediate code, once its      */
+/* registers are allocated (regalloc.h)             */
+/****************************************************/
+
+#include "tmgen.h"
+#include "cgen.h"
+#include "code.h"
+#include <stdlib.h>
+
+static IrFunc *f;
+
+/* location of each block, -1 until it is emitted */
+static int *blockLoc;
+
+/* a jump emitted before the location it goes to was
+ * known: to block, or to the end of main if NULL
+ */
+typedef struct {
+  int loc;
+  TmOp op;
+  int r;
+  IrBlock *block;
+  char *comment;
+} Patch;
+
+static Patch *patches;
+static int numPatches, maxPatches;
+
+static int reg(int v) { return f->reg[v]; }
+
+static TmOp jumpOp(IrCond cond) {
+  static const TmOp ops[] = {opJLT, opJLE, opJGT, opJGE, opJEQ, opJNE};
+  return ops[cond];
+}
+
+static IrCond negate(IrCond cond) {
+  static const IrCond negs[] = {IR_GE, IR_GT, IR_LE, IR_LT, IR_NE, IR_EQ};
+  return negs[cond];
+}
+
+/* emitJump emits op on r to block b, leaving room for
+ * it when b is not emitted yet
+ */
+static void emitJump(TmOp op, int r, IrBlock *b, const char *comment) {
+  if (b != NULL && blockLoc[b->id] != -1) {
+    emitRM_Abs(op, r, blockLoc[b->id], (char *)comment);
+    return;
+  }
+  if (numPatches == maxPatches) {
+    maxPatches = maxPatches == 0 ? 64 : 2 * maxPatches;
+    patches = (Patch *)realloc(patches, maxPatches * sizeof(Patch));
+  }
+  patches[numPatches].loc = emitSkip(1);
+  patches[numPatches].op = op;
+  patches[numPatches].r = r;
+  patches[numPatches].block = b;
+  patches[numPatches].comment = (char *)comment;
+  numPatches++;
+}
+
+static void emitMove(int to, int from, char *comment) {
+  if (to != from)
+    emitRM(opLDA, to, 0, from, comment);
+}
+
+static void genCall(IrInstr *in) {
+  FunctionInfosRec *callee = findFunction(in->sym->name);
+  emitRM(opST, fp, 0, sp, "call: store fp");
+  emitRM(opLDA, fp, 0, sp, "call: fp points to the new frame");
+  emitLDC_Abs(ac, emitSkip(0) + 3, "call: return address");
+  emitRM(opST, ac, retFO, fp, "call: store return address");
+  emitRM_Abs(opLDA, PC, callee != NULL ? callee->startAddr : 0,
+             (char *)in->comment);
+  if (in->dst != IR_NONE)
+    emitMove(reg(in->dst), ac, "call: returned value");
+}
+
+static void genRet(IrInstr *in, int atEnd) {
+  if (f->isMain) {
+    if (!atEnd)
+      emitJump(opLDA, PC, NULL, "return: jump to the end of main");
+    return;
+  }
+  if (in->a != IR_NONE)
+    emitMove(ac, reg(in->a), (char *)in->comment);
+  emitRM(opLDA, sp, 0, fp, "Epilogue: sp back to the caller's");
+  emitRM(opLD, ac1, retFO, fp, "Epilogue: load return address");
+  emitRM(opLD, fp, ofpFO, fp, "Epilogue: restore fp");
+  emitRM(opLDA, PC, 0, ac1, "Epilogue: return");
+}
+
+static void genBranch(IrInstr *in, IrBlock *next) {
+  int r = reg(in->a);
+  if (in->other == next)
+    emitJump(jumpOp(in->cond), r, in->target, in->comment);
+  else if (in->target == next)
+    emitJump(jumpOp(negate(in->cond)), r, in->other, in->comment);
+  else {
+    emitJump(jumpOp(in->cond), r, in->target, in->comment);
+    emitJump(opLDA, PC, in->other, in->comment);
+  }
+}
+
+static void genInstr(IrInstr *in, IrBlock *next) {
+  char *c = (char *)in->comment;
+  int d = in->dst != IR_NONE ? reg(in->dst) : ac;
+  switch (in->op) {
+  case IR_CONST:
+    emitRM(opLDC, d, in->imm, 0, c);
+    break;
+  case IR_MOV:
+    emitMove(d, reg(in->a), c);
+    break;
+  case IR_ADD:
+    emitRO(opADD, d, reg(in->a), reg(in->b), c);
+    break;
+  case IR_SUB:
+    emitRO(opSUB, d, reg(in->a), reg(in->b), c);
+    break;
+  case IR_MUL:
+    emitRO(opMUL, d, reg(in->a), reg(in->b), c);
+    break;
+  case IR_DIV:
+    emitRO(opDIV, d, reg(in->a), reg(in->b), c);
+    break;
+  case IR_ADDI:
+    emitRM(opLDA, d, in->imm, reg(in->a), c);
+    break;
+  case IR_SET:
+    if (d != reg(in->a)) {
+      emitRM(opLDC, d, 1, 0, c);
+      emitRM(jumpOp(in->cond), reg(in->a), 1, PC, "br if true");
+      emitRM(opLDC, d, 0, 0, "false case");
+    } else {
+      emitRM(jumpOp(in->cond), reg(in->a), 2, PC, c);
+      emitRM(opLDC, d, 0, 0, "false case");
+      emitRM(opLDA, PC, 1, PC, "unconditional jmp");
+      emitRM(opLDC, d, 1, 0, "true case");
+    }
+    break;
+  case IR_LOAD:
+    emitRM(opLD, d, in->imm, reg(in->a), c);
+    break;
+  case IR_STORE:
+    emitRM(opST, reg(in->b), in->imm, reg(in->a), c);
+    break;
+  case IR_IN:
+    emitRO(opIN, d, 0, 0, c);
+    break;
+  case IR_OUT:
+    emitRO(opOUT, reg(in->a), 0, 0, c);
+    break;
+  case IR_ARG: /* below the frame the call sets up */
+    emitRM(opST, reg(in->a), initFO - in->imm, sp, c);
+    break;
+  case IR_CALL:
+    genCall(in);
+    break;
+  case IR_RET:
+    genRet(in, next == NULL);
+    break;
+  case IR_JUMP:
+    if (in->target != next)
+      emitJump(opLDA, PC, in->target, c);
+    break;
+  case IR_BR:
+    genBranch(in, next);
+    break;
+  case IR_PHI: /* gone with leaveSsa (ssa.h) */
+    break;
+  }
+}
+
+void tmGen(IrFunc *func) {
+  IrBlock *b;
+  IrInstr *in;
+  int i, endLoc;
+  f = func;
+  blockLoc = (int *)malloc(f->numBlocks * sizeof(int));
+  for (i = 0; i < f->numBlocks; i++)
+    blockLoc[i] = -1;
+  numPatches = 0;
+  if (f->isMain) {
+    emitRM(opLDA, fp, 0, sp, "Prologue: FP pointing to current frame function");
+    emitRM(opLDA, sp, initFO - f->frameSize, sp,
+           "Prologue: Allocating memory for local variables");
+  } else
+    emitRM(opLDA, sp, initFO - f->frameSize, fp,
+           "Prologue: Allocating memory for local variables");
+  for (b = f->first; b != NULL; b = b->next) {
+    blockLoc[b->id] = emitSkip(0);
+    if (b->comment != NULL)
+      emitComment((char *)b->comment);
+    for (in = b->first; in != NULL; in = in->next)
+      genInstr(in, in->next == NULL ? b->next : NULL);
+  }
+  endLoc = emitSkip(0);
+  for (i = 0; i < numPatches; i++) {
+    Patch *p = &patches[i];
+    emitBackup(p->loc);
+    emitRM_Abs(p->op, p->r, p->block != NULL ? blockLoc[p->block->id] : endLoc,
+               p->comment);
+  }
+  emitRestore();
+  free(blockLoc);
+}
@@ -0,0 +1,27 @@
+/****************************************************/
+/* File: tmgen.h                                    */
+/* TM code for the intermediate code, once its      */
+/* registers are allocated (regalloc.h)             */
+/****************************************************/
+
+#ifndef _TMGEN_H_
+#define _TMGEN_H_
+
+#include "ir.h"
+
+/* Procedure tmGen emits the TM code of f where the
+ * code goes next, its blocks in layout order, leaving
+ * out a jump to the block that follows. A call finds
+ * its function with findFunction (cgen.h).
+ *
+ * The frame of a call: the caller stores the
+ * arguments below its sp, then the old fp at its sp,
+ * which becomes the new fp, and the return address
+ * right below; the function moves sp past its
+ * variables and spill slots, and returns its value
+ * in ac. main sets its frame up from sp, and falls
+ * through to the code that follows it.
+ */
+void tmGen(IrFunc *f);
+
+#endif
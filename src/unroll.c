@@ -0,0 +1,172 @@
+/****************************************************/
+/* File: unroll.c                                   */
+/* Counted while loops of the C- syntax tree and    */
+/* how far to unroll them                           */
+/****************************************************/
+
+#include "unroll.h"
+#include "../build/parser.h"
+#include <string.h>
+
+/* the growth unrolling may cause, in syntax tree
+ * nodes, for a loop and over the program: about an
+ * instruction a node once optimized, the program
+ * keeps most of the 1024 words of TM instruction
+ * memory (IADDR_SIZE) to itself
+ */
+#define LOOP_GROWTH 100
+#define PROGRAM_GROWTH 400
+
+/* the most iterations counted ahead */
+#define MAX_TRIPS (1 << 20)
+
+/* growth spent so far */
+static int programGrowth = 0;
+
+static int isScalar(TreeNode *t) {
+  return t != NULL && t->nodekind == ExpK && t->kind.exp == VarK &&
+         !t->isArray && t->child[0] == NULL && t->symbol != NULL &&
+         t->symbol->isVar;
+}
+
+static int isConstant(TreeNode *t) {
+  return t != NULL && t->nodekind == ExpK && t->kind.exp == ConstK;
+}
+
+/* isIncrement tells whether t is i = i + 1 */
+static int isIncrement(TreeNode *t, BucketList i) {
+  TreeNode *e, *l, *r;
+  if (t == NULL || t->nodekind != ExpK || t->kind.exp != AssignK ||
+      t->symbol != i || t->child[1] != NULL)
+    return FALSE;
+  e = t->child[0];
+  if (e->nodekind != ExpK || e->kind.exp != OpK || e->attr.op != PLUS)
+    return FALSE;
+  l = e->child[0];
+  r = e->child[1];
+  return (isScalar(l) && l->symbol == i && isConstant(r) && r->attr.val == 1) ||
+         (isScalar(r) && r->symbol == i && isConstant(l) && l->attr.val == 1);
+}
+
+/* the statement a loop body ends with */
+static TreeNode *lastStatement(TreeNode *body) {
+  TreeNode *t = body;
+  if (t->nodekind == StmtK && t->kind.stmt == CompoundK) {
+    t = t->child[1];
+    while (t != NULL && t->sibling != NULL)
+      t = t->sibling;
+  }
+  return t;
+}
+
+/* what the body of a loop does that matters */
+typedef struct {
+  int size;    /* nodes */
+  int sets[2]; /* assignments to each of two scalars */
+  int calls;   /* of functions of the program */
+  int loops;
+  int branches; /* if statements */
+} BodyScan;
+
+static void scan(TreeNode *t, BucketList vars[2], BodyScan *s) {
+  int k;
+  for (; t != NULL; t = t->sibling) {
+    s->size++;
+    if (t->nodekind == StmtK && t->kind.stmt == WhileK)
+      s->loops++;
+    if (t->nodekind == StmtK && t->kind.stmt == IfK)
+      s->branches++;
+    if (t->nodekind == ExpK && t->kind.exp == AssignK && t->child[1] == NULL)
+      for (k = 0; k < 2; k++)
+        if (vars[k] != NULL && t->symbol == vars[k])
+          s->sets[k]++;
+    if (t->nodekind == ExpK && t->kind.exp == CallK &&
+        strcmp(t->attr.name, "input") != 0 &&
+        strcmp(t->attr.name, "output") != 0)
+      s->calls++;
+    for (k = 0; k < MAXCHILDREN; k++)
+      scan(t->child[k], vars, s);
+  }
+}
+
+static int isGlobal(BucketList s) {
+  return s != NULL && s->scopeId == GLOBAL_SCOPE;
+}
+
+void planUnrolling(TreeNode *t, TreeNode *prev, Unrolling *u) {
+  TreeNode *test = t->child[0], *body = t->child[1], *var, *limit;
+  BucketList vars[2];
+  BodyScan s;
+  long long trips = -1;
+  int budget, c;
+  u->full = FALSE;
+  u->copies = 1;
+  u->rest = -1;
+  u->varOnLeft = TRUE;
+  if (UnrollFactor <= 1 || body == NULL || test->nodekind != ExpK ||
+      test->kind.exp != OpK)
+    return;
+  switch (test->attr.op) {
+  case LT:
+  case LTE:
+    var = test->child[0];
+    limit = test->child[1];
+    break;
+  case GT:
+  case GTE:
+    var = test->child[1];
+    limit = test->child[0];
+    u->varOnLeft = FALSE;
+    break;
+  default:
+    return;
+  }
+  if (!isScalar(var) || !(isConstant(limit) || isScalar(limit)) ||
+      (isScalar(limit) && limit->symbol == var->symbol) ||
+      !isIncrement(lastStatement(body), var->symbol))
+    return;
+  vars[0] = var->symbol;
+  vars[1] = isScalar(limit) ? limit->symbol : NULL;
+  memset(&s, 0, sizeof(s));
+  scan(body, vars, &s);
+  if (s.sets[0] != 1 || s.sets[1] != 0 || s.loops != 0 ||
+      (s.calls > 0 && (isGlobal(vars[0]) || isGlobal(vars[1]))))
+    return;
+  /* the trip count, from i = c0 just before */
+  if (isConstant(limit) && prev != NULL && prev->nodekind == ExpK &&
+      prev->kind.exp == AssignK && prev->symbol == var->symbol &&
+      prev->child[1] == NULL && isConstant(prev->child[0])) {
+    trips = (long long)limit->attr.val - prev->child[0]->attr.val +
+            (test->attr.op == LTE || test->attr.op == GTE);
+    if (trips < 0)
+      trips = 0;
+    if (trips > MAX_TRIPS) /* near overflow, the TM compares otherwise */
+      trips = -1;
+  }
+  budget = PROGRAM_GROWTH - programGrowth;
+  if (budget > LOOP_GROWTH)
+    budget = LOOP_GROWTH;
+  if (trips >= 0 && (trips - 1) * s.size <= budget) {
+    u->full = TRUE;
+    u->copies = (int)trips;
+    if (trips > 0)
+      programGrowth += (int)(trips - 1) * s.size;
+    return;
+  }
+  /* with the trip count unknown the loop may run short,
+   * the copies only paying off for a body that does not
+   * branch anyway */
+  if (trips < 0 && s.branches > 0)
+    return;
+  for (c = UnrollFactor; c > 1; c--)
+    if (trips >= 0 && c <= trips &&
+        (c + trips % c - 1) * s.size <= budget) {
+      u->rest = (int)(trips % c);
+      break;
+    } else if (trips < 0 && c * s.size <= budget)
+      break;
+  if (c > 1) {
+    u->copies = c;
+    programGrowth += (c + (u->rest >= 0 ? u->rest : 1) - 1) * s.size;
+  }
+}
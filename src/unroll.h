@@ -0,0 +1,42 @@
+/****************************************************/
+/* File: unroll.h                                   */
+/* Counted while loops of the C- syntax tree and    */
+/* how far to unroll them                           */
+/****************************************************/
+
+#ifndef _UNROLL_H_
+#define _UNROLL_H_
+
+#include "globals.h"
+
+/* how to lower a while loop: copies of the body per
+ * test, the test asking room for all of them. A
+ * full unrolling runs copies bodies with no test at
+ * all. Otherwise, with copies above 1, rest copies
+ * finish the iterations left, or a loop of one copy
+ * when rest is -1.
+ */
+typedef struct {
+  int full;
+  int copies;
+  int rest;
+  int varOnLeft; /* the counter is the left operand */
+} Unrolling;
+
+/* Procedure planUnrolling plans the while loop t, prev
+ * being the statement before it (NULL if none). The
+ * loop is unrolled when it counts, as in
+ *   i = c0; while (i < n) { ...; i = i + 1; }
+ * with <=, or n > i, n >= i, for a test: the last
+ * statement adds 1 to the scalar i, nothing else in
+ * the body sets i, nor n (a constant or a scalar),
+ * nor may a call when they are global, and no loop is
+ * nested in it. With c0 and n constant the trip count
+ * is known, and a small loop goes fully unrolled;
+ * with it unknown, a body with an if stays as is.
+ * UnrollFactor bounds the copies; the growth stays
+ * within a budget for each loop and for the program.
+ */
+void planUnrolling(TreeNode *t, TreeNode *prev, Unrolling *u);
+
+#endif
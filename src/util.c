@@ -110,7 +110,7 @@ void printToken(TokenType token, const char *tokenString) {
  * node for syntax tree construction
  */
 TreeNode *newStmtNode(StmtKind kind) {
-  TreeNode *t = (TreeNode *)malloc(sizeof(TreeNode));
+  TreeNode *t = (TreeNode *)arenaCalloc(syntaxArena, sizeof(TreeNode));
   int i;
   if (t == NULL)
     pce("Out of memory error at line %d\n", lineno);
@@ -121,7 +121,7 @@ TreeNode *newStmtNode(StmtKind kind) {
     t->nodekind = StmtK;
     t->kind.stmt = kind;
     t->lineno = lineno;
-    t->type = NULL;
+    t->type = Void;
   }
   return t;
 }
@@ -130,7 +130,7 @@ TreeNode *newStmtNode(StmtKind kind) {
  * node for syntax tree construction
  */
 TreeNode *newExpNode(ExpKind kind) {
-  TreeNode *t = (TreeNode *)malloc(sizeof(TreeNode));
+  TreeNode *t = (TreeNode *)arenaCalloc(syntaxArena, sizeof(TreeNode));
   int i;
   if (t == NULL)
     pce("Out of memory error at line %d\n", lineno);
@@ -141,14 +141,14 @@ TreeNode *newExpNode(ExpKind kind) {
     t->nodekind = ExpK;
     t->kind.exp = kind;
     t->lineno = lineno;
-    t->type = "void";
+    t->type = Void;
   }
   return t;
 }
 
 /*Function newDeclNode*/
 TreeNode *newDeclNode(DeclKind kind) {
-  TreeNode *t = (TreeNode *)malloc(sizeof(TreeNode));
+  TreeNode *t = (TreeNode *)arenaCalloc(syntaxArena, sizeof(TreeNode));
   int i;
   if (t == NULL)
     pce("Out of memory error at line %d\n", lineno);
@@ -166,18 +166,20 @@ TreeNode *newDeclNode(DeclKind kind) {
 /* Function copyString allocates and makes a new
  * copy of an existing string
  */
-char *copyString(char *s) {
-  int n;
-  char *t;
-  if (s == NULL)
-    return NULL;
-  n = strlen(s) + 1;
-  t = malloc(n);
-  if (t == NULL)
-    pce("Out of memory error at line %d\n", lineno);
-  else
-    strcpy(t, s);
-  return t;
+char *copyString(char *s) { return arenaStrdup(syntaxArena, s); }
+
+/* Function typeName returns the source spelling
+ * of a type, as kept in the symbol table
+ */
+char *typeName(ExpType type) {
+  switch (type) {
+  case Integer:
+    return "int";
+  case Boolean:
+    return "bool";
+  default:
+    return "void";
+  }
 }
 
 /* Variable indentno is used by printTree to
@@ -225,7 +227,7 @@ void printTree(TreeNode *tree) {
     } else if (tree->nodekind == ExpK) {
       switch (tree->kind.exp) {
       case OpK:
-        pc("Op%s: ", strcmp(tree->type, "unary") == 0 ? "(unary)" : "");
+        pc("Op%s: ", tree->child[1] == NULL ? "(unary)" : "");
         printToken(tree->attr.op, "\0");
         break;
       case ConstK:
@@ -254,15 +256,16 @@ void printTree(TreeNode *tree) {
     } else if (tree->nodekind == DeclK) {
       switch (tree->kind.decl) {
       case VarDeclK:
-        pc("Declare %s %s: %s\n", tree->type, tree->isArray ? "array" : "var",
+        pc("Declare %s %s: %s\n", typeName(tree->type), tree->isArray ? "array" : "var",
            tree->attr.name);
         break;
       case FunDeclK:
-        pc("Declare function (return type \"%s\"): %s\n", tree->typeReturn,
+        pc("Declare function (return type \"%s\"): %s\n",
+           typeName(tree->typeReturn),
            tree->attr.name);
         break;
       case ParamK:
-        pc("Function param (%s %s): %s\n", tree->type,
+        pc("Function param (%s %s): %s\n", typeName(tree->type),
            tree->isArray ? "array" : "var", tree->attr.name);
         break;
       case TypeK:
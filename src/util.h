@@ -31,6 +31,9 @@ TreeNode *newDeclNode(DeclKind);
 
 char *copyString(char *);
 
+/* Function typeName returns "int", "void"... for a type */
+char *typeName(ExpType);
+
 /* procedure printTree prints a syntax tree to the
  * listing file using indentation to indicate subtrees
  */